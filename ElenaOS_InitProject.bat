@@ -9,6 +9,9 @@ set CWD=%cd%
 set JerryScriptPath=%CWD%\external\jerryscript
 set LVGLPath=%CWD%\LvglPlatform\lvgl
 set GenJSONPath=%LVGLPath%\scripts\gen_json
+set JerrySnapshotExe=%JerryScriptPath%\build\bin\Debug\jerry-snapshot.exe
+:: 内置应用与系统 JS 库共用的 magic string 表，由 gen_builtin.py 生成后供 gen_stdlib.py 使用
+set BuiltinLiteralsList=%CWD%\output\builtin_literals.list
 
 cls
 :: ===================================================================
@@ -56,6 +59,9 @@ echo ==============================
  --cmake-param="-DCMAKE_CXX_FLAGS_DEBUG=/MTd" ^
  --cmake-param="-DCMAKE_MSVC_RUNTIME_LIBRARY=MultiThreadedDebug" ^
  --clean --debug ^
+ --vm-halt=ON --line-info=ON ^
+ --snapshot-save=ON --snapshot-exec=ON ^
+ --jerry-cmdline-snapshot=ON ^
  --cmake-param=-DCMAKE_CXX_FLAGS="/guard:ehcont" ^
  --cmake-param=-DCMAKE_C_FLAGS="/guard:ehcont"
 
@@ -95,6 +101,37 @@ if exist "%GenJSONPath%\output\lvgl.json" (
     goto :END
 )
 
+:GEN_BUILTIN
+echo.
+echo ==============================
+echo Generating appsys_builtin_data.c...
+echo ==============================
+
+:: 用上一步生成的 lvgl.json 对内置应用做 LVGL 常量内联并编译界面描述
+set InlineConstsParameter=
+if exist "%GenJSONPath%\output\lvgl.json" set InlineConstsParameter=--lvgl-json="%GenJSONPath%\output\lvgl.json"
+
+if exist "%JerrySnapshotExe%" (
+    if not exist output md output
+    "!PYTHON_EXE!" "%CWD%\appsys\tools\gen_builtin.py" --jerry-snapshot="%JerrySnapshotExe%" %InlineConstsParameter% --literals-out="%BuiltinLiteralsList%"
+) else (
+    echo 未找到 jerry-snapshot，不生成内置应用
+    "!PYTHON_EXE!" "%CWD%\appsys\tools\gen_builtin.py"
+)
+
+:GEN_STDLIB
+echo.
+echo ==============================
+echo Generating appsys_stdlib_data.c...
+echo ==============================
+
+if exist "%JerrySnapshotExe%" (
+    "!PYTHON_EXE!" "%CWD%\appsys\tools\gen_stdlib.py" --jerry-snapshot="%JerrySnapshotExe%" --literals="%BuiltinLiteralsList%"
+) else (
+    echo 未找到 jerry-snapshot，仅嵌入 stdlib.js 源码
+    "!PYTHON_EXE!" "%CWD%\appsys\tools\gen_stdlib.py"
+)
+
 :GEN_LV_BINDING_C
 echo.
 echo ==============================
@@ -106,10 +143,15 @@ set LVBindingJerryscriptPath="%CWD%\external\lv_binding_jerryscript"
 
 "!VIRTUAL_PYTHON_EXE!" -m pip install -r "%LVBindingJerryscriptPath%"\requirements.txt
 
+:: 系统 JS 库与内置应用中用到的绑定函数也需要生成
+if not exist output md output
+type "%CWD%\LvglWindowsSimulator\main.js" "%CWD%\appsys\js\stdlib.js" > "%CWD%\output\binding_scan.js" 2>nul
+for /r "%CWD%\appsys\builtin" %%F in (*.js) do type "%%F" >> "%CWD%\output\binding_scan.js"
+
 "!VIRTUAL_PYTHON_EXE!" %LVBindingJerryscriptPath%\gen_lvgl_binding.py ^
  --json-file=%GenJSONPath%\output\lvgl.json ^
  --output-c-path=%LVBindingJerryscriptPath%\src ^
- --extract-funcs-from=%CWD%\LvglWindowsSimulator\main.js ^
+ --extract-funcs-from="%CWD%\output\binding_scan.js" ^
  --cfg-path=%LVBindingJerryscriptPath%\examples\ElenaOS_PC_Simulator
 
 :END
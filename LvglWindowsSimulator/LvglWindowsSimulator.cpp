@@ -8,10 +8,18 @@
 
 #include "jerryscript.h"
 #include "appsys_core.h"
+#include "appsys_input.h"
+#include "appsys_golden.h"
+#include "appsys_bench.h"
+#include "appsys_mem.h"
+#include "appsys_image.h"
+#include "appsys_conf.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <direct.h>
+#include <sys/stat.h>
 
 #define LVGL_WINDOW_WIDTH 800
 #define LVGL_WINDOW_HEIGHT 480
@@ -41,10 +49,200 @@ char* load_js_file(const char* filename) {
     return buffer;
 }
 
-int main()
+/**
+ * @brief 选择要加载的脚本：appsys/tools/bundle.py 生成的 bundle 比源码新时使用 bundle
+ */
+const char* select_js_file(const char* source, const char* bundle) {
+    struct _stat src_st, bundle_st;
+    if (_stat(bundle, &bundle_st) != 0) {
+        return source;
+    }
+    if (_stat(source, &src_st) == 0 && src_st.st_mtime > bundle_st.st_mtime) {
+        printf("%s is older than %s, ignoring it\n", bundle, source);
+        return source;
+    }
+    return bundle;
+}
+
+/**
+ * @brief 渲染回归测试模式（不创建窗口）：
+ *        LvglWindowsSimulator.exe --golden [dir] [--update] [--golden-ms N] [--tolerance N] [script.js ...]
+ *        未指定脚本时运行 main.js 与 test_lv.js，返回失败的检查点数量（缺少基准图也计为失败，首次需加 --update 生成）
+ */
+static int run_golden(int argc, char** argv)
+{
+    AppSysGoldenConfig_t config = {
+        .golden_dir = APPSYS_GOLDEN_DIR,
+        .width = LVGL_WINDOW_WIDTH,
+        .height = LVGL_WINDOW_HEIGHT,
+        .run_ms = APPSYS_GOLDEN_RUN_MS,
+        .tolerance = 0,
+        .update = false,
+    };
+    const char* scripts[32];
+    uint32_t script_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--golden") == 0) {
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0 && strstr(argv[i + 1], ".js") == NULL) {
+                config.golden_dir = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--update") == 0) {
+            config.update = true;
+        }
+        else if (strcmp(argv[i], "--golden-ms") == 0 && i + 1 < argc) {
+            config.run_ms = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            config.tolerance = (uint32_t)atoi(argv[++i]);
+        }
+        else if (script_count < sizeof(scripts) / sizeof(scripts[0])) {
+            scripts[script_count++] = argv[i];
+        }
+    }
+    if (script_count == 0) {
+        scripts[script_count++] = "main.js";
+        scripts[script_count++] = "test_lv.js";
+    }
+    return (int)appsys_golden_run(scripts, script_count, &config);
+}
+
+/**
+ * @brief 基准测试模式（不创建窗口）：
+ *        LvglWindowsSimulator.exe --bench [--iterations N] [--rounds N] [--csv file] [--json file]
+ *        LvglWindowsSimulator.exe --bench widgets [--widgets N] [--csv file] [--json file]
+ *        LvglWindowsSimulator.exe --bench blend [--rounds N] [--csv file] [--json file]
+ *        LvglWindowsSimulator.exe --bench ui [--widgets N] [--rounds N] [--csv file] [--json file]
+ *        分别测量绑定调用开销、各类控件的创建 / 删除吞吐量与内存、混合渲染速度（比较 LV_DRAW_BUF_VECTOR_ALIGN），
+ *        返回失败的用例数量
+ */
+static int run_bench(int argc, char** argv)
+{
+    AppSysBenchConfig_t config = {
+        .iterations = APPSYS_BENCH_ITERATIONS,
+        .rounds = APPSYS_BENCH_ROUNDS,
+        .widgets = APPSYS_BENCH_WIDGETS,
+        .csv_path = NULL,
+        .json_path = NULL,
+    };
+    const char* mode = "calls";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            if (i + 1 < argc && (strcmp(argv[i + 1], "widgets") == 0 || strcmp(argv[i + 1], "blend") == 0
+                || strcmp(argv[i + 1], "ui") == 0)) {
+                mode = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            config.iterations = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            config.rounds = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--widgets") == 0 && i + 1 < argc) {
+            config.widgets = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            config.csv_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            config.json_path = argv[++i];
+        }
+    }
+    if (appsys_golden_create_display(LVGL_WINDOW_WIDTH, LVGL_WINDOW_HEIGHT) == NULL) {
+        printf("Failed to create virtual display\n");
+        return -1;
+    }
+    if (strcmp(mode, "widgets") == 0) {
+        return (int)appsys_bench_run_widgets(&config);
+    }
+    if (strcmp(mode, "blend") == 0) {
+        return (int)appsys_bench_run_blend(&config);
+    }
+    if (strcmp(mode, "ui") == 0) {
+        return (int)appsys_bench_run_ui(&config);
+    }
+    return (int)appsys_bench_run(&config);
+}
+
+/**
+ * @brief 内存报告模式（不创建窗口）：
+ *        LvglWindowsSimulator.exe --mem-report [script.js ...]
+ *        每个脚本作为一个驻留应用启动（最多 APPSYS_MAX_RESIDENT_APPS 个），运行若干帧后打印各应用的内存占用，
+ *        返回超出 APPSYS_MEM_APP_BUDGET 的应用数量
+ */
+static int run_mem_report(int argc, char** argv)
+{
+    const char* scripts[APPSYS_MAX_RESIDENT_APPS];
+    uint32_t script_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mem-report") != 0 && script_count < APPSYS_MAX_RESIDENT_APPS) {
+            scripts[script_count++] = argv[i];
+        }
+    }
+    if (script_count == 0) {
+        scripts[script_count++] = "main.js";
+    }
+    if (appsys_golden_create_display(LVGL_WINDOW_WIDTH, LVGL_WINDOW_HEIGHT) == NULL) {
+        printf("Failed to create virtual display\n");
+        return -1;
+    }
+
+    // 应用驻留期间应用包必须保持有效，进程退出前不释放
+    static ApplicationPackage_t apps[APPSYS_MAX_RESIDENT_APPS];
+    static char app_ids[APPSYS_MAX_RESIDENT_APPS][64];
+    for (uint32_t i = 0; i < script_count; i++) {
+        char* source = load_js_file(scripts[i]);
+        if (source == NULL) {
+            continue;
+        }
+        const char* base = scripts[i];
+        for (const char* p = scripts[i]; *p != '\0'; p++) {
+            if (*p == '/' || *p == '\\') {
+                base = p + 1;
+            }
+        }
+        snprintf(app_ids[i], sizeof(app_ids[i]), "%s", base);
+        apps[i].app_id = app_ids[i];
+        apps[i].name = app_ids[i];
+        apps[i].version = "0";
+        apps[i].author = "mem-report";
+        apps[i].description = "memory footprint report";
+        apps[i].mainjs_str = source;
+        AppRunResult_t result = appsys_run_app(&apps[i]);
+        if (result != APP_SUCCESS) {
+            printf("%s: app failed to start (%d)\n", scripts[i], (int)result);
+            continue;
+        }
+        for (int frame = 0; frame < 10; frame++) {
+            lv_timer_handler();
+        }
+    }
+
+    appsys_mem_print_report();
+    int over_budget = 0;
+    for (uint32_t i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        lv_obj_t* screen = NULL;
+        if (appsys_get_resident_app(i, &screen) == NULL) {
+            continue;
+        }
+        AppSysMemFootprint_t fp;
+        memset(&fp, 0, sizeof(fp));
+        appsys_mem_measure_tree(screen, &fp);
+        if (appsys_mem_get_total(&fp) > APPSYS_MEM_APP_BUDGET) {
+            over_budget++;
+        }
+    }
+    return over_budget;
+}
+
+int main(int argc, char** argv)
 {
     lv_init();
 
+    // 启用 LV_DRAW_BUF_VECTOR_ALIGN 时让渲染中按需解码的图片也使用对齐的行宽（回归测试与基准测试同样生效）
+    appsys_image_align_decoders();
+
     /*
         * Optional workaround for users who wants UTF-8 console output.
         * If you don't want that behavior can comment them out.
@@ -56,6 +254,18 @@ int main()
     SetConsoleOutputCP(CP_UTF8);
 #endif
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--golden") == 0) {
+            return run_golden(argc, argv);
+        }
+        if (strcmp(argv[i], "--bench") == 0) {
+            return run_bench(argc, argv);
+        }
+        if (strcmp(argv[i], "--mem-report") == 0) {
+            return run_mem_report(argc, argv);
+        }
+    }
+
     int32_t zoom_level = 100;
     bool allow_dpi_override = false;
     bool simulator_mode = true;
@@ -112,6 +322,12 @@ int main()
         return -1;
     }
 
+    // 输入管线：按帧合并指针移动、批量下发编码器刻度并统计输入到显示的延迟
+    appsys_input_init(display);
+    appsys_input_attach(pointer_indev);
+    appsys_input_attach(keypad_indev);
+    appsys_input_attach(encoder_indev);
+
     //lv_demo_widgets();
     //lv_demo_benchmark();
 
@@ -127,7 +343,9 @@ int main()
     _getcwd(cwd, sizeof(cwd));
     printf("Current working directory: %s\n", cwd);
 
-    char* script = load_js_file("main.js");
+    const char* script_path = select_js_file("main.js", "main.bundle.js");
+    printf("Loading %s\n", script_path);
+    char* script = load_js_file(script_path);
     if (!script) return 0;
 
     ApplicationPackage_t app = {
@@ -6,23 +6,6 @@
  */
 
 let btn_click_count = 0;
-function run_lvgl(loop) {
-  let startTime = new Date().getTime(); // 获取开始时间戳
-  let duration = 3000; // 3秒 = 3000毫秒
-
-  while (true) {
-    let delay = lv_timer_handler();
-    lv_delay_ms(delay);
-
-    // 检查是否已经超过3秒
-    if (!loop) {
-      let currentTime = new Date().getTime();
-      if (currentTime - startTime >= duration) {
-        break; // 退出循环
-      }
-    }
-  }
-}
 // 主测试函数
 function test_lvgl_functions() {
   try {
@@ -38,7 +21,7 @@ function test_lvgl_functions() {
     print(color.hex);
     lv_style_set_text_color(st, color);
     lv_obj_add_style(label, st, LV_PART_MAIN);
-    run_lvgl(true);
+    // 脚本执行完毕后应用继续驻留，由系统主循环驱动 LVGL
   } catch (e) {
     print("Test failed:", e.message);
   }
@@ -6,23 +6,6 @@
  */
 
 let btn_click_count = 0;
-function run_lvgl(loop) {
-  let startTime = new Date().getTime(); // 获取开始时间戳
-  let duration = 3000; // 3秒 = 3000毫秒
-
-  while (true) {
-    let delay = lv_timer_handler();
-    lv_delay_ms(delay);
-
-    // 检查是否已经超过3秒
-    if (!loop) {
-      let currentTime = new Date().getTime();
-      if (currentTime - startTime >= duration) {
-        break; // 退出循环
-      }
-    }
-  }
-}
 // 主测试函数
 function test_lvgl_functions() {
   try {
@@ -91,6 +74,9 @@ function test_lvgl_functions() {
     // 测试对象管理功能
     test_object_management(scr);
 
+    // 渲染回归测试的检查点（普通运行时不做任何事）
+    golden_checkpoint("widgets");
+
     print("All LVGL function tests completed successfully!");
   } catch (e) {
     print("Test failed:", e.message);
@@ -358,6 +344,13 @@ function test_chart_functions(scr) {
 
   // 设置范围
   lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+
+  // 环形缓冲：批量追加数据点
+  chart_ring(chart, 10, true);
+  let ser = lv_chart_add_series(chart, { red: 255, green: 0, blue: 0 }, LV_CHART_AXIS_PRIMARY_Y);
+  let samples = new Int32Array([10, 40, 25, 80, 60, 90]);
+  print("chart_append wrote " + chart_append(chart, ser, samples) + " points");
+  chart_append(chart, ser, [30, 20, 50, 70, 15]);
   
   print("Chart functions tested successfully");
 }
@@ -537,9 +530,13 @@ function test_object_management(scr) {
 
   // 删除对象
   lv_obj_del(obj);
-  run_lvgl(true);
-  // 清理对象
-  lv_obj_clean(scr);
+
+  // 清理对象：在临时容器上测试，保留屏幕上其他测试创建的控件
+  // （界面由系统主循环驱动，这里不再调用 run_lvgl，否则脚本不会返回，回归测试也无法到达检查点）
+  let box = lv_obj_create(scr);
+  lv_obj_create(box);
+  lv_obj_clean(box);
+  lv_obj_del(box);
   print("Object management functions tested successfully");
 }
 
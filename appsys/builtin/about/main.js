@@ -0,0 +1,11 @@
+﻿/**
+ * @file main.js
+ * @brief 内置应用：关于
+ * @author Sab1e
+ * @date 2025-08-14
+ */
+
+// 界面由 about.ui.json 在打包时编译（gen_builtin.py），一次 ui_load 创建，脚本只填入文本
+let ui = ui_load("about", lv_scr_act());
+lv_label_set_text(ui.title, app_info.name);
+lv_label_set_text(ui.info, "ElenaOS\n" + app_info.version);
@@ -0,0 +1,64 @@
+﻿/**
+ * @file appsys_anim.h
+ * @brief 定点动画辅助：缓动、插值、路径生成与批量属性设置（无浮点运算）
+ * @author Sab1e
+ * @date 2025-08-18
+ */
+#ifndef APPSYS_ANIM_H
+#define APPSYS_ANIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+// 类型声明
+/** 动画进度的满量程（Q10 定点，与 LV_BEZIER_VAL_MAX 相同） */
+#define APPSYS_ANIM_T_MAX       LV_BEZIER_VAL_MAX
+#define APPSYS_ANIM_T_SHIFT     LV_BEZIER_VAL_SHIFT
+
+/**
+ * @brief 缓动曲线，与 lv_anim_path_* 一一对应
+ */
+typedef enum {
+    APPSYS_ANIM_EASE_LINEAR = 0,
+    APPSYS_ANIM_EASE_IN,
+    APPSYS_ANIM_EASE_OUT,
+    APPSYS_ANIM_EASE_IN_OUT,
+    APPSYS_ANIM_EASE_OVERSHOOT,
+    APPSYS_ANIM_EASE_BOUNCE,
+    APPSYS_ANIM_EASE_STEP,
+    APPSYS_ANIM_EASE_COUNT,
+} AppSysAnimEase_t;
+
+/**
+ * @brief 可批量设置的控件属性
+ */
+typedef enum {
+    APPSYS_ANIM_PROP_X = 0,
+    APPSYS_ANIM_PROP_Y,
+    APPSYS_ANIM_PROP_POS,               // 每个控件占两个值 (x, y)
+    APPSYS_ANIM_PROP_WIDTH,
+    APPSYS_ANIM_PROP_HEIGHT,
+    APPSYS_ANIM_PROP_OPA,
+    APPSYS_ANIM_PROP_TRANSLATE_X,
+    APPSYS_ANIM_PROP_TRANSLATE_Y,
+    APPSYS_ANIM_PROP_ROTATION,          // 0.1 度
+    APPSYS_ANIM_PROP_SCALE,             // 256 = 100%
+    APPSYS_ANIM_PROP_COUNT,
+} AppSysAnimProp_t;
+
+// 函数声明
+int32_t appsys_anim_ease(AppSysAnimEase_t ease, int32_t t);
+int32_t appsys_anim_interp(int32_t from, int32_t to, int32_t progress);
+void appsys_anim_set_prop(lv_obj_t* obj, AppSysAnimProp_t prop, const int32_t* values);
+void appsys_anim_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_ANIM_H
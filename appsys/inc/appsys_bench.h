@@ -0,0 +1,39 @@
+﻿/**
+ * @file appsys_bench.h
+ * @brief 无窗口基准测试：JS 调用原生函数与常用 LVGL 接口的单次耗时、各类控件的创建 / 删除吞吐量与混合渲染速度
+ * @author Sab1e
+ * @date 2025-08-23
+ */
+#ifndef APPSYS_BENCH_H
+#define APPSYS_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 类型声明
+/**
+ * @brief 基准测试配置
+ */
+typedef struct {
+    uint32_t iterations;          // 每轮调用次数，个别开销大的用例按比例减少
+    uint32_t rounds;              // 计时轮数，取最快的一轮
+    uint32_t widgets;             // 控件吞吐基准中每种控件创建的数量，界面构建基准中的卡片数量
+    const char* csv_path;         // 结果写入 CSV，可为 NULL
+    const char* json_path;        // 结果写入 JSON，可为 NULL
+} AppSysBenchConfig_t;
+
+// 函数声明
+uint32_t appsys_bench_run(const AppSysBenchConfig_t* config);
+uint32_t appsys_bench_run_widgets(const AppSysBenchConfig_t* config);
+uint32_t appsys_bench_run_blend(const AppSysBenchConfig_t* config);
+uint32_t appsys_bench_run_ui(const AppSysBenchConfig_t* config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_BENCH_H
@@ -0,0 +1,62 @@
+﻿/**
+ * @file appsys_buf.h
+ * @brief 二进制缓冲区读写（变长整数编码），供休眠数据等紧凑格式使用
+ * @author Sab1e
+ * @date 2025-08-10
+ */
+#ifndef APPSYS_BUF_H
+#define APPSYS_BUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 类型声明
+/**
+ * @brief 可增长的写缓冲区
+ */
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+    bool oom;           // 曾经分配失败，内容不完整
+} AppSysBuf_t;
+
+/**
+ * @brief 只读游标
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t len;
+    size_t pos;
+    bool error;         // 越界读取，后续读取均返回 0
+} AppSysReader_t;
+
+// 函数声明
+void appsys_buf_init(AppSysBuf_t* buf);
+void appsys_buf_free(AppSysBuf_t* buf);
+uint8_t* appsys_buf_reserve(AppSysBuf_t* buf, size_t len);
+void appsys_buf_put(AppSysBuf_t* buf, const void* data, size_t len);
+void appsys_buf_put_u8(AppSysBuf_t* buf, uint8_t v);
+void appsys_buf_put_u32(AppSysBuf_t* buf, uint32_t v);
+void appsys_buf_put_varint(AppSysBuf_t* buf, uint32_t v);
+void appsys_buf_put_svarint(AppSysBuf_t* buf, int32_t v);
+void appsys_buf_put_str(AppSysBuf_t* buf, const char* str);
+
+void appsys_reader_init(AppSysReader_t* rd, const uint8_t* data, size_t len);
+const uint8_t* appsys_reader_get(AppSysReader_t* rd, size_t len);
+uint8_t appsys_reader_u8(AppSysReader_t* rd);
+uint32_t appsys_reader_u32(AppSysReader_t* rd);
+uint32_t appsys_reader_varint(AppSysReader_t* rd);
+int32_t appsys_reader_svarint(AppSysReader_t* rd);
+const char* appsys_reader_str(AppSysReader_t* rd, uint32_t* len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_BUF_H
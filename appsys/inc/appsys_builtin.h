@@ -0,0 +1,38 @@
+﻿/**
+ * @file appsys_builtin.h
+ * @brief 内置应用：以静态快照形式编译进程序只读数据段，按 ID 启动
+ * @author Sab1e
+ * @date 2025-08-14
+ */
+#ifndef APPSYS_BUILTIN_H
+#define APPSYS_BUILTIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "jerryscript.h"
+#include "appsys_core.h"
+
+// 由 appsys/tools/gen_builtin.py 生成（appsys_builtin_data.c）
+extern const jerry_char_t* const appsys_builtin_magic_strings[];
+extern const jerry_length_t appsys_builtin_magic_string_lengths[];
+extern const uint32_t appsys_builtin_magic_string_count;
+extern const ApplicationPackage_t appsys_builtin_apps[];
+extern const uint32_t appsys_builtin_app_count;
+
+// 函数声明
+void appsys_builtin_init(void);
+uint32_t appsys_builtin_get_count(void);
+const ApplicationPackage_t* appsys_builtin_get(uint32_t index);
+const ApplicationPackage_t* appsys_builtin_find(const char* app_id);
+AppRunResult_t appsys_run_builtin(const char* app_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_BUILTIN_H
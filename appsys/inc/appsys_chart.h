@@ -0,0 +1,27 @@
+﻿/**
+ * @file appsys_chart.h
+ * @brief 图表批量追加：JS 一次传入多个数据点，原生侧写入环形缓冲并只刷新变化的区域
+ * @author Sab1e
+ * @date 2025-08-22
+ */
+#ifndef APPSYS_CHART_H
+#define APPSYS_CHART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+#include "jerryscript.h"
+
+// 函数声明
+uint32_t appsys_chart_append(lv_obj_t* chart, lv_chart_series_t* ser, const int32_t* values, uint32_t count);
+void appsys_chart_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_CHART_H
@@ -0,0 +1,259 @@
+﻿/**
+ * @file appsys_conf.h
+ * @brief 应用程序系统配置文件（各模块的编译期开关与默认参数）
+ * @author Sab1e
+ * @date 2025-08-05
+ */
+#ifndef APPSYS_CONF_H
+#define APPSYS_CONF_H
+
+/********************************** 输入管线 **********************************/
+
+/** 是否将输入设备的读取与显示刷新同步（每帧读取一次，帧内的指针移动被合并） */
+#ifndef APPSYS_INPUT_FRAME_SYNC
+#define APPSYS_INPUT_FRAME_SYNC             1
+#endif
+
+/** 是否启用指针位置预测（拖动/滚动时向前预测一帧） */
+#ifndef APPSYS_INPUT_PREDICT
+#define APPSYS_INPUT_PREDICT                0
+#endif
+
+/** 单次预测允许的最大偏移量 [px] */
+#ifndef APPSYS_INPUT_PREDICT_MAX_PX
+#define APPSYS_INPUT_PREDICT_MAX_PX         24
+#endif
+
+/** 输入延迟统计的打印周期 [ms]，为 0 时不打印 */
+#ifndef APPSYS_INPUT_REPORT_PERIOD
+#define APPSYS_INPUT_REPORT_PERIOD          0
+#endif
+
+/** 最多可接入输入管线的输入设备数量 */
+#ifndef APPSYS_INPUT_MAX_INDEV
+#define APPSYS_INPUT_MAX_INDEV              4
+#endif
+
+/********************************** 多应用运行时 **********************************/
+
+/** 同时驻留的最大应用数量（超出时关闭最久未使用的后台应用） */
+#ifndef APPSYS_MAX_RESIDENT_APPS
+#define APPSYS_MAX_RESIDENT_APPS            4
+#endif
+
+/** 应用转入后台时是否立即执行一次完整 GC 以压缩堆 */
+#ifndef APPSYS_SUSPEND_GC
+#define APPSYS_SUSPEND_GC                   1
+#endif
+
+/** 是否打印每次启动、恢复与休眠的耗时（[launch] / [restore] / [hibernate]） */
+#ifndef APPSYS_LAUNCH_TRACE
+#define APPSYS_LAUNCH_TRACE                 0
+#endif
+
+/********************************** 应用休眠 **********************************/
+
+/** 后台应用被淘汰时是否先休眠到磁盘（否则直接关闭并丢失状态） */
+#ifndef APPSYS_HIBERNATE_ON_EVICT
+#define APPSYS_HIBERNATE_ON_EVICT           1
+#endif
+
+/** 休眠数据的存放目录 */
+#ifndef APPSYS_HIBERNATE_DIR
+#define APPSYS_HIBERNATE_DIR                "hibernate"
+#endif
+
+/** 最多记录的休眠应用数量 */
+#ifndef APPSYS_MAX_HIBERNATED_APPS
+#define APPSYS_MAX_HIBERNATED_APPS          8
+#endif
+
+/** 状态对象与控件树序列化的最大嵌套深度 */
+#ifndef APPSYS_HIBERNATE_MAX_DEPTH
+#define APPSYS_HIBERNATE_MAX_DEPTH          16
+#endif
+
+/** 建立 realm 时把绑定导出的 LV_* 数字常量设为只读，保证打包时的常量内联与运行时一致 */
+#ifndef APPSYS_FREEZE_LV_CONSTANTS
+#define APPSYS_FREEZE_LV_CONSTANTS          1
+#endif
+
+/********************************** 脚本看门狗 **********************************/
+
+/** 单次同步执行的默认时间预算 [ms]，应用包中 exec_budget_ms 为 0 时使用 */
+#ifndef APPSYS_WATCHDOG_BUDGET_MS
+#define APPSYS_WATCHDOG_BUDGET_MS           2000
+#endif
+
+/** VM 每执行多少次检查点（跳转 / 调用）回调一次看门狗 */
+#ifndef APPSYS_WATCHDOG_CHECK_INTERVAL
+#define APPSYS_WATCHDOG_CHECK_INTERVAL      16384
+#endif
+
+/** 超时报告中打印的最大调用栈深度 */
+#ifndef APPSYS_WATCHDOG_BACKTRACE_DEPTH
+#define APPSYS_WATCHDOG_BACKTRACE_DEPTH     16
+#endif
+
+/********************************** 启动预热 **********************************/
+
+/** 最多缓存的预热应用数量，超出时丢弃最早预热的应用 */
+#ifndef APPSYS_PREWARM_MAX_APPS
+#define APPSYS_PREWARM_MAX_APPS             4
+#endif
+
+/** 单个应用快照的最大大小 [byte]，超出时该应用回退为启动时解析 */
+#ifndef APPSYS_PREWARM_SNAPSHOT_MAX
+#define APPSYS_PREWARM_SNAPSHOT_MAX         (64 * 1024)
+#endif
+
+/** 空闲调度器的检查周期 [ms] */
+#ifndef APPSYS_PREWARM_PERIOD
+#define APPSYS_PREWARM_PERIOD               20
+#endif
+
+/** 系统空闲率不低于该值 [%] 时才执行预热任务 */
+#ifndef APPSYS_PREWARM_IDLE_MIN
+#define APPSYS_PREWARM_IDLE_MIN             50
+#endif
+
+/** 预热首屏图片使用的图片缓存大小 [byte]，0 表示不预解码图片 */
+#ifndef APPSYS_PREWARM_IMAGE_CACHE_SIZE
+#define APPSYS_PREWARM_IMAGE_CACHE_SIZE     (256 * 1024)
+#endif
+
+/********************************** ES 模块 **********************************/
+
+/** 系统模块目录，import "name" 对应该目录下的 name.js */
+#ifndef APPSYS_MODULE_DIR
+#define APPSYS_MODULE_DIR                   "modules"
+#endif
+
+/** 模块路径（规范化后）的最大长度 [byte]，含结尾的 '\0' */
+#ifndef APPSYS_MODULE_PATH_MAX
+#define APPSYS_MODULE_PATH_MAX              128
+#endif
+
+/********************************** 延迟编译 **********************************/
+
+/** 是否把启动阶段编译的延迟函数写入启动剖析文件（供 bundle.py --profile 使用），打包前采集时临时开启 */
+#ifndef APPSYS_LAZY_PROFILE
+#define APPSYS_LAZY_PROFILE                 0
+#endif
+
+/** 启动剖析文件的存放目录，文件名为 <app_id>.txt */
+#ifndef APPSYS_LAZY_PROFILE_DIR
+#define APPSYS_LAZY_PROFILE_DIR             "profile"
+#endif
+
+/********************************** 界面描述 **********************************/
+
+/** 界面描述文件目录，应用包中没有同名界面时 ui_load("name") 读取该目录下的 name.ui */
+#ifndef APPSYS_UI_DIR
+#define APPSYS_UI_DIR                       "ui"
+#endif
+
+/** 界面描述控件树的最大嵌套深度，超出时视为数据损坏 */
+#ifndef APPSYS_UI_MAX_DEPTH
+#define APPSYS_UI_MAX_DEPTH                 32
+#endif
+
+/** 是否打印每次 ui_load 的控件数量与耗时 */
+#ifndef APPSYS_UI_TRACE
+#define APPSYS_UI_TRACE                     0
+#endif
+
+/********************************** 数据绑定 **********************************/
+
+/** subject_string 未指定大小时的缓冲区大小 [byte]，含结尾的 '\0' */
+#ifndef APPSYS_SUBJECT_STRING_SIZE
+#define APPSYS_SUBJECT_STRING_SIZE          32
+#endif
+
+/********************************** 字符串转换 **********************************/
+
+/** JS 字符串转换暂存缓冲区的初始大小 [byte]，遇到更长的字符串时按倍数扩大 */
+#ifndef APPSYS_STR_SCRATCH_SIZE
+#define APPSYS_STR_SCRATCH_SIZE             256
+#endif
+
+/** *_set_text_static 驻留文本的总大小上限 [byte]，超出后改用复制型接口 */
+#ifndef APPSYS_STR_INTERN_LIMIT
+#define APPSYS_STR_INTERN_LIMIT             (8 * 1024)
+#endif
+
+/** label_set_int / label_set_fixed 格式化结果的最大长度 [byte]，含结尾的 '\0'，超出部分被截断 */
+#ifndef APPSYS_STR_FORMAT_SIZE
+#define APPSYS_STR_FORMAT_SIZE              48
+#endif
+
+/********************************** 渲染回归测试 **********************************/
+
+/** 基准图的默认目录（模拟器 --golden 未指定目录时使用） */
+#ifndef APPSYS_GOLDEN_DIR
+#define APPSYS_GOLDEN_DIR                   "golden"
+#endif
+
+/** 虚拟时钟每次推进的时间 [ms]，即一帧 */
+#ifndef APPSYS_GOLDEN_STEP_MS
+#define APPSYS_GOLDEN_STEP_MS               16
+#endif
+
+/** 每个脚本默认运行的虚拟时间 [ms]，结束时截取 "final" 检查点 */
+#ifndef APPSYS_GOLDEN_RUN_MS
+#define APPSYS_GOLDEN_RUN_MS                2000
+#endif
+
+/********************************** 绑定开销基准 **********************************/
+
+/** 每轮默认调用次数（模拟器 --bench 未指定 --iterations 时使用） */
+#ifndef APPSYS_BENCH_ITERATIONS
+#define APPSYS_BENCH_ITERATIONS             100000
+#endif
+
+/** 计时轮数，取最快的一轮 */
+#ifndef APPSYS_BENCH_ROUNDS
+#define APPSYS_BENCH_ROUNDS                 5
+#endif
+
+/** 预热调用次数 = 每轮调用次数 / 该值 */
+#ifndef APPSYS_BENCH_WARMUP_DIVISOR
+#define APPSYS_BENCH_WARMUP_DIVISOR         10
+#endif
+
+/** 控件吞吐基准中每种控件默认创建的数量（模拟器 --bench widgets 未指定 --widgets 时使用） */
+#ifndef APPSYS_BENCH_WIDGETS
+#define APPSYS_BENCH_WIDGETS                500
+#endif
+
+/** 混合基准中每轮渲染的帧数（模拟器 --bench blend） */
+#ifndef APPSYS_BENCH_BLEND_FRAMES
+#define APPSYS_BENCH_BLEND_FRAMES           50
+#endif
+
+/********************************** 内存报告 **********************************/
+
+/** 单个应用的内存预算 [byte]，报告中超出的应用会被标出 */
+#ifndef APPSYS_MEM_APP_BUDGET
+#define APPSYS_MEM_APP_BUDGET               (256 * 1024)
+#endif
+
+/** 每个报告最多区分的控件类型数量，其余类型合并为 "other" */
+#ifndef APPSYS_MEM_MAX_TYPES
+#define APPSYS_MEM_MAX_TYPES                24
+#endif
+
+/**
+ * 合并 JS 事件描述符：注册了 JS 回调的对象只在 LVGL 中保留一个 LV_EVENT_ALL 事件描述符，
+ * 由原生侧按事件码分发（默认方式为每个回调一个描述符，另加一个删除回调），见 appsys_event.c。
+ * 这是它唯一的作用：lv_obj_t 的布局与大小不变，没有 JS 回调的控件（如大多数标签）不受影响；
+ * 代价是该对象的每个事件（包括绘制事件）都会进入一次分发函数。
+ * lv_obj_t 中不常用的字段（滚动、子对象表、事件表等）LVGL 本身已放在按需分配的 spec_attr 中；
+ * 要减小每个 lv_obj_t，应保持 lv_conf.h 中 LV_OBJ_STYLE_CACHE、LV_USE_OBJ_ID、LV_USE_OBJ_NAME、
+ * LV_USE_OBJ_PROPERTY 为 0。两种方式的差别可用模拟器 --bench widgets 的 js_cb 结果对比。
+ */
+#ifndef APPSYS_COMPACT_OBJ
+#define APPSYS_COMPACT_OBJ                  0
+#endif
+
+#endif // APPSYS_CONF_H
@@ -14,6 +14,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "lvgl/lvgl.h"
 #include "jerryscript.h"
 // 类型声明
@@ -24,6 +25,17 @@ typedef struct {
     const char* name;
     jerry_external_handler_t handler;
 } AppSysFuncEntry;
+// 应用包内的 ES 模块
+typedef struct {
+    const char* path;             // 相对应用包根目录的路径，例如 "lib/util.js"
+    const char* source;           // 模块源码
+} AppSysModuleSource_t;
+// 应用包内的二进制界面描述（由 appsys/tools/ui_compile.py 生成）
+typedef struct {
+    const char* name;             // 界面名称，ui_load(name, parent) 使用
+    const uint8_t* data;          // 二进制界面数据
+    size_t size;                  // 数据大小 [byte]
+} AppSysUiBlob_t;
 // 应用包描述结构体
 typedef struct {
     const char* app_id;           // 应用唯一ID，例如 "com.mydev.clock"
@@ -32,6 +44,15 @@ typedef struct {
     const char* author;           // 开发者名称
     const char* description;      // 简要说明
     const char* mainjs_str;       // 主 JS 脚本字符串
+    const uint32_t* snapshot;     // 静态快照（内置应用），非 NULL 时代替 mainjs_str 就地执行
+    size_t snapshot_size;         // 静态快照大小 [byte]
+    uint32_t exec_budget_ms;      // 单次同步执行的时间预算 [ms]，0 表示使用默认值
+    const char* const* preload_assets; // 首屏图片资源路径，以 NULL 结尾，可为 NULL
+    bool mainjs_is_module;        // mainjs_str 作为 ES 模块执行，可使用 import
+    const AppSysModuleSource_t* modules; // 包内可被 import 的模块，可为 NULL
+    uint32_t module_count;        // modules 数组长度
+    const AppSysUiBlob_t* ui;     // 包内的界面描述，可为 NULL
+    uint32_t ui_count;            // ui 数组长度
 } ApplicationPackage_t;
 
 // 应用运行结果枚举
@@ -42,12 +63,36 @@ typedef enum {
     APP_ERR_JERRY_EXCEPTION = -3,      // 运行期间抛出 JS 异常
     APP_ERR_ALREADY_RUNNING = -4,      // 当前已有 APP 在运行
     APP_ERR_JERRY_INIT_FAIL = -5,      // JerryScript 初始化失败
+    APP_ERR_NOT_FOUND = -6,            // 指定的应用未驻留
+    APP_ERR_HIBERNATE_FAIL = -7,       // 休眠数据写入失败
+    APP_ERR_WATCHDOG_TIMEOUT = -8,     // 脚本同步执行超出时间预算，已被终止
 } AppRunResult_t;
 
+// 应用驻留状态枚举
+typedef enum {
+    APP_STATE_NONE = 0,                 // 未驻留
+    APP_STATE_FOREGROUND,               // 前台运行，占用显示
+    APP_STATE_SUSPENDED,                // 后台挂起，定时器冻结、屏幕脱离显示
+    APP_STATE_HIBERNATED,               // 已休眠到磁盘，不占用 VM 资源
+} AppState_t;
+
 
 // 函数声明
 AppRunResult_t appsys_run_app(const ApplicationPackage_t* app);
+AppRunResult_t appsys_switch_app(const char* app_id);
+AppRunResult_t appsys_suspend_app(void);
+AppRunResult_t appsys_kill_app(const char* app_id);
+AppRunResult_t appsys_hibernate_app(const char* app_id);
+AppState_t appsys_get_app_state(const char* app_id);
+const char* appsys_get_foreground_app(void);
+const ApplicationPackage_t* appsys_get_resident_app(uint32_t index, lv_obj_t** screen);
+void appsys_vm_init(void);
+jerry_value_t appsys_create_system_realm(void);
 void appsys_register_functions(const AppSysFuncEntry* entry, const size_t funcs_count);
+void appsys_report_exception(jerry_value_t result);
+uint32_t appsys_get_exec_budget(jerry_value_t realm);
+const ApplicationPackage_t* appsys_get_package(jerry_value_t realm);
+void appsys_request_terminate(jerry_value_t realm, AppRunResult_t reason);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,35 @@
+﻿/**
+ * @file appsys_event.h
+ * @brief JS 事件回调的快速分发路径
+ * @author Sab1e
+ * @date 2025-08-06
+ */
+#ifndef APPSYS_EVENT_H
+#define APPSYS_EVENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_event_init(void);
+void appsys_event_deinit(void);
+void appsys_event_register_natives(void);
+bool appsys_event_register(lv_obj_t* obj, jerry_value_t js_obj, lv_event_code_t code,
+    jerry_value_t func, jerry_value_t user_data);
+uint32_t appsys_event_unregister(lv_obj_t* obj, lv_event_code_t code, jerry_value_t func);
+size_t appsys_event_get_footprint(lv_obj_t* obj, uint32_t* wrapper_count);
+jerry_value_t appsys_event_call(jerry_value_t func, jerry_value_t this_val,
+    const jerry_value_t* args_p, jerry_length_t args_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_EVENT_H
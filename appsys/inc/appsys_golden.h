@@ -0,0 +1,40 @@
+﻿/**
+ * @file appsys_golden.h
+ * @brief 渲染回归测试：无窗口运行 JS 应用，在检查点截取帧缓冲并与基准 PNG 逐像素比较
+ * @author Sab1e
+ * @date 2025-08-23
+ */
+#ifndef APPSYS_GOLDEN_H
+#define APPSYS_GOLDEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+// 类型声明
+/**
+ * @brief 回归测试配置
+ */
+typedef struct {
+    const char* golden_dir;       // 基准图目录，每个脚本一个子目录
+    uint32_t width;               // 虚拟显示器分辨率 [px]
+    uint32_t height;
+    uint32_t run_ms;              // 每个脚本运行的虚拟时间 [ms]，结束时截取 "final" 检查点
+    uint32_t tolerance;           // 允许的单通道误差，0 表示逐像素完全一致
+    bool update;                  // 用当前输出覆盖基准图；为 false 时缺少基准图计为失败
+} AppSysGoldenConfig_t;
+
+// 函数声明
+lv_display_t* appsys_golden_create_display(uint32_t width, uint32_t height);
+uint32_t appsys_golden_run(const char* const* scripts, uint32_t script_count, const AppSysGoldenConfig_t* config);
+void appsys_golden_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_GOLDEN_H
@@ -0,0 +1,42 @@
+﻿/**
+ * @file appsys_hibernate.h
+ * @brief 应用休眠：把应用声明的状态与屏幕树序列化到磁盘，释放 VM 资源后再恢复
+ * @author Sab1e
+ * @date 2025-08-10
+ */
+#ifndef APPSYS_HIBERNATE_H
+#define APPSYS_HIBERNATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+#include "jerryscript.h"
+
+// 类型声明
+/**
+ * @brief 休眠 / 恢复统计信息
+ */
+typedef struct {
+    uint32_t blob_size;       // 休眠数据总大小 [byte]
+    uint32_t state_size;      // 其中状态对象部分的大小 [byte]
+    uint32_t tree_nodes;      // 屏幕树的控件数量
+    uint32_t adopted_nodes;   // 恢复时被主脚本领取的控件数量
+    uint32_t elapsed_us;      // 序列化并写入 / 读取并重建屏幕的耗时 [us]
+} AppSysHibernateStats_t;
+
+// 函数声明
+bool appsys_hibernate_save(const char* app_id, jerry_value_t realm, lv_obj_t* screen, AppSysHibernateStats_t* stats);
+bool appsys_hibernate_begin_restore(const char* app_id, jerry_value_t realm, lv_obj_t* screen, AppSysHibernateStats_t* stats);
+void appsys_hibernate_end_restore(AppSysHibernateStats_t* stats);
+void appsys_hibernate_discard(const char* app_id);
+void appsys_hibernate_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_HIBERNATE_H
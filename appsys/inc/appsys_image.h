@@ -0,0 +1,25 @@
+﻿/**
+ * @file appsys_image.h
+ * @brief 图片解码辅助：按对齐的行宽解码，供预热与渲染共用
+ * @author Sab1e
+ * @date 2025-08-23
+ */
+#ifndef APPSYS_IMAGE_H
+#define APPSYS_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 函数声明
+uint32_t appsys_image_align_decoders(void);
+bool appsys_image_predecode(const char* src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_IMAGE_H
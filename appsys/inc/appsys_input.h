@@ -0,0 +1,44 @@
+﻿/**
+ * @file appsys_input.h
+ * @brief 输入管线：帧同步读取、指针合并、编码器批处理与触摸预测
+ * @author Sab1e
+ * @date 2025-08-05
+ */
+#ifndef APPSYS_INPUT_H
+#define APPSYS_INPUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+// 类型声明
+/**
+ * @brief 输入管线统计信息
+ */
+typedef struct {
+    uint32_t frames;              // 已同步读取的帧数
+    uint32_t pointer_samples;     // 位置或状态发生变化的指针样本数
+    uint32_t encoder_batches;     // 合并后下发的编码器批次
+    int32_t encoder_ticks;        // 合并的编码器刻度总数（绝对值累加）
+    uint32_t predicted;           // 使用预测位置的样本数
+    uint32_t latency_count;       // 已测量的延迟次数（从读取回调读到样本，到该帧最后一次 flush 完成）
+    uint64_t latency_sum_us;      // 延迟累计 [us]
+    uint32_t latency_max_us;      // 最大延迟 [us]
+} AppSysInputStats_t;
+
+// 函数声明
+void appsys_input_init(lv_display_t* disp);
+bool appsys_input_attach(lv_indev_t* indev);
+void appsys_input_set_predict(bool enable);
+void appsys_input_get_stats(AppSysInputStats_t* stats);
+void appsys_input_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_INPUT_H
@@ -0,0 +1,31 @@
+﻿/**
+ * @file appsys_js_utils.h
+ * @brief JS 与原生对象互转的辅助函数
+ * @author Sab1e
+ * @date 2025-08-06
+ */
+#ifndef APPSYS_JS_UTILS_H
+#define APPSYS_JS_UTILS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_js_utils_init(void);
+void appsys_js_utils_deinit(void);
+void* appsys_js_get_ptr(jerry_value_t value);
+jerry_value_t appsys_js_new_ptr(void* ptr);
+int32_t appsys_js_get_int(const jerry_value_t args_p[], jerry_length_t args_count, jerry_length_t index, int32_t def);
+void appsys_js_define_const(jerry_value_t obj, jerry_value_t key, jerry_value_t value);
+uint32_t appsys_js_freeze_numbers(jerry_value_t obj, const char* prefix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_JS_UTILS_H
@@ -0,0 +1,26 @@
+﻿/**
+ * @file appsys_lazy.h
+ * @brief 延迟编译函数的运行时支持与启动剖析（配合 bundle.py --lazy）
+ * @author Sab1e
+ * @date 2025-08-17
+ */
+#ifndef APPSYS_LAZY_H
+#define APPSYS_LAZY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 函数声明
+void appsys_lazy_register_natives(void);
+void appsys_lazy_begin_startup(const char* app_id);
+uint32_t appsys_lazy_end_startup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_LAZY_H
@@ -0,0 +1,56 @@
+﻿/**
+ * @file appsys_mem.h
+ * @brief 内存占用报告：遍历对象树，按控件类型、样式、用户数据、JS 包装与绘制缓冲统计各应用占用的内存
+ * @author Sab1e
+ * @date 2025-08-23
+ */
+#ifndef APPSYS_MEM_H
+#define APPSYS_MEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+#include "appsys_conf.h"
+
+// 类型声明
+/**
+ * @brief 单个控件类型的统计
+ */
+typedef struct {
+    const lv_obj_class_t* class_p;
+    uint32_t count;
+    size_t bytes;                 // 对象本体、子对象表、事件表与控件自身的数据（文本、数据点等）
+} AppSysMemType_t;
+
+/**
+ * @brief 一棵对象树的内存占用
+ */
+typedef struct {
+    AppSysMemType_t types[APPSYS_MEM_MAX_TYPES];
+    uint32_t type_count;
+    uint32_t objects;
+    size_t widget_bytes;          // 各控件类型 bytes 之和
+    size_t style_bytes;           // 样式表与本地样式（共享样式不计入）
+    uint32_t user_data_count;     // 设置了 user_data 的对象数量（指向的内容大小未知，不计入字节数）
+    size_t js_bytes;              // JS 回调记录与被持有的 JS 包装
+    size_t draw_buf_bytes;        // 对象自带的绘制缓冲（canvas）
+} AppSysMemFootprint_t;
+
+// 函数声明
+void appsys_mem_measure_tree(lv_obj_t* root, AppSysMemFootprint_t* fp);
+size_t appsys_mem_get_total(const AppSysMemFootprint_t* fp);
+const char* appsys_mem_get_type_name(const lv_obj_class_t* class_p);
+size_t appsys_mem_get_display_buffers(void);
+void appsys_mem_print_report(void);
+void appsys_mem_register_natives(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_MEM_H
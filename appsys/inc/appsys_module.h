@@ -0,0 +1,29 @@
+﻿/**
+ * @file appsys_module.h
+ * @brief ES 模块加载：import 按应用包与系统模块目录解析，系统模块在各 realm 间共享
+ * @author Sab1e
+ * @date 2025-08-16
+ */
+#ifndef APPSYS_MODULE_H
+#define APPSYS_MODULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+#include "appsys_core.h"
+
+// 函数声明
+jerry_value_t appsys_module_run_main(const ApplicationPackage_t* app);
+void appsys_module_free_realm(jerry_value_t realm);
+void appsys_module_deinit(void);
+uint32_t appsys_module_get_cached_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_MODULE_H
@@ -0,0 +1,26 @@
+﻿/**
+ * @file appsys_png.h
+ * @brief 最小 PNG 编解码（8 位 RGB / RGBA），供渲染回归测试读写基准图
+ * @author Sab1e
+ * @date 2025-08-23
+ */
+#ifndef APPSYS_PNG_H
+#define APPSYS_PNG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 函数声明
+bool appsys_png_write(const char* path, const uint8_t* rgb, uint32_t width, uint32_t height);
+uint8_t* appsys_png_read(const char* path, uint32_t* width, uint32_t* height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_PNG_H
@@ -14,10 +14,16 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // 类型声明
 
 // 函数声明
+void appsys_port_init(void);
+uint64_t appsys_port_get_time_us(void);
+bool appsys_port_make_dir(const char* path);
+size_t appsys_port_get_heap_used(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,39 @@
+﻿/**
+ * @file appsys_prewarm.h
+ * @brief 应用启动预热：空闲时提前编译快照并预解码首屏资源
+ * @author Sab1e
+ * @date 2025-08-12
+ */
+#ifndef APPSYS_PREWARM_H
+#define APPSYS_PREWARM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+#include "appsys_core.h"
+
+// 类型声明
+/**
+ * @brief 预热状态
+ */
+typedef enum {
+    APPSYS_PREWARM_NONE = 0,           // 未预热
+    APPSYS_PREWARM_QUEUED,             // 已排队，等待系统空闲
+    APPSYS_PREWARM_READY,              // 快照与首屏资源均已就绪
+} AppSysPrewarmState_t;
+
+// 函数声明
+bool appsys_prewarm_app(const ApplicationPackage_t* app);
+void appsys_prewarm_cancel(const char* app_id);
+AppSysPrewarmState_t appsys_prewarm_get_state(const char* app_id);
+bool appsys_prewarm_exec(const ApplicationPackage_t* app, jerry_value_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_PREWARM_H
@@ -0,0 +1,30 @@
+﻿/**
+ * @file appsys_stdlib.h
+ * @brief 系统 JS 库：以快照形式在所有应用的 realm 中共享
+ * @author Sab1e
+ * @date 2025-08-13
+ */
+#ifndef APPSYS_STDLIB_H
+#define APPSYS_STDLIB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 由 appsys/tools/gen_stdlib.py 生成（appsys_stdlib_data.c）
+extern const char appsys_stdlib_source[];
+extern const uint32_t appsys_stdlib_snapshot[];
+extern const size_t appsys_stdlib_snapshot_size;
+
+// 函数声明
+bool appsys_stdlib_load(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_STDLIB_H
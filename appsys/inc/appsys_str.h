@@ -0,0 +1,29 @@
+﻿/**
+ * @file appsys_str.h
+ * @brief JS 字符串到 LVGL 文本的转换快速路径：复用暂存缓冲区、ASCII/BMP 直接拷贝、静态文本驻留
+ * @author Sab1e
+ * @date 2025-08-21
+ */
+#ifndef APPSYS_STR_H
+#define APPSYS_STR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+const char* appsys_str_get(jerry_value_t value, jerry_size_t* len);
+const char* appsys_str_intern(jerry_value_t value);
+bool appsys_str_check_fmt(const char* fmt, const char* conversions);
+void appsys_str_register_natives(void);
+void appsys_str_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_STR_H
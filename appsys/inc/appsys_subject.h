@@ -0,0 +1,27 @@
+﻿/**
+ * @file appsys_subject.h
+ * @brief 响应式数据绑定：基于 LVGL observer 的 subject，值变化时才更新绑定的控件
+ * @author Sab1e
+ * @date 2025-08-20
+ */
+#ifndef APPSYS_SUBJECT_H
+#define APPSYS_SUBJECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_subject_register_natives(void);
+void appsys_subject_free_realm(jerry_value_t realm);
+void appsys_subject_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_SUBJECT_H
@@ -0,0 +1,29 @@
+﻿/**
+ * @file appsys_timeline.h
+ * @brief 声明式动画时间线：JS 一次调用描述动画，由 lv_anim 在原生侧驱动
+ * @author Sab1e
+ * @date 2025-08-18
+ */
+#ifndef APPSYS_TIMELINE_H
+#define APPSYS_TIMELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_timeline_register_natives(void);
+void appsys_timeline_pause_realm(jerry_value_t realm);
+void appsys_timeline_resume_realm(jerry_value_t realm);
+void appsys_timeline_free_realm(jerry_value_t realm);
+void appsys_timeline_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_TIMELINE_H
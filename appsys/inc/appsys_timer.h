@@ -0,0 +1,29 @@
+﻿/**
+ * @file appsys_timer.h
+ * @brief 应用定时器（setTimeout / setInterval），按应用归属管理
+ * @author Sab1e
+ * @date 2025-08-08
+ */
+#ifndef APPSYS_TIMER_H
+#define APPSYS_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_timer_register_natives(void);
+void appsys_timer_pause_realm(jerry_value_t realm);
+void appsys_timer_resume_realm(jerry_value_t realm);
+void appsys_timer_free_realm(jerry_value_t realm);
+void appsys_timer_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_TIMER_H
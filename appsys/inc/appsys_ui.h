@@ -0,0 +1,88 @@
+﻿/**
+ * @file appsys_ui.h
+ * @brief 二进制界面描述（ui_compile.py 生成）的原生加载器，一次遍历创建整棵控件树
+ * @author Sab1e
+ * @date 2025-08-19
+ */
+#ifndef APPSYS_UI_H
+#define APPSYS_UI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+#include "jerryscript.h"
+
+#define UI_MAGIC    "EUIB"
+#define UI_VERSION  1
+
+// 类型声明
+/**
+ * @brief 控件类型号，即 appsys_ui.c 中 ui_classes 的下标，与 ui_compile.py 中的 CLASSES 一致
+ */
+typedef enum {
+    UI_CLASS_OBJ = 0,
+    UI_CLASS_LABEL,
+    UI_CLASS_BUTTON,
+    UI_CLASS_CHECKBOX,
+    UI_CLASS_TEXTAREA,
+    UI_CLASS_SLIDER,
+    UI_CLASS_BAR,
+    UI_CLASS_ARC,
+    UI_CLASS_SWITCH,
+    UI_CLASS_DROPDOWN,
+    UI_CLASS_ROLLER,
+    UI_CLASS_IMAGE,
+} AppSysUiClassId_t;
+
+/**
+ * @brief 属性号，与 ui_compile.py 中的 PROP 一致
+ */
+typedef enum {
+    UI_PROP_ID = 0,              // str：控件名
+    UI_PROP_X,                   // 坐标：类型 u8 + svarint
+    UI_PROP_Y,
+    UI_PROP_WIDTH,
+    UI_PROP_HEIGHT,
+    UI_PROP_ALIGN,               // varint：lv_align_t
+    UI_PROP_TEXT,                // str
+    UI_PROP_OPTIONS,             // str：以 '\n' 分隔
+    UI_PROP_SELECTED,            // varint
+    UI_PROP_RANGE,               // svarint min, svarint max
+    UI_PROP_VALUE,               // svarint
+    UI_PROP_FLAG_ADD,            // varint：lv_obj_flag_t
+    UI_PROP_FLAG_REMOVE,         // varint：lv_obj_flag_t
+    UI_PROP_STATE,               // varint：lv_state_t
+    UI_PROP_FLEX_FLOW,           // varint：lv_flex_flow_t
+    UI_PROP_FLEX_ALIGN,          // varint main, cross, track
+    UI_PROP_FLEX_GROW,           // varint
+    UI_PROP_STYLE_NUM,           // varint 样式属性, varint 选择器, svarint 值
+    UI_PROP_STYLE_COLOR,         // varint 样式属性, varint 选择器, varint 0xRRGGBB
+    UI_PROP_EVENT,               // varint 事件码, str 回调名
+    UI_PROP_SRC,                 // str：图片源
+} AppSysUiProp_t;
+
+/**
+ * @brief 坐标类型
+ */
+typedef enum {
+    UI_COORD_PX = 0,
+    UI_COORD_PCT,
+    UI_COORD_CONTENT,
+} AppSysUiCoord_t;
+
+// 函数声明
+lv_obj_t* appsys_ui_load(const uint8_t* data, size_t size, lv_obj_t* parent,
+    jerry_value_t ids, jerry_value_t handlers, uint32_t* widget_count, const char** error);
+void appsys_ui_register_natives(void);
+void appsys_ui_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_UI_H
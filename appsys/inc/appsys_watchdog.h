@@ -0,0 +1,29 @@
+﻿/**
+ * @file appsys_watchdog.h
+ * @brief 脚本看门狗：限制单次同步执行时间，超时中断并终止应用
+ * @author Sab1e
+ * @date 2025-08-11
+ */
+#ifndef APPSYS_WATCHDOG_H
+#define APPSYS_WATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "jerryscript.h"
+
+// 函数声明
+void appsys_watchdog_init(void);
+void appsys_watchdog_deinit(void);
+bool appsys_watchdog_begin(void);
+bool appsys_watchdog_end(void);
+jerry_value_t appsys_watchdog_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APPSYS_WATCHDOG_H
@@ -0,0 +1,35 @@
+﻿/**
+ * @file stdlib.js
+ * @brief 系统 JS 辅助函数库，编译为快照后在每个应用的 realm 中共享执行
+ * @author Sab1e
+ * @date 2025-08-13
+ *
+ * 修改后需运行 appsys/tools/gen_stdlib.py 重新生成 appsys_stdlib_data.c。
+ * 这里用到的 LVGL 绑定函数必须同时出现在生成绑定时扫描的脚本中。
+ */
+
+/**
+ * 在 JS 中驱动 LVGL 主循环
+ * @param loop 为 true 时一直循环；否则运行 3 秒后返回。
+ *             回归测试中 LVGL 时钟是虚拟的，由测试程序在脚本返回后推进，这里直接返回
+ */
+function run_lvgl(loop) {
+  if (golden_active()) {
+    return;
+  }
+  let startTime = new Date().getTime(); // 获取开始时间戳
+  let duration = 3000; // 3秒 = 3000毫秒
+
+  while (true) {
+    let delay = lv_timer_handler();
+    lv_delay_ms(delay);
+
+    // 检查是否已经超过3秒
+    if (!loop) {
+      let currentTime = new Date().getTime();
+      if (currentTime - startTime >= duration) {
+        break; // 退出循环
+      }
+    }
+  }
+}
@@ -0,0 +1,338 @@
+﻿/**
+ * @file appsys_anim.c
+ * @brief 定点动画辅助实现
+ * @author Sab1e
+ * @date 2025-08-18
+ *
+ * 目标平台没有 FPU（lv_conf.h 中 LV_USE_FLOAT 为 0），脚本里的动画计算却全部是 double。
+ * 这里的原生函数只用整数运算：进度为 Q10 定点（0 ~ ANIM_T_MAX），缓动曲线与 lv_anim_path_*
+ * 使用相同的整数贝塞尔实现，数据通过 Int32Array 批量传入传出。脚本每帧只需调用一次
+ * anim_interp 算出全部属性值，再调用一次 anim_apply 写入所有控件。
+ *
+ * JS 接口：
+ *   anim_ease(ease, t)                              -> 缓动后的进度
+ *   anim_interp(out, from, to, t[, ease])           -> out[i] = from[i] + (to[i] - from[i]) * ease(t)
+ *   anim_path(out, from, to[, ease])                -> 把 from 到 to 的缓动曲线采样到 out（关键帧表）
+ *   anim_arc(out, cx, cy, r, start_deg, end_deg)    -> 圆弧上均匀分布的点，out 依次为 x, y
+ *   anim_apply(objs, prop, values[, offset])        -> 把 values 依次写入 objs 中各控件的属性
+ */
+
+#include "appsys_anim.h"
+#include "appsys_core.h"
+#include "appsys_js_utils.h"
+#include "jerryscript.h"
+#include <string.h>
+
+/**
+ * @brief 计算缓动后的进度
+ * @param ease 缓动曲线
+ * @param t 线性进度，0 ~ APPSYS_ANIM_T_MAX
+ * @return int32_t 缓动后的进度，overshoot 时可能超出 APPSYS_ANIM_T_MAX
+ */
+int32_t appsys_anim_ease(AppSysAnimEase_t ease, int32_t t) {
+    if (t <= 0) {
+        return 0;
+    }
+    if (t >= APPSYS_ANIM_T_MAX) {
+        return APPSYS_ANIM_T_MAX;
+    }
+    switch (ease) {
+    case APPSYS_ANIM_EASE_IN:
+        return lv_cubic_bezier(t, LV_BEZIER_VAL_FLOAT(0.42), 0, LV_BEZIER_VAL_MAX, LV_BEZIER_VAL_MAX);
+    case APPSYS_ANIM_EASE_OUT:
+        return lv_cubic_bezier(t, 0, 0, LV_BEZIER_VAL_FLOAT(0.58), LV_BEZIER_VAL_MAX);
+    case APPSYS_ANIM_EASE_IN_OUT:
+        return lv_cubic_bezier(t, LV_BEZIER_VAL_FLOAT(0.42), 0, LV_BEZIER_VAL_FLOAT(0.58), LV_BEZIER_VAL_MAX);
+    case APPSYS_ANIM_EASE_OVERSHOOT:
+        return lv_bezier3(t, 0, 1000, 1300, LV_BEZIER_VAL_MAX);
+    case APPSYS_ANIM_EASE_BOUNCE: {
+        // 与 lv_anim_path_bounce 相同：下落后两次回弹，回弹高度分别为 1/20 与 1/40
+        int32_t div = 1;
+        if (t < 408) {
+            t = (t * 2500) >> LV_BEZIER_VAL_SHIFT;
+        }
+        else if (t < 614) {
+            t = LV_BEZIER_VAL_MAX - (t - 408) * 5;
+            div = 20;
+        }
+        else if (t < 819) {
+            t = (t - 614) * 5;
+            div = 20;
+        }
+        else if (t < 921) {
+            t = LV_BEZIER_VAL_MAX - (t - 819) * 10;
+            div = 40;
+        }
+        else {
+            t = (t - 921) * 10;
+            div = 40;
+        }
+        t = LV_CLAMP(0, t, LV_BEZIER_VAL_MAX);
+        return LV_BEZIER_VAL_MAX - lv_bezier3(t, LV_BEZIER_VAL_MAX, 800, 500, 0) / div;
+    }
+    case APPSYS_ANIM_EASE_STEP:
+        return 0;
+    case APPSYS_ANIM_EASE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+/**
+ * @brief 按缓动后的进度在 from 与 to 之间插值
+ * @param progress appsys_anim_ease 的结果
+ */
+int32_t appsys_anim_interp(int32_t from, int32_t to, int32_t progress) {
+    return from + (int32_t)(((int64_t)(to - from) * progress) >> APPSYS_ANIM_T_SHIFT);
+}
+
+/**
+ * @brief 设置控件属性
+ * @param values 属性值，APPSYS_ANIM_PROP_POS 时为 (x, y) 两个值
+ */
+void appsys_anim_set_prop(lv_obj_t* obj, AppSysAnimProp_t prop, const int32_t* values) {
+    switch (prop) {
+    case APPSYS_ANIM_PROP_X:
+        lv_obj_set_x(obj, values[0]);
+        break;
+    case APPSYS_ANIM_PROP_Y:
+        lv_obj_set_y(obj, values[0]);
+        break;
+    case APPSYS_ANIM_PROP_POS:
+        lv_obj_set_pos(obj, values[0], values[1]);
+        break;
+    case APPSYS_ANIM_PROP_WIDTH:
+        lv_obj_set_width(obj, values[0]);
+        break;
+    case APPSYS_ANIM_PROP_HEIGHT:
+        lv_obj_set_height(obj, values[0]);
+        break;
+    case APPSYS_ANIM_PROP_OPA:
+        lv_obj_set_style_opa(obj, (lv_opa_t)LV_CLAMP(LV_OPA_TRANSP, values[0], LV_OPA_COVER), 0);
+        break;
+    case APPSYS_ANIM_PROP_TRANSLATE_X:
+        lv_obj_set_style_translate_x(obj, values[0], 0);
+        break;
+    case APPSYS_ANIM_PROP_TRANSLATE_Y:
+        lv_obj_set_style_translate_y(obj, values[0], 0);
+        break;
+    case APPSYS_ANIM_PROP_ROTATION:
+        lv_obj_set_style_transform_rotation(obj, values[0], 0);
+        break;
+    case APPSYS_ANIM_PROP_SCALE:
+        lv_obj_set_style_transform_scale(obj, values[0], 0);
+        break;
+    default:
+        break;
+    }
+}
+
+/********************************** 原生函数定义 **********************************/
+
+/**
+ * @brief 取出 Int32Array 的数据区
+ * @param value JS 值
+ * @param length 输出元素个数
+ * @return int32_t* 不是 Int32Array（或缓冲区已分离）时返回 NULL
+ */
+static int32_t* appsys_anim_get_i32(jerry_value_t value, jerry_length_t* length) {
+    if (!jerry_value_is_typedarray(value) || jerry_typedarray_type(value) != JERRY_TYPEDARRAY_INT32) {
+        return NULL;
+    }
+    jerry_length_t offset = 0;
+    jerry_length_t byte_length = 0;
+    jerry_value_t buffer = jerry_typedarray_buffer(value, &offset, &byte_length);
+    uint8_t* data = jerry_arraybuffer_data(buffer);
+    jerry_value_free(buffer);
+    if (data == NULL) {
+        return NULL;
+    }
+    *length = byte_length / sizeof(int32_t);
+    return (int32_t*)(data + offset);
+}
+
+static AppSysAnimEase_t appsys_anim_get_ease(const jerry_value_t args_p[], jerry_length_t args_count,
+    jerry_length_t index) {
+    int32_t ease = appsys_js_get_int(args_p, args_count, index, APPSYS_ANIM_EASE_LINEAR);
+    return (ease >= 0 && ease < APPSYS_ANIM_EASE_COUNT) ? (AppSysAnimEase_t)ease : APPSYS_ANIM_EASE_LINEAR;
+}
+
+/**
+ * @brief anim_ease(ease, t)
+ */
+static jerry_value_t js_anim_ease(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysAnimEase_t ease = appsys_anim_get_ease(args_p, args_count, 0);
+    int32_t t = appsys_js_get_int(args_p, args_count, 1, 0);
+    return jerry_number((double)appsys_anim_ease(ease, t));
+}
+
+/**
+ * @brief anim_interp(out, from, to, t[, ease])
+ */
+static jerry_value_t js_anim_interp(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    jerry_length_t out_len = 0, from_len = 0, to_len = 0;
+    int32_t* out = args_count > 0 ? appsys_anim_get_i32(args_p[0], &out_len) : NULL;
+    int32_t* from = args_count > 1 ? appsys_anim_get_i32(args_p[1], &from_len) : NULL;
+    int32_t* to = args_count > 2 ? appsys_anim_get_i32(args_p[2], &to_len) : NULL;
+    if (out == NULL || from == NULL || to == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "anim_interp: expected (Int32Array out, Int32Array from, Int32Array to, t[, ease])");
+    }
+    int32_t progress = appsys_anim_ease(appsys_anim_get_ease(args_p, args_count, 4),
+        appsys_js_get_int(args_p, args_count, 3, 0));
+
+    jerry_length_t n = LV_MIN(out_len, LV_MIN(from_len, to_len));
+    for (jerry_length_t i = 0; i < n; i++) {
+        out[i] = appsys_anim_interp(from[i], to[i], progress);
+    }
+    return jerry_value_copy(args_p[0]);
+}
+
+/**
+ * @brief anim_path(out, from, to[, ease])
+ */
+static jerry_value_t js_anim_path(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    jerry_length_t n = 0;
+    int32_t* out = args_count > 0 ? appsys_anim_get_i32(args_p[0], &n) : NULL;
+    if (out == NULL || args_count < 3) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "anim_path: expected (Int32Array out, from, to[, ease])");
+    }
+    int32_t from = appsys_js_get_int(args_p, args_count, 1, 0);
+    int32_t to = appsys_js_get_int(args_p, args_count, 2, 0);
+    AppSysAnimEase_t ease = appsys_anim_get_ease(args_p, args_count, 3);
+
+    for (jerry_length_t i = 0; i < n; i++) {
+        int32_t t = n > 1 ? (int32_t)(((int64_t)i * APPSYS_ANIM_T_MAX) / (n - 1)) : APPSYS_ANIM_T_MAX;
+        out[i] = appsys_anim_interp(from, to, appsys_anim_ease(ease, t));
+    }
+    return jerry_value_copy(args_p[0]);
+}
+
+/**
+ * @brief anim_arc(out, cx, cy, r, start_deg, end_deg)
+ */
+static jerry_value_t js_anim_arc(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    jerry_length_t len = 0;
+    int32_t* out = args_count > 0 ? appsys_anim_get_i32(args_p[0], &len) : NULL;
+    if (out == NULL || args_count < 6) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "anim_arc: expected (Int32Array out, cx, cy, r, start_deg, end_deg)");
+    }
+    int32_t cx = appsys_js_get_int(args_p, args_count, 1, 0);
+    int32_t cy = appsys_js_get_int(args_p, args_count, 2, 0);
+    int32_t r = appsys_js_get_int(args_p, args_count, 3, 0);
+    int32_t start = appsys_js_get_int(args_p, args_count, 4, 0);
+    int32_t end = appsys_js_get_int(args_p, args_count, 5, 360);
+
+    jerry_length_t n = len / 2;
+    for (jerry_length_t i = 0; i < n; i++) {
+        int32_t deg = n > 1 ? start + (int32_t)(((int64_t)(end - start) * i) / (n - 1)) : start;
+        deg %= 360;
+        if (deg < 0) {
+            deg += 360;
+        }
+        out[i * 2] = cx + ((r * lv_trigo_cos((int16_t)deg)) >> LV_TRIGO_SHIFT);
+        out[i * 2 + 1] = cy + ((r * lv_trigo_sin((int16_t)deg)) >> LV_TRIGO_SHIFT);
+    }
+    return jerry_value_copy(args_p[0]);
+}
+
+/**
+ * @brief anim_apply(objs, prop, values[, offset])，返回写入的控件数量
+ */
+static jerry_value_t js_anim_apply(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    jerry_length_t len = 0;
+    int32_t* values = args_count > 2 ? appsys_anim_get_i32(args_p[2], &len) : NULL;
+    int32_t prop = appsys_js_get_int(args_p, args_count, 1, -1);
+    if (values == NULL || !jerry_value_is_array(args_p[0]) || prop < 0 || prop >= APPSYS_ANIM_PROP_COUNT) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "anim_apply: expected (Array objs, ANIM_PROP_*, Int32Array values[, offset])");
+    }
+    jerry_length_t offset = (jerry_length_t)LV_MAX(0, appsys_js_get_int(args_p, args_count, 3, 0));
+    jerry_length_t stride = prop == APPSYS_ANIM_PROP_POS ? 2 : 1;
+
+    uint32_t count = jerry_array_length(args_p[0]);
+    uint32_t applied = 0;
+    for (uint32_t i = 0; i < count && offset + stride <= len; i++, offset += stride) {
+        jerry_value_t item = jerry_object_get_index(args_p[0], i);
+        lv_obj_t* obj = (lv_obj_t*)appsys_js_get_ptr(item);
+        jerry_value_free(item);
+        if (obj != NULL) {
+            appsys_anim_set_prop(obj, (AppSysAnimProp_t)prop, values + offset);
+            applied++;
+        }
+    }
+    return jerry_number((double)applied);
+}
+
+/**
+ * @brief 动画辅助原生函数列表
+ */
+static const AppSysFuncEntry appsys_anim_funcs[] = {
+    { .name = "anim_ease", .handler = js_anim_ease },
+    { .name = "anim_interp", .handler = js_anim_interp },
+    { .name = "anim_path", .handler = js_anim_path },
+    { .name = "anim_arc", .handler = js_anim_arc },
+    { .name = "anim_apply", .handler = js_anim_apply },
+};
+
+/**
+ * @brief 动画辅助常量
+ */
+static const struct {
+    const char* name;
+    int32_t value;
+} appsys_anim_consts[] = {
+    { "ANIM_T_MAX", APPSYS_ANIM_T_MAX },
+    { "ANIM_EASE_LINEAR", APPSYS_ANIM_EASE_LINEAR },
+    { "ANIM_EASE_IN", APPSYS_ANIM_EASE_IN },
+    { "ANIM_EASE_OUT", APPSYS_ANIM_EASE_OUT },
+    { "ANIM_EASE_IN_OUT", APPSYS_ANIM_EASE_IN_OUT },
+    { "ANIM_EASE_OVERSHOOT", APPSYS_ANIM_EASE_OVERSHOOT },
+    { "ANIM_EASE_BOUNCE", APPSYS_ANIM_EASE_BOUNCE },
+    { "ANIM_EASE_STEP", APPSYS_ANIM_EASE_STEP },
+    { "ANIM_PROP_X", APPSYS_ANIM_PROP_X },
+    { "ANIM_PROP_Y", APPSYS_ANIM_PROP_Y },
+    { "ANIM_PROP_POS", APPSYS_ANIM_PROP_POS },
+    { "ANIM_PROP_WIDTH", APPSYS_ANIM_PROP_WIDTH },
+    { "ANIM_PROP_HEIGHT", APPSYS_ANIM_PROP_HEIGHT },
+    { "ANIM_PROP_OPA", APPSYS_ANIM_PROP_OPA },
+    { "ANIM_PROP_TRANSLATE_X", APPSYS_ANIM_PROP_TRANSLATE_X },
+    { "ANIM_PROP_TRANSLATE_Y", APPSYS_ANIM_PROP_TRANSLATE_Y },
+    { "ANIM_PROP_ROTATION", APPSYS_ANIM_PROP_ROTATION },
+    { "ANIM_PROP_SCALE", APPSYS_ANIM_PROP_SCALE },
+};
+
+/**
+ * @brief 将动画辅助函数与常量注册到当前 realm
+ */
+void appsys_anim_register_natives(void) {
+    appsys_register_functions(appsys_anim_funcs, sizeof(appsys_anim_funcs) / sizeof(AppSysFuncEntry));
+
+    jerry_value_t global = jerry_current_realm();
+    for (size_t i = 0; i < sizeof(appsys_anim_consts) / sizeof(appsys_anim_consts[0]); i++) {
+        jerry_value_t key = jerry_string_sz(appsys_anim_consts[i].name);
+        jerry_value_t value = jerry_number((double)appsys_anim_consts[i].value);
+        appsys_js_define_const(global, key, value);
+        jerry_value_free(value);
+        jerry_value_free(key);
+    }
+    jerry_value_free(global);
+}
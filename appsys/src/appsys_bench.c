@@ -0,0 +1,811 @@
+﻿/**
+ * @file appsys_bench.c
+ * @brief 绑定开销微基准实现
+ * @author Sab1e
+ * @date 2025-08-23
+ *
+ * 每个用例是一段 JS 循环体，编译为 function(n) { for (let i = 0; i < n; i++) { body; } }，
+ * 在系统 realm（注册了全部原生函数与 LVGL 绑定，但不属于任何应用）中直接调用，不经过看门狗与事件分发。
+ * 先预热一轮，再计时 rounds 轮取最快的一轮，报告每次调用的耗时以及扣除空循环后的净耗时。
+ *
+ * 控件吞吐基准（appsys_bench_run_widgets）对 test_lv.js 用到的每种控件分别从 C 与 JS 创建、删除 N 个
+ * （JS 另有一组为每个控件注册两个事件回调，用于比较 APPSYS_COMPACT_OBJ 的效果），
+ * 报告每秒创建 / 删除的对象数与每个对象占用的内存：C 堆（LVGL 对象、样式、文本等）与 JS 堆（对象包装与
+ * 保存引用的数组，JerryScript 未开启内存统计时为 0）分开统计，内存取创建完成、尚未删除时与创建前的差值。
+ *
+ * 混合基准（appsys_bench_run_blend）在默认显示器上搭建几种场景，整屏失效后用 lv_refr_now 渲染，报告每帧耗时与
+ * 每秒填充的像素数。控件宽度刻意取奇数，图层与控件的行不会恰好落在向量边界上，用于比较 lv_conf.h 中
+ * LV_DRAW_BUF_VECTOR_ALIGN 不同取值（行宽与起始地址对齐）下混合内核的速度。
+ *
+ * 界面构建基准（appsys_bench_run_ui）以同一屏卡片（每张卡片是一个带位置、尺寸、圆角与背景色的容器和一个
+ * 居中的标签）比较两种构建方式：JS 逐个调用绑定函数，与 ui_load 加载等价的二进制界面描述（在 C 中按
+ * ui_compile.py 的格式直接编码）。两者各计时 rounds 轮取最快的一轮，报告每屏耗时、每个控件的耗时与加速比。
+ *
+ * 调用前必须已有默认显示器（模拟器使用 appsys_golden_create_display 创建的虚拟显示器），
+ * 测量期间不运行 lv_timer_handler，结果不含渲染开销。print 用例会向标准输出写入空行。
+ */
+
+#include "appsys_bench.h"
+#include "appsys_core.h"
+#include "appsys_port.h"
+#include "appsys_ui.h"
+#include "appsys_buf.h"
+#include "appsys_conf.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 基准用例
+ */
+typedef struct {
+    const char* name;
+    const char* setup;            // 在 scr（当前屏幕）上准备对象，可为空串
+    const char* body;             // 循环体，i 为循环变量
+    uint32_t divisor;             // 调用次数 = iterations / divisor
+} AppSysBenchCase_t;
+
+/**
+ * @brief 单个用例的结果
+ */
+typedef struct {
+    const char* name;
+    uint32_t calls;
+    uint64_t total_us;            // 最快一轮的耗时
+    double ns_per_call;
+    double net_ns_per_call;       // 扣除空循环的耗时
+} AppSysBenchResult_t;
+
+/**
+ * @brief 控件类型
+ */
+typedef struct {
+    const char* name;
+    lv_obj_t* (*create)(lv_obj_t* parent);
+    const char* js_create;        // JS 绑定中的创建函数名
+} AppSysBenchWidget_t;
+
+/**
+ * @brief 控件吞吐结果，C 与 JS 各一条
+ */
+typedef struct {
+    const char* name;
+    const char* side;             // "c"、"js" 或 "js_cb"（每个控件注册两个 JS 回调）
+    uint32_t count;
+    double create_per_sec;
+    double delete_per_sec;
+    double heap_bytes_per_obj;    // C 堆
+    double js_bytes_per_obj;      // JS 堆
+} AppSysBenchWidgetResult_t;
+
+/**
+ * @brief 基准用例列表，第一个用例（空循环）作为基线
+ */
+static const AppSysBenchCase_t bench_cases[] = {
+    { "loop",                       "",                                         "",                                         1 },
+    { "native_nop",                 "",                                         "bench_nop()",                              1 },
+    { "native_nop_3args",           "",                                         "bench_nop(i, 1, 'a')",                     1 },
+    { "print",                      "",                                         "print('')",                                100 },
+    { "lv_obj_set_size",            "let o = lv_obj_create(scr);",              "lv_obj_set_size(o, 100 + (i & 7), 50)",    1 },
+    { "lv_label_set_text",          "let l = lv_label_create(scr); let t = ['12:00', '12:01'];",
+                                                                                "lv_label_set_text(l, t[i & 1])",           1 },
+    { "lv_label_set_text_same",     "let l = lv_label_create(scr); lv_label_set_text(l, '12:00');",
+                                                                                "lv_label_set_text(l, '12:00')",            1 },
+    { "label_set_int",              "let l = lv_label_create(scr);",            "label_set_int(l, i)",                      1 },
+    { "lv_obj_set_style_radius",    "let o = lv_obj_create(scr);",              "lv_obj_set_style_radius(o, i & 15, 0)",    1 },
+    { "lv_obj_set_style_bg_color",  "let o = lv_obj_create(scr); let c = [{ red: 255, green: 0, blue: 0 }, { red: 0, green: 0, blue: 255 }];",
+                                                                                "lv_obj_set_style_bg_color(o, c[i & 1], 0)", 1 },
+    { "lv_obj_create_del",          "",                                         "lv_obj_del(lv_obj_create(scr))",           10 },
+};
+
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+/**
+ * @brief 控件吞吐基准的控件类型（test_lv.js 中用到的控件）
+ */
+static const AppSysBenchWidget_t bench_widgets[] = {
+    { "label",      lv_label_create,      "lv_label_create" },
+    { "button",     lv_button_create,     "lv_btn_create" },
+    { "slider",     lv_slider_create,     "lv_slider_create" },
+    { "switch",     lv_switch_create,     "lv_switch_create" },
+    { "dropdown",   lv_dropdown_create,   "lv_dropdown_create" },
+    { "textarea",   lv_textarea_create,   "lv_textarea_create" },
+    { "checkbox",   lv_checkbox_create,   "lv_checkbox_create" },
+    { "arc",        lv_arc_create,        "lv_arc_create" },
+    { "bar",        lv_bar_create,        "lv_bar_create" },
+    { "chart",      lv_chart_create,      "lv_chart_create" },
+    { "table",      lv_table_create,      "lv_table_create" },
+    { "roller",     lv_roller_create,     "lv_roller_create" },
+};
+
+#define BENCH_WIDGET_COUNT (sizeof(bench_widgets) / sizeof(bench_widgets[0]))
+
+/**
+ * @brief bench_nop(...) 空原生函数，测量 JS 到原生的调用本身
+ */
+static jerry_value_t js_bench_nop(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    (void)args_p;
+    (void)args_count;
+    return jerry_undefined();
+}
+
+/**
+ * @brief 基准测试原生函数列表
+ */
+static const AppSysFuncEntry appsys_bench_funcs[] = {
+    {
+        .name = "bench_nop",
+        .handler = js_bench_nop
+    },
+};
+
+/**
+ * @brief 编译用例，返回 function(n)
+ */
+static jerry_value_t appsys_bench_compile(const AppSysBenchCase_t* bench) {
+    char source[512];
+    int len = snprintf(source, sizeof(source),
+        "(function () { let scr = lv_scr_act(); %s return function (n) { for (let i = 0; i < n; i++) { %s; } }; })()",
+        bench->setup, bench->body);
+    if (len < 0 || (size_t)len >= sizeof(source)) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "bench: case source too long");
+    }
+    return jerry_eval((const jerry_char_t*)source, (size_t)len, JERRY_PARSE_NO_OPTS);
+}
+
+/**
+ * @brief 调用 fn(n) 一次
+ * @return uint64_t 耗时 [us]，抛出异常时返回 UINT64_MAX（异常已打印）
+ */
+static uint64_t appsys_bench_call(jerry_value_t fn, uint32_t n) {
+    jerry_value_t arg = jerry_number((double)n);
+    jerry_value_t undef = jerry_undefined();
+    uint64_t start_us = appsys_port_get_time_us();
+    jerry_value_t ret = jerry_call(fn, undef, &arg, 1);
+    uint64_t elapsed_us = appsys_port_get_time_us() - start_us;
+    bool failed = jerry_value_is_exception(ret);
+    if (failed) {
+        appsys_report_exception(ret);
+    }
+    jerry_value_free(ret);
+    jerry_value_free(arg);
+    return failed ? UINT64_MAX : elapsed_us;
+}
+
+/**
+ * @brief 写出 CSV
+ */
+static void appsys_bench_write_csv(const char* path, const AppSysBenchResult_t* results, uint32_t count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("[bench] cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "name,calls,total_us,ns_per_call,net_ns_per_call\n");
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(f, "%s,%u,%llu,%.1f,%.1f\n", results[i].name, results[i].calls,
+            (unsigned long long)results[i].total_us, results[i].ns_per_call, results[i].net_ns_per_call);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief 写出 JSON
+ */
+static void appsys_bench_write_json(const char* path, const AppSysBenchConfig_t* config,
+    const AppSysBenchResult_t* results, uint32_t count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("[bench] cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "{\n  \"iterations\": %u,\n  \"rounds\": %u,\n  \"results\": [\n", config->iterations, config->rounds);
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(f, "    { \"name\": \"%s\", \"calls\": %u, \"total_us\": %llu, \"ns_per_call\": %.1f, \"net_ns_per_call\": %.1f }%s\n",
+            results[i].name, results[i].calls, (unsigned long long)results[i].total_us,
+            results[i].ns_per_call, results[i].net_ns_per_call, i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+/**
+ * @brief 进入基准测试使用的系统 realm
+ * @return jerry_value_t realm，由 appsys_bench_end 释放
+ */
+static jerry_value_t appsys_bench_begin(jerry_value_t* prev_realm) {
+    appsys_vm_init();
+    jerry_value_t realm = appsys_create_system_realm();
+    *prev_realm = jerry_set_realm(realm);
+    appsys_register_functions(appsys_bench_funcs, sizeof(appsys_bench_funcs) / sizeof(AppSysFuncEntry));
+    return realm;
+}
+
+static void appsys_bench_end(jerry_value_t realm, jerry_value_t prev_realm) {
+    jerry_set_realm(prev_realm);
+    jerry_value_free(realm);
+}
+
+/**
+ * @brief 运行全部基准用例并打印结果
+ * @param config 配置
+ * @return uint32_t 失败（编译或运行时抛出异常）的用例数量
+ */
+uint32_t appsys_bench_run(const AppSysBenchConfig_t* config) {
+    if (lv_display_get_default() == NULL) {
+        printf("[bench] no display, create one before running benchmarks\n");
+        return 1;
+    }
+    uint32_t iterations = config->iterations > 0 ? config->iterations : APPSYS_BENCH_ITERATIONS;
+    uint32_t rounds = config->rounds > 0 ? config->rounds : APPSYS_BENCH_ROUNDS;
+
+    jerry_value_t prev_realm;
+    jerry_value_t realm = appsys_bench_begin(&prev_realm);
+
+    AppSysBenchResult_t results[BENCH_CASE_COUNT];
+    uint32_t result_count = 0;
+    uint32_t failures = 0;
+    double baseline_ns = 0;
+
+    for (uint32_t c = 0; c < BENCH_CASE_COUNT; c++) {
+        const AppSysBenchCase_t* bench = &bench_cases[c];
+        uint32_t calls = iterations / bench->divisor;
+        if (calls == 0) {
+            calls = 1;
+        }
+        jerry_value_t fn = appsys_bench_compile(bench);
+        if (jerry_value_is_exception(fn) || !jerry_value_is_function(fn)) {
+            printf("[bench] %s: failed to compile\n", bench->name);
+            if (jerry_value_is_exception(fn)) {
+                appsys_report_exception(fn);
+            }
+            jerry_value_free(fn);
+            lv_obj_clean(lv_screen_active());
+            failures++;
+            continue;
+        }
+
+        // 预热：让 VM 与 LVGL 完成首次分配，结果不计入
+        uint64_t best_us = appsys_bench_call(fn, calls / APPSYS_BENCH_WARMUP_DIVISOR + 1);
+        for (uint32_t r = 0; r < rounds && best_us != UINT64_MAX; r++) {
+            uint64_t elapsed_us = appsys_bench_call(fn, calls);
+            if (elapsed_us == UINT64_MAX || r == 0 || elapsed_us < best_us) {
+                best_us = elapsed_us;
+            }
+        }
+        jerry_value_free(fn);
+        lv_obj_clean(lv_screen_active());
+        if (best_us == UINT64_MAX) {
+            printf("[bench] %s: threw an exception\n", bench->name);
+            failures++;
+            continue;
+        }
+
+        AppSysBenchResult_t* res = &results[result_count++];
+        res->name = bench->name;
+        res->calls = calls;
+        res->total_us = best_us;
+        res->ns_per_call = (double)best_us * 1000.0 / calls;
+        if (c == 0) {
+            baseline_ns = res->ns_per_call;
+        }
+        res->net_ns_per_call = res->ns_per_call - baseline_ns;
+    }
+
+    appsys_bench_end(realm, prev_realm);
+
+    printf("[bench] %u iterations, best of %u rounds\n", iterations, rounds);
+    printf("%-28s %10s %12s %12s %12s\n", "case", "calls", "total [us]", "ns/call", "net ns/call");
+    for (uint32_t i = 0; i < result_count; i++) {
+        printf("%-28s %10u %12llu %12.1f %12.1f\n", results[i].name, results[i].calls,
+            (unsigned long long)results[i].total_us, results[i].ns_per_call, results[i].net_ns_per_call);
+    }
+    if (config->csv_path != NULL) {
+        appsys_bench_write_csv(config->csv_path, results, result_count);
+    }
+    if (config->json_path != NULL) {
+        AppSysBenchConfig_t effective = *config;
+        effective.iterations = iterations;
+        effective.rounds = rounds;
+        appsys_bench_write_json(config->json_path, &effective, results, result_count);
+    }
+    return failures;
+}
+
+/**
+ * @brief JS 堆当前已分配的字节数，JerryScript 未开启内存统计时返回 0
+ */
+static size_t appsys_bench_js_heap_used(void) {
+    jerry_heap_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!jerry_heap_stats(&stats)) {
+        return 0;
+    }
+    return stats.allocated_bytes;
+}
+
+/**
+ * @brief 从 C 创建、删除 count 个控件
+ * @return bool 内存不足时返回 false
+ */
+static bool appsys_bench_widget_c(const AppSysBenchWidget_t* widget, lv_obj_t** objs, uint32_t count,
+    AppSysBenchWidgetResult_t* res) {
+    lv_obj_t* scr = lv_screen_active();
+    size_t heap_before = appsys_port_get_heap_used();
+    uint64_t t0 = appsys_port_get_time_us();
+    for (uint32_t i = 0; i < count; i++) {
+        objs[i] = widget->create(scr);
+        if (objs[i] == NULL) {
+            lv_obj_clean(scr);
+            return false;
+        }
+    }
+    uint64_t t1 = appsys_port_get_time_us();
+    size_t heap_after = appsys_port_get_heap_used();
+    for (uint32_t i = 0; i < count; i++) {
+        lv_obj_delete(objs[i]);
+    }
+    uint64_t t2 = appsys_port_get_time_us();
+
+    res->create_per_sec = count * 1e6 / (double)(t1 > t0 ? t1 - t0 : 1);
+    res->delete_per_sec = count * 1e6 / (double)(t2 > t1 ? t2 - t1 : 1);
+    res->heap_bytes_per_obj = heap_after > heap_before ? (double)(heap_after - heap_before) / count : 0;
+    res->js_bytes_per_obj = 0;
+    return true;
+}
+
+/**
+ * @brief 从 JS 创建、删除 count 个控件
+ * @param with_handlers 为每个控件注册两个 JS 事件回调（CLICKED 与 VALUE_CHANGED），用于衡量回调占用的内存
+ * @return bool 脚本抛出异常时返回 false（异常已打印）
+ */
+static bool appsys_bench_widget_js(const AppSysBenchWidget_t* widget, uint32_t count, bool with_handlers,
+    AppSysBenchWidgetResult_t* res) {
+    char source[640];
+    int len = snprintf(source, sizeof(source),
+        "(function () { let scr = lv_scr_act(); let a = []; let f = function () {};"
+        " return [function (n) { for (let i = 0; i < n; i++) { let o = %s(scr); %s a.push(o); } },"
+        " function () { for (let i = 0; i < a.length; i++) { lv_obj_del(a[i]); } a = []; }]; })()",
+        widget->js_create, with_handlers
+        ? "register_lv_event_handler(o, LV_EVENT_CLICKED, f); register_lv_event_handler(o, LV_EVENT_VALUE_CHANGED, f);"
+        : "");
+    jerry_value_t pair = jerry_eval((const jerry_char_t*)source, (size_t)len, JERRY_PARSE_NO_OPTS);
+    if (jerry_value_is_exception(pair)) {
+        appsys_report_exception(pair);
+        jerry_value_free(pair);
+        return false;
+    }
+    jerry_value_t create_fn = jerry_object_get_index(pair, 0);
+    jerry_value_t delete_fn = jerry_object_get_index(pair, 1);
+    jerry_value_free(pair);
+
+    jerry_heap_gc(JERRY_GC_PRESSURE_HIGH);
+    size_t heap_before = appsys_port_get_heap_used();
+    size_t js_before = appsys_bench_js_heap_used();
+    uint64_t create_us = appsys_bench_call(create_fn, count);
+    size_t heap_after = appsys_port_get_heap_used();
+    size_t js_after = appsys_bench_js_heap_used();
+    uint64_t delete_us = create_us == UINT64_MAX ? UINT64_MAX : appsys_bench_call(delete_fn, 0);
+    jerry_value_free(create_fn);
+    jerry_value_free(delete_fn);
+    lv_obj_clean(lv_screen_active());
+    if (create_us == UINT64_MAX || delete_us == UINT64_MAX) {
+        return false;
+    }
+
+    res->create_per_sec = count * 1e6 / (double)(create_us > 0 ? create_us : 1);
+    res->delete_per_sec = count * 1e6 / (double)(delete_us > 0 ? delete_us : 1);
+    res->heap_bytes_per_obj = heap_after > heap_before ? (double)(heap_after - heap_before) / count : 0;
+    res->js_bytes_per_obj = js_after > js_before ? (double)(js_after - js_before) / count : 0;
+    return true;
+}
+
+/**
+ * @brief 写出控件吞吐结果（CSV）
+ */
+static void appsys_bench_write_widgets_csv(const char* path, const AppSysBenchWidgetResult_t* results, uint32_t count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("[bench] cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "widget,side,count,create_per_sec,delete_per_sec,heap_bytes_per_obj,js_bytes_per_obj\n");
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(f, "%s,%s,%u,%.0f,%.0f,%.1f,%.1f\n", results[i].name, results[i].side, results[i].count,
+            results[i].create_per_sec, results[i].delete_per_sec, results[i].heap_bytes_per_obj, results[i].js_bytes_per_obj);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief 写出控件吞吐结果（JSON）
+ */
+static void appsys_bench_write_widgets_json(const char* path, uint32_t widget_count,
+    const AppSysBenchWidgetResult_t* results, uint32_t count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("[bench] cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "{\n  \"widgets\": %u,\n  \"compact_obj\": %s,\n  \"results\": [\n", widget_count,
+        APPSYS_COMPACT_OBJ ? "true" : "false");
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(f, "    { \"widget\": \"%s\", \"side\": \"%s\", \"count\": %u, \"create_per_sec\": %.0f, "
+            "\"delete_per_sec\": %.0f, \"heap_bytes_per_obj\": %.1f, \"js_bytes_per_obj\": %.1f }%s\n",
+            results[i].name, results[i].side, results[i].count, results[i].create_per_sec, results[i].delete_per_sec,
+            results[i].heap_bytes_per_obj, results[i].js_bytes_per_obj, i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+/**
+ * @brief 对每种控件分别从 C 与 JS 创建、删除 widgets 个，打印吞吐量与每个对象的内存
+ * @param config 配置，使用 widgets、csv_path、json_path
+ * @return uint32_t 失败的控件类型数量
+ */
+uint32_t appsys_bench_run_widgets(const AppSysBenchConfig_t* config) {
+    if (lv_display_get_default() == NULL) {
+        printf("[bench] no display, create one before running benchmarks\n");
+        return 1;
+    }
+    uint32_t count = config->widgets > 0 ? config->widgets : APPSYS_BENCH_WIDGETS;
+    lv_obj_t** objs = (lv_obj_t**)malloc(count * sizeof(lv_obj_t*));
+    if (objs == NULL) {
+        printf("[bench] out of memory\n");
+        return 1;
+    }
+    jerry_value_t prev_realm;
+    jerry_value_t realm = appsys_bench_begin(&prev_realm);
+
+    AppSysBenchWidgetResult_t results[BENCH_WIDGET_COUNT * 3];
+    uint32_t result_count = 0;
+    uint32_t failures = 0;
+    for (uint32_t w = 0; w < BENCH_WIDGET_COUNT; w++) {
+        const AppSysBenchWidget_t* widget = &bench_widgets[w];
+        // 预热：完成类的首次初始化与主题样式分配
+        lv_obj_delete(widget->create(lv_screen_active()));
+
+        AppSysBenchWidgetResult_t* res = &results[result_count];
+        res->name = widget->name;
+        res->side = "c";
+        res->count = count;
+        if (appsys_bench_widget_c(widget, objs, count, res)) {
+            result_count++;
+        }
+        else {
+            printf("[bench] %s: C create failed\n", widget->name);
+            failures++;
+            continue;
+        }
+
+        for (int with_handlers = 0; with_handlers <= 1; with_handlers++) {
+            res = &results[result_count];
+            res->name = widget->name;
+            res->side = with_handlers ? "js_cb" : "js";
+            res->count = count;
+            if (appsys_bench_widget_js(widget, count, with_handlers != 0, res)) {
+                result_count++;
+            }
+            else {
+                printf("[bench] %s: %s create failed\n", widget->name, res->side);
+                failures++;
+            }
+        }
+    }
+    appsys_bench_end(realm, prev_realm);
+    free(objs);
+
+    printf("[bench] %u widgets per type%s\n", count, APPSYS_COMPACT_OBJ ? ", compact objects" : "");
+    printf("%-10s %-5s %12s %12s %14s %12s\n", "widget", "side", "create/s", "delete/s", "heap B/obj", "js B/obj");
+    for (uint32_t i = 0; i < result_count; i++) {
+        printf("%-10s %-5s %12.0f %12.0f %14.1f %12.1f\n", results[i].name, results[i].side,
+            results[i].create_per_sec, results[i].delete_per_sec, results[i].heap_bytes_per_obj, results[i].js_bytes_per_obj);
+    }
+    if (config->csv_path != NULL) {
+        appsys_bench_write_widgets_csv(config->csv_path, results, result_count);
+    }
+    if (config->json_path != NULL) {
+        appsys_bench_write_widgets_json(config->json_path, count, results, result_count);
+    }
+    return failures;
+}
+
+/**
+ * @brief 混合场景
+ */
+typedef enum {
+    BENCH_BLEND_OPAQUE = 0,       // 不透明填充
+    BENCH_BLEND_ALPHA,            // 半透明填充（bg_opa）
+    BENCH_BLEND_LAYER,            // 整体透明度（opa），先渲染到图层再混合
+} AppSysBenchBlend_t;
+
+static const char* const bench_blend_names[] = { "opaque_fill", "alpha_fill", "layer_blend" };
+
+#define BENCH_BLEND_COUNT (sizeof(bench_blend_names) / sizeof(bench_blend_names[0]))
+
+/**
+ * @brief 在当前屏幕上搭建混合场景：互相重叠的奇数宽度矩形
+ */
+static void appsys_bench_blend_scene(AppSysBenchBlend_t scene) {
+    lv_obj_t* scr = lv_screen_active();
+    lv_obj_clean(scr);
+    int32_t w = lv_display_get_horizontal_resolution(NULL);
+    int32_t h = lv_display_get_vertical_resolution(NULL);
+    for (int32_t i = 0; i < 12; i++) {
+        lv_obj_t* obj = lv_obj_create(scr);
+        lv_obj_remove_style_all(obj);
+        lv_obj_set_size(obj, w / 2 + 13, h / 3 + 7);
+        lv_obj_set_pos(obj, (i % 4) * (w / 6) + 3, (i / 4) * (h / 4) + 1);
+        lv_obj_set_style_bg_color(obj, lv_color_hsv_to_rgb((uint16_t)(i * 30), 80, 90), 0);
+        lv_obj_set_style_bg_opa(obj, scene == BENCH_BLEND_ALPHA ? LV_OPA_50 : LV_OPA_COVER, 0);
+        if (scene == BENCH_BLEND_LAYER) {
+            lv_obj_set_style_opa(obj, LV_OPA_70, 0);
+        }
+    }
+}
+
+/**
+ * @brief 按场景渲染 frames 帧（整屏重绘）并取最快的一轮，打印每帧耗时与像素吞吐量
+ * @param config 配置，使用 rounds、csv_path、json_path
+ * @return uint32_t 没有显示器时返回 1，否则返回 0
+ */
+uint32_t appsys_bench_run_blend(const AppSysBenchConfig_t* config) {
+    lv_display_t* disp = lv_display_get_default();
+    if (disp == NULL) {
+        printf("[bench] no display, create one before running benchmarks\n");
+        return 1;
+    }
+    uint32_t rounds = config->rounds > 0 ? config->rounds : APPSYS_BENCH_ROUNDS;
+    uint32_t frames = APPSYS_BENCH_BLEND_FRAMES;
+    double pixels = (double)lv_display_get_horizontal_resolution(disp) * lv_display_get_vertical_resolution(disp);
+    lv_draw_buf_t* frame = lv_display_get_buf_active(disp);
+    uint32_t stride = frame != NULL ? frame->header.stride : 0;
+    // 帧缓冲起始地址实际满足的对齐（最大 64）
+    uint32_t addr_align = 64;
+    while (frame != NULL && addr_align > 1 && ((uintptr_t)frame->data % addr_align) != 0) {
+        addr_align /= 2;
+    }
+
+    double ms_per_frame[BENCH_BLEND_COUNT];
+    for (uint32_t c = 0; c < BENCH_BLEND_COUNT; c++) {
+        appsys_bench_blend_scene((AppSysBenchBlend_t)c);
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(disp);    // 预热：建立图层与缓存
+        uint64_t best_us = UINT64_MAX;
+        for (uint32_t r = 0; r < rounds; r++) {
+            uint64_t start_us = appsys_port_get_time_us();
+            for (uint32_t f = 0; f < frames; f++) {
+                lv_obj_invalidate(lv_screen_active());
+                lv_refr_now(disp);
+            }
+            uint64_t elapsed_us = appsys_port_get_time_us() - start_us;
+            if (elapsed_us < best_us) {
+                best_us = elapsed_us;
+            }
+        }
+        ms_per_frame[c] = (double)best_us / 1000.0 / frames;
+    }
+    lv_obj_clean(lv_screen_active());
+
+    printf("[bench] blend: stride align %u, buffer align %u, frame stride %u B, frame address aligned to %u B\n",
+        (unsigned)LV_DRAW_BUF_STRIDE_ALIGN, (unsigned)LV_DRAW_BUF_ALIGN, stride, addr_align);
+    printf("%-16s %12s %12s\n", "scene", "ms/frame", "Mpx/s");
+    for (uint32_t c = 0; c < BENCH_BLEND_COUNT; c++) {
+        printf("%-16s %12.3f %12.1f\n", bench_blend_names[c], ms_per_frame[c],
+            ms_per_frame[c] > 0 ? pixels / (ms_per_frame[c] * 1000.0) : 0.0);
+    }
+
+    if (config->csv_path != NULL) {
+        FILE* f = fopen(config->csv_path, "w");
+        if (f == NULL) {
+            printf("[bench] cannot write %s\n", config->csv_path);
+        }
+        else {
+            fprintf(f, "scene,stride_align,buf_align,ms_per_frame,mpx_per_sec\n");
+            for (uint32_t c = 0; c < BENCH_BLEND_COUNT; c++) {
+                fprintf(f, "%s,%u,%u,%.3f,%.1f\n", bench_blend_names[c], (unsigned)LV_DRAW_BUF_STRIDE_ALIGN,
+                    (unsigned)LV_DRAW_BUF_ALIGN, ms_per_frame[c], ms_per_frame[c] > 0 ? pixels / (ms_per_frame[c] * 1000.0) : 0.0);
+            }
+            fclose(f);
+        }
+    }
+    if (config->json_path != NULL) {
+        FILE* f = fopen(config->json_path, "w");
+        if (f == NULL) {
+            printf("[bench] cannot write %s\n", config->json_path);
+        }
+        else {
+            fprintf(f, "{\n  \"stride_align\": %u,\n  \"buf_align\": %u,\n  \"frames\": %u,\n  \"results\": [\n",
+                (unsigned)LV_DRAW_BUF_STRIDE_ALIGN, (unsigned)LV_DRAW_BUF_ALIGN, frames);
+            for (uint32_t c = 0; c < BENCH_BLEND_COUNT; c++) {
+                fprintf(f, "    { \"scene\": \"%s\", \"ms_per_frame\": %.3f, \"mpx_per_sec\": %.1f }%s\n",
+                    bench_blend_names[c], ms_per_frame[c], ms_per_frame[c] > 0 ? pixels / (ms_per_frame[c] * 1000.0) : 0.0,
+                    c + 1 < BENCH_BLEND_COUNT ? "," : "");
+            }
+            fprintf(f, "  ]\n}\n");
+            fclose(f);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 界面构建基准中每张卡片的参数，JS 与二进制界面两侧保持一致
+ */
+#define BENCH_UI_CARD_W         36
+#define BENCH_UI_CARD_H         16
+#define BENCH_UI_CARD_RADIUS    4
+#define BENCH_UI_CARD_COLOR     0x2060A0
+
+/**
+ * @brief 编码 cards 张卡片的二进制界面：根容器下每张卡片带一个居中的标签
+ */
+static void appsys_bench_ui_encode(AppSysBuf_t* buf, uint32_t cards) {
+    appsys_buf_put(buf, UI_MAGIC, 4);
+    appsys_buf_put_u8(buf, UI_VERSION);
+    appsys_buf_put_u8(buf, UI_CLASS_OBJ);
+    appsys_buf_put_varint(buf, 0);
+    appsys_buf_put_varint(buf, cards);
+    for (uint32_t i = 0; i < cards; i++) {
+        appsys_buf_put_u8(buf, UI_CLASS_OBJ);
+        appsys_buf_put_varint(buf, 6);
+        appsys_buf_put_u8(buf, UI_PROP_X);
+        appsys_buf_put_u8(buf, UI_COORD_PX);
+        appsys_buf_put_svarint(buf, (int32_t)(i & 7) * (BENCH_UI_CARD_W + 4));
+        appsys_buf_put_u8(buf, UI_PROP_Y);
+        appsys_buf_put_u8(buf, UI_COORD_PX);
+        appsys_buf_put_svarint(buf, (int32_t)(i >> 3) * (BENCH_UI_CARD_H + 4));
+        appsys_buf_put_u8(buf, UI_PROP_WIDTH);
+        appsys_buf_put_u8(buf, UI_COORD_PX);
+        appsys_buf_put_svarint(buf, BENCH_UI_CARD_W);
+        appsys_buf_put_u8(buf, UI_PROP_HEIGHT);
+        appsys_buf_put_u8(buf, UI_COORD_PX);
+        appsys_buf_put_svarint(buf, BENCH_UI_CARD_H);
+        appsys_buf_put_u8(buf, UI_PROP_STYLE_NUM);
+        appsys_buf_put_varint(buf, LV_STYLE_RADIUS);
+        appsys_buf_put_varint(buf, 0);
+        appsys_buf_put_svarint(buf, BENCH_UI_CARD_RADIUS);
+        appsys_buf_put_u8(buf, UI_PROP_STYLE_COLOR);
+        appsys_buf_put_varint(buf, LV_STYLE_BG_COLOR);
+        appsys_buf_put_varint(buf, 0);
+        appsys_buf_put_varint(buf, BENCH_UI_CARD_COLOR);
+        appsys_buf_put_varint(buf, 1);
+
+        appsys_buf_put_u8(buf, UI_CLASS_LABEL);
+        appsys_buf_put_varint(buf, 2);
+        appsys_buf_put_u8(buf, UI_PROP_TEXT);
+        appsys_buf_put_str(buf, "item");
+        appsys_buf_put_u8(buf, UI_PROP_ALIGN);
+        appsys_buf_put_varint(buf, LV_ALIGN_CENTER);
+        appsys_buf_put_varint(buf, 0);
+    }
+}
+
+/**
+ * @brief 用 JS 绑定函数与 ui_load 分别构建同一屏卡片，打印每屏耗时与加速比
+ * @param config 配置，使用 rounds、widgets（卡片数量）、csv_path、json_path
+ * @return uint32_t 失败的构建方式数量
+ */
+uint32_t appsys_bench_run_ui(const AppSysBenchConfig_t* config) {
+    if (lv_display_get_default() == NULL) {
+        printf("[bench] no display, create one before running benchmarks\n");
+        return 1;
+    }
+    uint32_t rounds = config->rounds > 0 ? config->rounds : APPSYS_BENCH_ROUNDS;
+    uint32_t cards = config->widgets > 0 ? config->widgets : APPSYS_BENCH_WIDGETS;
+    uint32_t widgets = cards * 2 + 1;
+    lv_obj_t* scr = lv_screen_active();
+    jerry_value_t prev_realm;
+    jerry_value_t realm = appsys_bench_begin(&prev_realm);
+    uint32_t failures = 0;
+
+    // JS：与 test_lv.js 相同的逐个调用方式
+    char source[768];
+    int len = snprintf(source, sizeof(source),
+        "(function () { let scr = lv_scr_act(); let c = { red: %d, green: %d, blue: %d };"
+        " return function (n) { let root = lv_obj_create(scr); for (let i = 0; i < n; i++) {"
+        " let o = lv_obj_create(root); lv_obj_set_pos(o, (i & 7) * %d, (i >> 3) * %d); lv_obj_set_size(o, %d, %d);"
+        " lv_obj_set_style_radius(o, %d, 0); lv_obj_set_style_bg_color(o, c, 0);"
+        " let l = lv_label_create(o); lv_label_set_text(l, 'item'); lv_obj_align(l, LV_ALIGN_CENTER, 0, 0); } }; })()",
+        (BENCH_UI_CARD_COLOR >> 16) & 0xFF, (BENCH_UI_CARD_COLOR >> 8) & 0xFF, BENCH_UI_CARD_COLOR & 0xFF,
+        BENCH_UI_CARD_W + 4, BENCH_UI_CARD_H + 4, BENCH_UI_CARD_W, BENCH_UI_CARD_H, BENCH_UI_CARD_RADIUS);
+    uint64_t js_us = UINT64_MAX;
+    jerry_value_t build_fn = jerry_eval((const jerry_char_t*)source, (size_t)len, JERRY_PARSE_NO_OPTS);
+    if (jerry_value_is_exception(build_fn)) {
+        appsys_report_exception(build_fn);
+    }
+    else {
+        for (uint32_t r = 0; r <= rounds; r++) {
+            uint64_t elapsed_us = appsys_bench_call(build_fn, cards);
+            lv_obj_clean(scr);
+            // 第 0 轮为预热，不计入
+            if (elapsed_us == UINT64_MAX) {
+                js_us = UINT64_MAX;
+                break;
+            }
+            if (r > 0 && elapsed_us < js_us) {
+                js_us = elapsed_us;
+            }
+        }
+    }
+    jerry_value_free(build_fn);
+    if (js_us == UINT64_MAX) {
+        printf("[bench] ui: js build failed\n");
+        failures++;
+    }
+
+    // 二进制界面：一次 ui_load
+    uint64_t ui_us = UINT64_MAX;
+    AppSysBuf_t buf;
+    appsys_buf_init(&buf);
+    appsys_bench_ui_encode(&buf, cards);
+    for (uint32_t r = 0; r <= rounds && !buf.oom; r++) {
+        jerry_value_t ids = jerry_object();
+        const char* error = NULL;
+        uint64_t start_us = appsys_port_get_time_us();
+        lv_obj_t* root = appsys_ui_load(buf.data, buf.len, scr, ids, jerry_undefined(), NULL, &error);
+        uint64_t elapsed_us = appsys_port_get_time_us() - start_us;
+        jerry_value_free(ids);
+        lv_obj_clean(scr);
+        if (root == NULL) {
+            printf("[bench] ui: %s\n", error != NULL ? error : "ui_load failed");
+            ui_us = UINT64_MAX;
+            break;
+        }
+        if (r > 0 && elapsed_us < ui_us) {
+            ui_us = elapsed_us;
+        }
+    }
+    size_t ui_size = buf.len;
+    appsys_buf_free(&buf);
+    if (ui_us == UINT64_MAX) {
+        failures++;
+    }
+    appsys_bench_end(realm, prev_realm);
+
+    printf("[bench] ui: %u cards, %u widgets, %u B ui data\n", cards, widgets, (unsigned)ui_size);
+    printf("%-8s %12s %14s\n", "side", "us/screen", "us/widget");
+    if (js_us != UINT64_MAX) {
+        printf("%-8s %12llu %14.2f\n", "js", (unsigned long long)js_us, (double)js_us / widgets);
+    }
+    if (ui_us != UINT64_MAX) {
+        printf("%-8s %12llu %14.2f\n", "ui_load", (unsigned long long)ui_us, (double)ui_us / widgets);
+    }
+    double speedup = js_us != UINT64_MAX && ui_us != UINT64_MAX ? (double)js_us / (double)(ui_us > 0 ? ui_us : 1) : 0;
+    if (speedup > 0) {
+        printf("ui_load speedup: %.1fx\n", speedup);
+    }
+
+    if (config->csv_path != NULL) {
+        FILE* f = fopen(config->csv_path, "w");
+        if (f == NULL) {
+            printf("[bench] cannot write %s\n", config->csv_path);
+        }
+        else {
+            fprintf(f, "side,cards,widgets,us_per_screen\n");
+            fprintf(f, "js,%u,%u,%llu\n", cards, widgets, (unsigned long long)(js_us != UINT64_MAX ? js_us : 0));
+            fprintf(f, "ui_load,%u,%u,%llu\n", cards, widgets, (unsigned long long)(ui_us != UINT64_MAX ? ui_us : 0));
+            fclose(f);
+        }
+    }
+    if (config->json_path != NULL) {
+        FILE* f = fopen(config->json_path, "w");
+        if (f == NULL) {
+            printf("[bench] cannot write %s\n", config->json_path);
+        }
+        else {
+            fprintf(f, "{\n  \"cards\": %u,\n  \"widgets\": %u,\n  \"ui_bytes\": %u,\n"
+                "  \"js_us\": %llu,\n  \"ui_load_us\": %llu,\n  \"speedup\": %.2f\n}\n",
+                cards, widgets, (unsigned)ui_size, (unsigned long long)(js_us != UINT64_MAX ? js_us : 0),
+                (unsigned long long)(ui_us != UINT64_MAX ? ui_us : 0), speedup);
+            fclose(f);
+        }
+    }
+    return failures;
+}
@@ -0,0 +1,180 @@
+﻿/**
+ * @file appsys_buf.c
+ * @brief 二进制缓冲区读写实现
+ * @author Sab1e
+ * @date 2025-08-10
+ *
+ * 整数使用 LEB128 变长编码，有符号数先做 zigzag 变换，小数值只占 1 个字节。
+ * 字符串编码为 “变长长度 + 内容 + '\0'”，读取时可以直接返回指向缓冲区的指针。
+ */
+
+#include "appsys_buf.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 初始化写缓冲区
+ */
+void appsys_buf_init(AppSysBuf_t* buf) {
+    buf->data = NULL;
+    buf->len = 0;
+    buf->cap = 0;
+    buf->oom = false;
+}
+
+/**
+ * @brief 释放写缓冲区
+ */
+void appsys_buf_free(AppSysBuf_t* buf) {
+    free(buf->data);
+    appsys_buf_init(buf);
+}
+
+/**
+ * @brief 在末尾预留 len 个字节
+ * @return uint8_t* 预留区域的起始地址，分配失败时返回 NULL
+ */
+uint8_t* appsys_buf_reserve(AppSysBuf_t* buf, size_t len) {
+    if (buf->oom) {
+        return NULL;
+    }
+    if (buf->len + len > buf->cap) {
+        size_t cap = buf->cap == 0 ? 256 : buf->cap;
+        while (cap < buf->len + len) {
+            cap *= 2;
+        }
+        uint8_t* p = (uint8_t*)realloc(buf->data, cap);
+        if (p == NULL) {
+            buf->oom = true;
+            return NULL;
+        }
+        buf->data = p;
+        buf->cap = cap;
+    }
+    uint8_t* dst = buf->data + buf->len;
+    buf->len += len;
+    return dst;
+}
+
+/**
+ * @brief 追加任意字节
+ */
+void appsys_buf_put(AppSysBuf_t* buf, const void* data, size_t len) {
+    uint8_t* dst = appsys_buf_reserve(buf, len);
+    if (dst != NULL && len > 0) {
+        memcpy(dst, data, len);
+    }
+}
+
+void appsys_buf_put_u8(AppSysBuf_t* buf, uint8_t v) {
+    appsys_buf_put(buf, &v, 1);
+}
+
+/**
+ * @brief 追加小端 32 位整数（定长，用于需要回填的字段）
+ */
+void appsys_buf_put_u32(AppSysBuf_t* buf, uint32_t v) {
+    uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    appsys_buf_put(buf, b, 4);
+}
+
+void appsys_buf_put_varint(AppSysBuf_t* buf, uint32_t v) {
+    uint8_t b[5];
+    size_t n = 0;
+    do {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;
+        b[n++] = v ? (byte | 0x80) : byte;
+    } while (v);
+    appsys_buf_put(buf, b, n);
+}
+
+void appsys_buf_put_svarint(AppSysBuf_t* buf, int32_t v) {
+    appsys_buf_put_varint(buf, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+/**
+ * @brief 追加字符串，NULL 按空字符串处理
+ */
+void appsys_buf_put_str(AppSysBuf_t* buf, const char* str) {
+    size_t len = str == NULL ? 0 : strlen(str);
+    appsys_buf_put_varint(buf, (uint32_t)len);
+    appsys_buf_put(buf, str == NULL ? "" : str, len);
+    appsys_buf_put_u8(buf, 0);
+}
+
+/**
+ * @brief 初始化只读游标
+ */
+void appsys_reader_init(AppSysReader_t* rd, const uint8_t* data, size_t len) {
+    rd->data = data;
+    rd->len = len;
+    rd->pos = 0;
+    rd->error = false;
+}
+
+/**
+ * @brief 读取 len 个字节
+ * @return const uint8_t* 指向缓冲区内部，越界时返回 NULL
+ */
+const uint8_t* appsys_reader_get(AppSysReader_t* rd, size_t len) {
+    if (rd->error || rd->len - rd->pos < len) {
+        rd->error = true;
+        return NULL;
+    }
+    const uint8_t* p = rd->data + rd->pos;
+    rd->pos += len;
+    return p;
+}
+
+uint8_t appsys_reader_u8(AppSysReader_t* rd) {
+    const uint8_t* p = appsys_reader_get(rd, 1);
+    return p == NULL ? 0 : p[0];
+}
+
+uint32_t appsys_reader_u32(AppSysReader_t* rd) {
+    const uint8_t* p = appsys_reader_get(rd, 4);
+    if (p == NULL) {
+        return 0;
+    }
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint32_t appsys_reader_varint(AppSysReader_t* rd) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = appsys_reader_u8(rd);
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return v;
+        }
+    }
+    rd->error = true;
+    return 0;
+}
+
+int32_t appsys_reader_svarint(AppSysReader_t* rd) {
+    uint32_t v = appsys_reader_varint(rd);
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/**
+ * @brief 读取字符串
+ * @param len 输出字符串长度（不含 '\0'），可为 NULL
+ * @return const char* 指向缓冲区内部、以 '\0' 结尾；出错时返回 ""
+ */
+const char* appsys_reader_str(AppSysReader_t* rd, uint32_t* len) {
+    uint32_t n = appsys_reader_varint(rd);
+    const uint8_t* p = appsys_reader_get(rd, (size_t)n + 1);
+    if (p == NULL || p[n] != 0) {
+        rd->error = true;
+        if (len != NULL) {
+            *len = 0;
+        }
+        return "";
+    }
+    if (len != NULL) {
+        *len = n;
+    }
+    return (const char*)p;
+}
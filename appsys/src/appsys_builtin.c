@@ -0,0 +1,67 @@
+﻿/**
+ * @file appsys_builtin.c
+ * @brief 内置应用实现
+ * @author Sab1e
+ * @date 2025-08-14
+ *
+ * 内置应用的 main.js 在构建期由 appsys/tools/gen_builtin.py 编译为静态快照。
+ * 静态快照中的字符串全部引用 magic string 表，执行时既不复制字节码也不创建字面量，
+ * 启动一个内置应用不再为其字节码分配任何 RAM。
+ */
+
+#include "appsys_builtin.h"
+#include <string.h>
+
+/**
+ * @brief 注册内置应用共用的 magic string 表，每次 jerry_init 之后调用
+ */
+void appsys_builtin_init(void) {
+    if (appsys_builtin_magic_string_count > 0) {
+        jerry_register_magic_strings(appsys_builtin_magic_strings,
+            appsys_builtin_magic_string_count, appsys_builtin_magic_string_lengths);
+    }
+}
+
+/**
+ * @brief 获取内置应用数量
+ */
+uint32_t appsys_builtin_get_count(void) {
+    return appsys_builtin_app_count;
+}
+
+/**
+ * @brief 按序号获取内置应用
+ * @return const ApplicationPackage_t* 越界时返回 NULL
+ */
+const ApplicationPackage_t* appsys_builtin_get(uint32_t index) {
+    return index < appsys_builtin_app_count ? &appsys_builtin_apps[index] : NULL;
+}
+
+/**
+ * @brief 按应用 ID 查找内置应用
+ * @return const ApplicationPackage_t* 未找到时返回 NULL
+ */
+const ApplicationPackage_t* appsys_builtin_find(const char* app_id) {
+    if (app_id == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < appsys_builtin_app_count; i++) {
+        if (strcmp(appsys_builtin_apps[i].app_id, app_id) == 0) {
+            return &appsys_builtin_apps[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 按应用 ID 启动内置应用
+ * @param app_id 应用 ID
+ * @return AppRunResult_t 不是内置应用时返回 APP_ERR_NOT_FOUND
+ */
+AppRunResult_t appsys_run_builtin(const char* app_id) {
+    const ApplicationPackage_t* app = appsys_builtin_find(app_id);
+    if (app == NULL) {
+        return APP_ERR_NOT_FOUND;
+    }
+    return appsys_run_app(app);
+}
@@ -0,0 +1,21 @@
+﻿/**
+ * @file appsys_builtin_data.c
+ * @brief 内置应用静态快照，由 appsys/tools/gen_builtin.py 从 appsys/builtin 生成，请勿手动修改
+ */
+
+#include "appsys_builtin.h"
+
+/********************************** magic string **********************************/
+
+const jerry_char_t* const appsys_builtin_magic_strings[] = { NULL };
+const jerry_length_t appsys_builtin_magic_string_lengths[] = { 0 };
+const uint32_t appsys_builtin_magic_string_count = 0;
+
+/********************************** 静态快照 **********************************/
+
+/********************************** 内置应用表 **********************************/
+
+const ApplicationPackage_t appsys_builtin_apps[] = {
+    { 0 },
+};
+const uint32_t appsys_builtin_app_count = 0;
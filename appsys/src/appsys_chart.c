@@ -0,0 +1,306 @@
+﻿/**
+ * @file appsys_chart.c
+ * @brief 图表批量追加实现
+ * @author Sab1e
+ * @date 2025-08-22
+ *
+ * lv_chart 的每条数据系列本身就是一个以 start_point 为起点的环形数组，逐点调用
+ * lv_chart_set_next_value 时每个点都要跨一次 JS/原生边界，并在滚动模式下各自使整个图表失效。
+ * 这里一次写入一批点，只推进一次起点、只失效一次：
+ *
+ *   chart_ring(chart, 100, true);                 // 100 个点，循环（扫描）模式
+ *   let ser = lv_chart_add_series(chart, color, LV_CHART_AXIS_PRIMARY_Y);
+ *   chart_append(chart, ser, samples);            // samples 为 Int32Array / Int16Array / Float32Array / 数组 / 数字
+ *
+ * 滚动模式（LV_CHART_UPDATE_MODE_SHIFT）下所有点都会移动，整个图表失效一次；
+ * 循环模式（LV_CHART_UPDATE_MODE_CIRCULAR）下只失效新写入的点及相邻线段所在的列。
+ * 更新模式由 chart_ring 记录（LVGL 没有提供读取接口），未调用 chart_ring 的图表按默认的滚动模式处理。
+ */
+
+#include "appsys_chart.h"
+#include "appsys_core.h"
+#include "appsys_js_utils.h"
+#include "utlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 使用循环模式的图表
+ */
+typedef struct AppSysChartRing {
+    lv_obj_t* chart;
+    struct AppSysChartRing* next;
+} AppSysChartRing_t;
+
+static AppSysChartRing_t* chart_rings = NULL;
+
+/**
+ * @brief 图表是否处于循环模式
+ */
+static AppSysChartRing_t* appsys_chart_find_ring(lv_obj_t* chart) {
+    AppSysChartRing_t* ring;
+    LL_FOREACH(chart_rings, ring) {
+        if (ring->chart == chart) {
+            return ring;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 图表删除时移除记录
+ */
+static void appsys_chart_delete_cb(lv_event_t* e) {
+    AppSysChartRing_t* ring = (AppSysChartRing_t*)lv_event_get_user_data(e);
+    LL_DELETE(chart_rings, ring);
+    free(ring);
+}
+
+/**
+ * @brief 设置图表点数与更新模式
+ * @param circular true 为循环（扫描）模式，false 为滚动模式
+ */
+static void appsys_chart_set_ring(lv_obj_t* chart, uint32_t point_count, bool circular) {
+    lv_chart_set_point_count(chart, point_count);
+    lv_chart_set_update_mode(chart, circular ? LV_CHART_UPDATE_MODE_CIRCULAR : LV_CHART_UPDATE_MODE_SHIFT);
+    AppSysChartRing_t* ring = appsys_chart_find_ring(chart);
+    if (circular && ring == NULL) {
+        ring = (AppSysChartRing_t*)calloc(1, sizeof(AppSysChartRing_t));
+        if (ring != NULL) {
+            ring->chart = chart;
+            LL_PREPEND(chart_rings, ring);
+            lv_obj_add_event_cb(chart, appsys_chart_delete_cb, LV_EVENT_DELETE, ring);
+        }
+    }
+    else if (!circular && ring != NULL) {
+        lv_obj_remove_event_cb_with_user_data(chart, appsys_chart_delete_cb, ring);
+        LL_DELETE(chart_rings, ring);
+        free(ring);
+    }
+}
+
+/**
+ * @brief 使 [first, last] 范围内的点及其两侧线段所在的列失效
+ */
+static void appsys_chart_invalidate_points(lv_obj_t* chart, lv_chart_series_t* ser,
+    uint32_t first, uint32_t last, uint32_t point_count) {
+    lv_point_t left;
+    lv_point_t right;
+    lv_chart_get_point_pos_by_id(chart, ser, first > 0 ? first - 1 : first, &left);
+    lv_chart_get_point_pos_by_id(chart, ser, last + 1 < point_count ? last + 1 : last, &right);
+
+    // 线宽与点的尺寸决定绘制超出坐标的范围
+    int32_t margin = lv_obj_get_style_line_width(chart, LV_PART_ITEMS)
+        + lv_obj_get_style_width(chart, LV_PART_INDICATOR) / 2 + 1;
+    lv_area_t coords;
+    lv_obj_get_coords(chart, &coords);
+    lv_area_t area;
+    area.x1 = coords.x1 + left.x - margin;
+    area.x2 = coords.x1 + right.x + margin;
+    area.y1 = coords.y1;
+    area.y2 = coords.y2;
+    lv_obj_invalidate_area(chart, &area);
+}
+
+/**
+ * @brief 向数据系列追加一批点
+ * @param chart 图表
+ * @param ser 数据系列
+ * @param values 数据，超过点数时只保留最后的点
+ * @param count 数据个数
+ * @return uint32_t 实际写入的点数
+ */
+uint32_t appsys_chart_append(lv_obj_t* chart, lv_chart_series_t* ser, const int32_t* values, uint32_t count) {
+    uint32_t point_count = lv_chart_get_point_count(chart);
+    int32_t* y = lv_chart_get_y_array(chart, ser);
+    if (point_count == 0 || y == NULL || count == 0) {
+        return 0;
+    }
+    if (count > point_count) {
+        values += count - point_count;
+        count = point_count;
+    }
+
+    uint32_t first = lv_chart_get_x_start_point(chart, ser);
+    // 一次写满到数组末尾，再从头写剩余部分
+    uint32_t head = LV_MIN(count, point_count - first);
+    memcpy(y + first, values, head * sizeof(int32_t));
+    memcpy(y, values + head, (count - head) * sizeof(int32_t));
+    uint32_t next = (first + count) % point_count;
+    lv_chart_set_x_start_point(chart, ser, next);
+
+    if (appsys_chart_find_ring(chart) == NULL || lv_chart_get_type(chart) != LV_CHART_TYPE_LINE
+        || count == point_count) {
+        lv_obj_invalidate(chart);
+    }
+    else {
+        // 新写入的点之后紧接着的点（最旧的点）与新点之间的线段也会变化，一并包含
+        uint32_t last = first + count;
+        if (last < point_count) {
+            appsys_chart_invalidate_points(chart, ser, first, last, point_count);
+        }
+        else {
+            appsys_chart_invalidate_points(chart, ser, first, point_count - 1, point_count);
+            appsys_chart_invalidate_points(chart, ser, 0, last - point_count, point_count);
+        }
+    }
+    return count;
+}
+
+/********************************** JS 接口 **********************************/
+
+/**
+ * @brief 把 JS 数据转换为 int32 数组
+ * @param value 数字、数组或 TypedArray
+ * @param local 调用者提供的缓冲区，数据不超过 local_count 时使用
+ * @param count 输出数据个数
+ * @param owned 输出结果是否为新分配的内存，为 true 时调用者负责 free
+ * @return int32_t* 数据，无法转换时返回 NULL
+ */
+static int32_t* appsys_chart_get_values(jerry_value_t value, int32_t* local, uint32_t local_count,
+    uint32_t* count, bool* owned) {
+    *count = 0;
+    *owned = false;
+    if (jerry_value_is_number(value)) {
+        local[0] = (int32_t)jerry_value_as_int32(value);
+        *count = 1;
+        return local;
+    }
+
+    uint32_t length;
+    const uint8_t* data = NULL;
+    jerry_typedarray_type_t type = JERRY_TYPEDARRAY_INVALID;
+    if (jerry_value_is_typedarray(value)) {
+        jerry_length_t offset = 0;
+        jerry_length_t byte_length = 0;
+        jerry_value_t buffer = jerry_typedarray_buffer(value, &offset, &byte_length);
+        data = jerry_arraybuffer_data(buffer);
+        jerry_value_free(buffer);
+        if (data == NULL) {
+            return NULL;
+        }
+        data += offset;
+        type = jerry_typedarray_type(value);
+        length = jerry_typedarray_length(value);
+        if (type == JERRY_TYPEDARRAY_INT32) {
+            // 直接使用 TypedArray 的存储，不复制
+            *count = length;
+            return (int32_t*)data;
+        }
+    }
+    else if (jerry_value_is_array(value)) {
+        length = jerry_array_length(value);
+    }
+    else {
+        return NULL;
+    }
+
+    int32_t* out = length > local_count ? (int32_t*)malloc(length * sizeof(int32_t)) : local;
+    if (out == NULL) {
+        return NULL;
+    }
+    *owned = out != local;
+    for (uint32_t i = 0; i < length; i++) {
+        switch (type) {
+        case JERRY_TYPEDARRAY_UINT8:
+        case JERRY_TYPEDARRAY_UINT8CLAMPED:
+            out[i] = data[i];
+            break;
+        case JERRY_TYPEDARRAY_INT8:
+            out[i] = ((const int8_t*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_INT16:
+            out[i] = ((const int16_t*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_UINT16:
+            out[i] = ((const uint16_t*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_UINT32:
+            out[i] = (int32_t)((const uint32_t*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_FLOAT32:
+            out[i] = (int32_t)((const float*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_FLOAT64:
+            out[i] = (int32_t)((const double*)data)[i];
+            break;
+        case JERRY_TYPEDARRAY_INVALID: {
+            jerry_value_t item = jerry_object_get_index(value, i);
+            out[i] = jerry_value_is_number(item) ? (int32_t)jerry_value_as_int32(item) : LV_CHART_POINT_NONE;
+            jerry_value_free(item);
+            break;
+        }
+        default:
+            out[i] = 0;
+            break;
+        }
+    }
+    *count = length;
+    return out;
+}
+
+/**
+ * @brief chart_ring(chart, point_count[, circular]) 设置点数与更新模式
+ */
+static jerry_value_t js_chart_ring(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* chart = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    int32_t point_count = appsys_js_get_int(args_p, args_count, 1, 0);
+    if (chart == NULL || !lv_obj_check_type(chart, &lv_chart_class) || point_count <= 0) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "chart_ring: expected (chart, point_count[, circular])");
+    }
+    bool circular = args_count > 2 && jerry_value_to_boolean(args_p[2]);
+    appsys_chart_set_ring(chart, (uint32_t)point_count, circular);
+    return jerry_undefined();
+}
+
+/**
+ * @brief chart_append(chart, series, values) 追加一批点，返回写入的点数
+ */
+static jerry_value_t js_chart_append(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* chart = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    lv_chart_series_t* ser = args_count > 1 ? (lv_chart_series_t*)appsys_js_get_ptr(args_p[1]) : NULL;
+    if (chart == NULL || ser == NULL || args_count < 3 || !lv_obj_check_type(chart, &lv_chart_class)) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "chart_append: expected (chart, series, values)");
+    }
+    int32_t local[32];
+    uint32_t count = 0;
+    bool owned = false;
+    int32_t* values = appsys_chart_get_values(args_p[2], local, sizeof(local) / sizeof(local[0]), &count, &owned);
+    if (values == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "chart_append: values must be a number, array or TypedArray");
+    }
+    uint32_t written = appsys_chart_append(chart, ser, values, count);
+    if (owned) {
+        free(values);
+    }
+    return jerry_number((double)written);
+}
+
+/**
+ * @brief 图表原生函数列表
+ */
+static const AppSysFuncEntry appsys_chart_funcs[] = {
+    {
+        .name = "chart_ring",
+        .handler = js_chart_ring
+    },
+    {
+        .name = "chart_append",
+        .handler = js_chart_append
+    },
+};
+
+/**
+ * @brief 将图表函数注册到当前 realm
+ */
+void appsys_chart_register_natives(void) {
+    appsys_register_functions(appsys_chart_funcs, sizeof(appsys_chart_funcs) / sizeof(AppSysFuncEntry));
+}
@@ -12,9 +12,52 @@
 #include "lv_bindings.h"
 #include "lv_bindings_misc.h"
 #include "appsys_port.h"
+#include "appsys_js_utils.h"
+#include "appsys_event.h"
+#include "appsys_timer.h"
+#include "appsys_hibernate.h"
+#include "appsys_watchdog.h"
+#include "appsys_prewarm.h"
+#include "appsys_stdlib.h"
+#include "appsys_builtin.h"
+#include "appsys_module.h"
+#include "appsys_lazy.h"
+#include "appsys_anim.h"
+#include "appsys_timeline.h"
+#include "appsys_ui.h"
+#include "appsys_subject.h"
+#include "appsys_str.h"
+#include "appsys_chart.h"
+#include "appsys_golden.h"
+#include "appsys_mem.h"
+#include "appsys_conf.h"
+#include <string.h>
+
+/**
+ * @brief 驻留应用槽位
+ */
+typedef struct {
+    const ApplicationPackage_t* package;   // 应用包（驻留期间必须保持有效）
+    jerry_value_t realm;                   // 应用独占的 realm
+    lv_obj_t* screen;                      // 应用独占的屏幕
+    AppState_t state;
+    uint32_t last_active;                  // 最近一次转入前台的时间，用于淘汰
+    bool terminate_pending;                // 已请求终止，等待调用栈退出后释放
+} AppSlot_t;
 
 // 全局状态记录是否已初始化 VM
 static bool js_vm_initialized = false;
+// 驻留应用表，所有应用共享同一个 VM，各自运行在独立的 realm 中
+static AppSlot_t app_slots[APPSYS_MAX_RESIDENT_APPS];
+// 前台应用
+static AppSlot_t* foreground_slot = NULL;
+// 没有前台应用时显示的系统屏幕
+static lv_obj_t* home_screen = NULL;
+// 已休眠到磁盘的应用，按休眠先后排列
+static const ApplicationPackage_t* hibernated_apps[APPSYS_MAX_HIBERNATED_APPS];
+// 是否已在 lv_layer_top()/lv_layer_sys() 上监听子控件创建
+static bool layer_tracking = false;
+
 /**
  * @brief 注册C函数到JS
  * @param entry 函数入口数组
@@ -32,16 +75,65 @@ void appsys_register_functions(const AppSysFuncEntry* entry,const size_t funcs_c
     jerry_value_free(global);
 }
 /**
- * @brief appsys_clear_current_app 清除当前运行的 JS 应用
+ * @brief appsys_report_exception 打印 JS 异常信息
+ * @param result jerry_eval / jerry_call 返回的异常值（不会被释放）
+ */
+void appsys_report_exception(jerry_value_t result) {
+    printf("JS Error: ");
+    jerry_value_t value = jerry_exception_value(result, false);
+    jerry_char_t str_buf_p[256];
+
+    /* Determining required buffer size */
+    jerry_size_t req_sz = jerry_string_size(value, JERRY_ENCODING_CESU8);
+
+    if (req_sz <= 255)
+    {
+        jerry_string_to_buffer(value, JERRY_ENCODING_CESU8, str_buf_p, req_sz);
+        str_buf_p[req_sz] = '\0';
+        printf("%s", (const char*)str_buf_p);
+    }
+    else
+    {
+        printf("error: buffer isn't big enough");
+    }
+    printf("\n");
+    jerry_value_free(value);
+}
+/**
+ * @brief appsys_vm_init 按需初始化共享的 JerryScript VM（启动预热时也会提前调用）
+ */
+void appsys_vm_init(void) {
+    if (js_vm_initialized) {
+        return;
+    }
+    jerry_init(JERRY_INIT_EMPTY);
+    appsys_builtin_init();
+    appsys_js_utils_init();
+    appsys_event_init();
+    appsys_watchdog_init();
+    js_vm_initialized = true;
+}
+/**
+ * @brief appsys_vm_deinit 所有应用退出后销毁 VM
  */
-static void appsys_clear_current_app() {
+static void appsys_vm_deinit() {
     if (js_vm_initialized) {
+        // 先释放原生侧持有的 JS 值，再销毁 VM
+        appsys_watchdog_deinit();
+        appsys_module_deinit();
+        appsys_timeline_deinit();
+        appsys_ui_deinit();
+        appsys_subject_deinit();
+        appsys_str_deinit();
+        appsys_timer_deinit();
+        appsys_event_deinit();
+        appsys_js_utils_deinit();
         jerry_cleanup();
         js_vm_initialized = false;
     }
 }
 /**
- * @brief appsys_create_app_info 把 ApplicationPackage_t 转换成 JS 对象（供 JS 访问 app_info）
+ * @brief appsys_create_app_info 把 ApplicationPackage_t 转换成 JS 对象（供 JS 访问 app_info），属性只读
  * @param ApplicationPackage_t 结构体
  * @return jerry_value_t 返回值说明
  */
@@ -53,7 +145,7 @@ jerry_value_t appsys_create_app_info(const ApplicationPackage_t* app) {
 #define SET_PROP(field) \
         key = jerry_string_sz((const jerry_char_t*)#field); \
         val = jerry_string_sz((const jerry_char_t*)app->field); \
-        jerry_object_set(obj, key, val); \
+        appsys_js_define_const(obj, key, val); \
         jerry_value_free(key); \
         jerry_value_free(val);
 
@@ -67,71 +159,612 @@ jerry_value_t appsys_create_app_info(const ApplicationPackage_t* app) {
 }
 
 /**
- * @brief appsys_run_app 运行指定应用，如果当前已有应用在运行则自动清除
- * @param ApplicationPackage_t 应用包结构体
- * @return AppRunResult_t 返回运行结果枚举
+ * @brief appsys_find_slot 按应用 ID 查找驻留槽位
+ * @param app_id 应用 ID
+ * @return AppSlot_t* 未驻留时返回 NULL
  */
-AppRunResult_t appsys_run_app(const ApplicationPackage_t* app) {
-    if (app == NULL || app->mainjs_str == NULL) {
-        return APP_ERR_NULL_PACKAGE;
+static AppSlot_t* appsys_find_slot(const char* app_id) {
+    if (app_id == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        if (app_slots[i].state != APP_STATE_NONE && strcmp(app_slots[i].package->app_id, app_id) == 0) {
+            return &app_slots[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief appsys_find_slot_by_realm 按 realm 查找驻留槽位
+ * @param realm realm 对象
+ * @return AppSlot_t* 未找到时返回 NULL
+ */
+static AppSlot_t* appsys_find_slot_by_realm(jerry_value_t realm) {
+    for (int i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        if (app_slots[i].state != APP_STATE_NONE && app_slots[i].realm == realm) {
+            return &app_slots[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief appsys_find_hibernated 按应用 ID 查找休眠记录
+ * @param app_id 应用 ID
+ * @return int 下标，未休眠时返回 -1
+ */
+static int appsys_find_hibernated(const char* app_id) {
+    if (app_id == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < APPSYS_MAX_HIBERNATED_APPS; i++) {
+        if (hibernated_apps[i] != NULL && strcmp(hibernated_apps[i]->app_id, app_id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+/**
+ * @brief appsys_remove_hibernated 移除休眠记录
+ * @param index 下标
+ * @param discard 是否同时删除休眠文件
+ */
+static void appsys_remove_hibernated(int index, bool discard) {
+    if (discard) {
+        appsys_hibernate_discard(hibernated_apps[index]->app_id);
+    }
+    for (int i = index; i < APPSYS_MAX_HIBERNATED_APPS - 1; i++) {
+        hibernated_apps[i] = hibernated_apps[i + 1];
     }
-    // 清除前一个 JS 应用
-    appsys_clear_current_app();
+    hibernated_apps[APPSYS_MAX_HIBERNATED_APPS - 1] = NULL;
+}
+/**
+ * @brief appsys_add_hibernated 添加休眠记录，已满时丢弃最早的休眠应用
+ * @param app 应用包
+ */
+static void appsys_add_hibernated(const ApplicationPackage_t* app) {
+    if (hibernated_apps[APPSYS_MAX_HIBERNATED_APPS - 1] != NULL) {
+        appsys_remove_hibernated(0, true);
+    }
+    for (int i = 0; i < APPSYS_MAX_HIBERNATED_APPS; i++) {
+        if (hibernated_apps[i] == NULL) {
+            hibernated_apps[i] = app;
+            return;
+        }
+    }
+}
+/**
+ * @brief appsys_call_hook 调用应用中定义的全局生命周期函数（如 on_suspend），未定义时忽略
+ * @param slot 应用槽位
+ * @param name 函数名
+ */
+static void appsys_call_hook(AppSlot_t* slot, const char* name) {
+    jerry_value_t prev_realm = jerry_set_realm(slot->realm);
+    jerry_value_t global = jerry_current_realm();
+    jerry_value_t key = jerry_string_sz(name);
+    jerry_value_t func = jerry_object_get(global, key);
+    if (jerry_value_is_function(func)) {
+        jerry_value_free(appsys_event_call(func, global, NULL, 0));
+    }
+    jerry_value_free(func);
+    jerry_value_free(key);
+    jerry_value_free(global);
+    jerry_set_realm(prev_realm);
+}
+/**
+ * @brief appsys_suspend_slot 把前台应用转入后台：冻结定时器、脱离显示，可选压缩堆
+ * @param slot 应用槽位
+ */
+static void appsys_suspend_slot(AppSlot_t* slot) {
+    if (slot->state != APP_STATE_FOREGROUND) {
+        return;
+    }
+    appsys_call_hook(slot, "on_suspend");
+    appsys_timer_pause_realm(slot->realm);
+    appsys_timeline_pause_realm(slot->realm);
+    slot->state = APP_STATE_SUSPENDED;
+    if (foreground_slot == slot) {
+        foreground_slot = NULL;
+    }
+#if APPSYS_SUSPEND_GC
+    jerry_heap_gc(JERRY_GC_PRESSURE_HIGH);
+#endif
+}
+/**
+ * @brief appsys_resume_slot 把后台应用切回前台
+ * @param slot 应用槽位
+ */
+static void appsys_resume_slot(AppSlot_t* slot) {
+    if (foreground_slot != NULL && foreground_slot != slot) {
+        appsys_suspend_slot(foreground_slot);
+    }
+    bool was_suspended = slot->state == APP_STATE_SUSPENDED;
+    lv_screen_load(slot->screen);
+    slot->last_active = lv_tick_get();
+    slot->state = APP_STATE_FOREGROUND;
+    foreground_slot = slot;
+    if (was_suspended) {
+        appsys_timer_resume_realm(slot->realm);
+        appsys_timeline_resume_realm(slot->realm);
+        appsys_call_hook(slot, "on_resume");
+    }
+}
+/**
+ * @brief appsys_layer_owner_cb 挂在应用创建的顶层/系统层控件上，只用来标记所属槽位（user_data）
+ * @param e 事件
+ */
+static void appsys_layer_owner_cb(lv_event_t* e) {
+    (void)e;
+}
+/**
+ * @brief appsys_layer_child_created_cb 在顶层/系统层上创建控件时，按当前 realm 标记其所属应用
+ * @param e LV_EVENT_CHILD_CREATED 事件，参数为新控件
+ */
+static void appsys_layer_child_created_cb(lv_event_t* e) {
+    if (!js_vm_initialized) {
+        return;
+    }
+    lv_obj_t* child = lv_event_get_param(e);
+    jerry_value_t realm = jerry_current_realm();
+    AppSlot_t* slot = appsys_find_slot_by_realm(realm);
+    jerry_value_free(realm);
+    if (child != NULL && slot != NULL) {
+        lv_obj_add_event_cb(child, appsys_layer_owner_cb, LV_EVENT_DELETE, slot);
+    }
+}
+/**
+ * @brief appsys_track_layers 开始记录应用在顶层/系统层上创建的控件，这些控件不在应用屏幕下，
+ *        需要在应用退出时单独删除
+ */
+static void appsys_track_layers(void) {
+    if (layer_tracking) {
+        return;
+    }
+    lv_obj_add_event_cb(lv_layer_top(), appsys_layer_child_created_cb, LV_EVENT_CHILD_CREATED, NULL);
+    lv_obj_add_event_cb(lv_layer_sys(), appsys_layer_child_created_cb, LV_EVENT_CHILD_CREATED, NULL);
+    layer_tracking = true;
+}
+/**
+ * @brief appsys_delete_layer_objs 删除应用在指定层上创建的控件
+ * @param layer lv_layer_top() 或 lv_layer_sys()
+ * @param slot 应用槽位
+ */
+static void appsys_delete_layer_objs(lv_obj_t* layer, AppSlot_t* slot) {
+    for (int32_t i = (int32_t)lv_obj_get_child_count(layer) - 1; i >= 0; i--) {
+        lv_obj_t* child = lv_obj_get_child(layer, i);
+        uint32_t count = lv_obj_get_event_count(child);
+        for (uint32_t j = 0; j < count; j++) {
+            lv_event_dsc_t* dsc = lv_obj_get_event_dsc(child, j);
+            if (lv_event_dsc_get_cb(dsc) == appsys_layer_owner_cb && lv_event_dsc_get_user_data(dsc) == slot) {
+                lv_obj_delete(child);
+                break;
+            }
+        }
+    }
+}
+/**
+ * @brief appsys_free_slot 关闭应用并释放其 realm、屏幕、顶层/系统层控件和定时器
+ * @param slot 应用槽位
+ */
+static void appsys_free_slot(AppSlot_t* slot) {
+    if (slot->state == APP_STATE_NONE) {
+        return;
+    }
+    if (foreground_slot == slot) {
+        foreground_slot = NULL;
+        if (home_screen != NULL) {
+            lv_screen_load(home_screen);
+        }
+    }
+    appsys_timer_free_realm(slot->realm);
+    appsys_timeline_free_realm(slot->realm);
+    appsys_subject_free_realm(slot->realm);
+    appsys_module_free_realm(slot->realm);
+    // 删除屏幕时会触发 LV_EVENT_DELETE，事件模块随之释放该应用的 JS 回调
+    if (slot->screen != NULL) {
+        lv_obj_delete(slot->screen);
+    }
+    if (layer_tracking) {
+        appsys_delete_layer_objs(lv_layer_top(), slot);
+        appsys_delete_layer_objs(lv_layer_sys(), slot);
+    }
+    jerry_value_free(slot->realm);
+    memset(slot, 0, sizeof(AppSlot_t));
 
-    // 初始化 JerryScript VM
-    jerry_init(JERRY_INIT_EMPTY);
-    js_vm_initialized = true;
+    for (int i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        if (app_slots[i].state != APP_STATE_NONE) {
+            jerry_heap_gc(JERRY_GC_PRESSURE_HIGH);
+            return;
+        }
+    }
+    appsys_vm_deinit();
+}
+/**
+ * @brief appsys_hibernate_slot 把应用声明的状态与屏幕树写入磁盘后释放其全部资源
+ * @param slot 应用槽位
+ * @return bool 写入成功；失败时应用保持驻留
+ */
+static bool appsys_hibernate_slot(AppSlot_t* slot) {
+    const ApplicationPackage_t* app = slot->package;
+    AppSysHibernateStats_t stats;
+
+    if (slot->state == APP_STATE_FOREGROUND) {
+        appsys_suspend_slot(slot);
+        if (home_screen != NULL) {
+            lv_screen_load(home_screen);
+        }
+    }
+    if (!appsys_hibernate_save(app->app_id, slot->realm, slot->screen, &stats)) {
+        return false;
+    }
+#if APPSYS_LAUNCH_TRACE
+    printf("[hibernate] %s: blob=%u B (state=%u B, %u widgets) in %u us\n",
+        app->app_id, stats.blob_size, stats.state_size, stats.tree_nodes, stats.elapsed_us);
+#endif
 
+    appsys_free_slot(slot);
+    appsys_add_hibernated(app);
+    return true;
+}
+/**
+ * @brief appsys_alloc_slot 分配空闲槽位，已满时关闭最久未使用的后台应用
+ * @return AppSlot_t* 空闲槽位
+ */
+static AppSlot_t* appsys_alloc_slot() {
+    AppSlot_t* victim = NULL;
+    for (int i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        AppSlot_t* slot = &app_slots[i];
+        if (slot->state == APP_STATE_NONE) {
+            return slot;
+        }
+        if (slot != foreground_slot && (victim == NULL || slot->last_active < victim->last_active)) {
+            victim = slot;
+        }
+    }
+    // 只能驻留一个应用时，新应用替换当前前台应用
+    if (victim == NULL) {
+        victim = foreground_slot;
+    }
+    printf("appsys: evicting %s\n", victim->package->app_id);
+#if APPSYS_HIBERNATE_ON_EVICT
+    // 淘汰后台应用时先休眠，重新打开时可以恢复状态
+    if (victim != foreground_slot && appsys_hibernate_slot(victim)) {
+        return victim;
+    }
+#endif
+    appsys_free_slot(victim);
+    return victim;
+}
+/**
+ * @brief appsys_setup_realm 在当前 realm 中注册原生函数、LVGL 绑定与 app_info
+ * @param app 应用包，NULL 表示系统 realm（不设置 app_info）
+ */
+static void appsys_setup_realm(const ApplicationPackage_t* app) {
     // 注册原生函数
     appsys_register_natives();
 
     // 初始化 LVGL 绑定
     lv_binding_init();
+#if APPSYS_FREEZE_LV_CONSTANTS
+    jerry_value_t realm_global = jerry_current_realm();
+    appsys_js_freeze_numbers(realm_global, "LV_");
+    jerry_value_free(realm_global);
+#endif
+
+    // 事件快速分发（覆盖绑定中的事件注册函数）、定时器与休眠状态
+    appsys_event_register_natives();
+    appsys_str_register_natives();
+    appsys_timer_register_natives();
+    appsys_hibernate_register_natives();
+    appsys_lazy_register_natives();
+    appsys_anim_register_natives();
+    appsys_timeline_register_natives();
+    appsys_ui_register_natives();
+    appsys_subject_register_natives();
+    appsys_chart_register_natives();
+    appsys_golden_register_natives();
+    appsys_mem_register_natives();
 
-    // 设置全局 app_info 变量
+    // 系统 JS 库（共享快照，不占用应用堆）
+    appsys_stdlib_load();
+    if (app == NULL) {
+        return;
+    }
+
+    // 设置全局 app_info 常量
     jerry_value_t global = jerry_current_realm();
     jerry_value_t app_info = appsys_create_app_info(app);
 
     jerry_value_t key = jerry_string_sz((const jerry_char_t*)"app_info");
-    jerry_object_set(global, key, app_info);
+    appsys_js_define_const(global, key, app_info);
 
     jerry_value_free(key);
     jerry_value_free(app_info);
     jerry_value_free(global);
+}
+
+/**
+ * @brief appsys_create_system_realm 创建不属于任何应用的系统 realm（系统模块在其中求值）
+ * @return jerry_value_t realm 对象，调用方释放
+ */
+jerry_value_t appsys_create_system_realm(void) {
+    jerry_value_t realm = jerry_realm();
+    jerry_value_t prev_realm = jerry_set_realm(realm);
+    appsys_setup_realm(NULL);
+    jerry_set_realm(prev_realm);
+    return realm;
+}
 
-    // 执行主 JS 脚本
-    jerry_value_t result = jerry_eval(
-        (const jerry_char_t*)app->mainjs_str,
-        strlen(app->mainjs_str),
-        JERRY_PARSE_NO_OPTS
-    );
+/**
+ * @brief appsys_run_app 运行指定应用。应用已驻留时直接切回前台；否则在新的 realm 中启动，
+ *        当前前台应用转入后台挂起
+ * @param ApplicationPackage_t 应用包结构体（驻留期间必须保持有效）
+ * @return AppRunResult_t 返回运行结果枚举
+ */
+AppRunResult_t appsys_run_app(const ApplicationPackage_t* app) {
+    if (app == NULL || (app->mainjs_str == NULL && app->snapshot == NULL) || app->app_id == NULL) {
+        return APP_ERR_NULL_PACKAGE;
+    }
+    if (appsys_find_slot(app->app_id) != NULL) {
+        return appsys_switch_app(app->app_id);
+    }
+    uint64_t start_us = appsys_port_get_time_us();
+    int hibernated = appsys_find_hibernated(app->app_id);
+    if (hibernated >= 0) {
+        appsys_remove_hibernated(hibernated, false);
+    }
 
-    // 检查是否执行成功
-    if (jerry_value_is_exception(result)) {
-        printf("JS Error: ");
-        jerry_value_t value = jerry_exception_value(result, false);
-        jerry_char_t str_buf_p[256];
-
-        /* Determining required buffer size */
-        jerry_size_t req_sz = jerry_string_size(value, JERRY_ENCODING_CESU8);
-
-        if (req_sz <= 255)
-        {
-            jerry_string_to_buffer(value, JERRY_ENCODING_CESU8, str_buf_p, req_sz);
-            str_buf_p[req_sz] = '\0';
-            printf("%s", (const char*)str_buf_p);
+    if (home_screen == NULL) {
+        home_screen = lv_screen_active();
+    }
+    appsys_track_layers();
+
+    // 先分配槽位：淘汰最后一个应用时 VM 会被销毁
+    AppSlot_t* slot = appsys_alloc_slot();
+
+    // 初始化 JerryScript VM（所有应用共享）
+    appsys_vm_init();
+
+    if (foreground_slot != NULL) {
+        appsys_suspend_slot(foreground_slot);
+    }
+
+    slot->package = app;
+    slot->realm = jerry_realm();
+    slot->screen = lv_obj_create(NULL);
+    slot->state = APP_STATE_FOREGROUND;
+    slot->last_active = lv_tick_get();
+    foreground_slot = slot;
+    lv_screen_load(slot->screen);
+
+    // 从休眠中恢复：先原生重建离开时的画面并立即显示，主脚本随后领取这些控件而不是重新创建，
+    // 并通过 app_declare_state 取回休眠前的状态
+    AppSysHibernateStats_t restore_stats;
+    bool restoring = hibernated >= 0
+        && appsys_hibernate_begin_restore(app->app_id, slot->realm, slot->screen, &restore_stats);
+    uint32_t first_frame_us = 0;
+    if (restoring) {
+        lv_refr_now(NULL);
+        first_frame_us = (uint32_t)(appsys_port_get_time_us() - start_us);
+    }
+
+    jerry_value_t prev_realm = jerry_set_realm(slot->realm);
+    appsys_setup_realm(app);
+
+    // 执行主 JS 脚本（内置应用就地执行静态快照，模块应用链接后求值，已预热时执行缓存的快照），
+    // 超出执行预算时由看门狗中断
+    if (!appsys_watchdog_begin()) {
+        // 发起启动的脚本已经超时，不再进入新应用的脚本；休眠文件保留，下次打开仍可恢复
+        jerry_set_realm(prev_realm);
+        if (hibernated >= 0) {
+            appsys_hibernate_end_restore(&restore_stats);
+            appsys_add_hibernated(app);
         }
-        else
-        {
-            printf("error: buffer isn't big enough");
+        appsys_free_slot(slot);
+        return APP_ERR_WATCHDOG_TIMEOUT;
+    }
+    appsys_lazy_begin_startup(app->app_id);
+    jerry_value_t result;
+    bool prewarmed = false;
+    if (app->snapshot != NULL) {
+        result = jerry_exec_snapshot(app->snapshot, app->snapshot_size, 0, JERRY_SNAPSHOT_EXEC_ALLOW_STATIC, NULL);
+    }
+    else if (app->mainjs_is_module) {
+        result = appsys_module_run_main(app);
+    }
+    else {
+        prewarmed = appsys_prewarm_exec(app, &result);
+        if (!prewarmed) {
+            result = jerry_eval(
+                (const jerry_char_t*)app->mainjs_str,
+                strlen(app->mainjs_str),
+                JERRY_PARSE_NO_OPTS
+            );
         }
-        jerry_value_free(value);
+    }
+    bool timed_out = appsys_watchdog_end();
+    appsys_lazy_end_startup();
+    jerry_set_realm(prev_realm);
+
+    if (hibernated >= 0) {
+        appsys_hibernate_end_restore(&restore_stats);
+        appsys_hibernate_discard(app->app_id);
+    }
+#if APPSYS_LAUNCH_TRACE
+    if (restoring) {
+        // 总耗时与冷启动的 [launch] 日志口径一致，可直接对比
+        printf("[restore] %s: blob=%u B (state=%u B), %u/%u widgets adopted, first frame in %u us, interactive in %u us\n",
+            app->app_id, restore_stats.blob_size, restore_stats.state_size, restore_stats.adopted_nodes,
+            restore_stats.tree_nodes, first_frame_us, (uint32_t)(appsys_port_get_time_us() - start_us));
+    }
+    else if (hibernated < 0) {
+        printf("[launch] %s: %u us%s\n", app->app_id, (uint32_t)(appsys_port_get_time_us() - start_us),
+            app->snapshot != NULL ? " (static snapshot)" : prewarmed ? " (prewarmed)"
+            : app->mainjs_is_module ? " (module)" : "");
+    }
+#else
+    (void)start_us;
+    (void)first_frame_us;
+    (void)prewarmed;
+#endif
+
+    // 检查是否执行成功
+    if (jerry_value_is_exception(result)) {
+        appsys_report_exception(result);
         jerry_value_free(result);
-        return APP_ERR_JERRY_EXCEPTION;
+        appsys_free_slot(slot);
+        return timed_out ? APP_ERR_WATCHDOG_TIMEOUT : APP_ERR_JERRY_EXCEPTION;
     }
 
     jerry_value_free(result);
-    jerry_cleanup();
     return APP_SUCCESS;
 }
 
+/**
+ * @brief appsys_switch_app 把已驻留的应用切回前台（已休眠的应用从磁盘恢复），当前前台应用转入后台
+ * @param app_id 应用 ID
+ * @return AppRunResult_t 未驻留时返回 APP_ERR_NOT_FOUND
+ */
+AppRunResult_t appsys_switch_app(const char* app_id) {
+    AppSlot_t* slot = appsys_find_slot(app_id);
+    if (slot == NULL) {
+        int hibernated = appsys_find_hibernated(app_id);
+        return hibernated >= 0 ? appsys_run_app(hibernated_apps[hibernated]) : APP_ERR_NOT_FOUND;
+    }
+    appsys_resume_slot(slot);
+    return APP_SUCCESS;
+}
+
+/**
+ * @brief appsys_suspend_app 把前台应用转入后台并回到系统屏幕
+ * @return AppRunResult_t 没有前台应用时返回 APP_ERR_NOT_FOUND
+ */
+AppRunResult_t appsys_suspend_app(void) {
+    if (foreground_slot == NULL) {
+        return APP_ERR_NOT_FOUND;
+    }
+    appsys_suspend_slot(foreground_slot);
+    if (home_screen != NULL) {
+        lv_screen_load(home_screen);
+    }
+    return APP_SUCCESS;
+}
+
+/**
+ * @brief appsys_kill_app 关闭驻留的应用
+ * @param app_id 应用 ID
+ * @return AppRunResult_t 未驻留时返回 APP_ERR_NOT_FOUND
+ */
+AppRunResult_t appsys_kill_app(const char* app_id) {
+    AppSlot_t* slot = appsys_find_slot(app_id);
+    if (slot == NULL) {
+        int hibernated = appsys_find_hibernated(app_id);
+        if (hibernated < 0) {
+            return APP_ERR_NOT_FOUND;
+        }
+        appsys_remove_hibernated(hibernated, true);
+        return APP_SUCCESS;
+    }
+    appsys_free_slot(slot);
+    return APP_SUCCESS;
+}
+
+/**
+ * @brief appsys_hibernate_app 把驻留的应用休眠到磁盘，释放其 realm 与屏幕
+ * @param app_id 应用 ID
+ * @return AppRunResult_t 未驻留时返回 APP_ERR_NOT_FOUND，写入失败时返回 APP_ERR_HIBERNATE_FAIL
+ */
+AppRunResult_t appsys_hibernate_app(const char* app_id) {
+    AppSlot_t* slot = appsys_find_slot(app_id);
+    if (slot == NULL) {
+        return APP_ERR_NOT_FOUND;
+    }
+    return appsys_hibernate_slot(slot) ? APP_SUCCESS : APP_ERR_HIBERNATE_FAIL;
+}
+
+/**
+ * @brief appsys_get_app_state 查询应用的驻留状态
+ * @param app_id 应用 ID
+ * @return AppState_t 驻留状态
+ */
+AppState_t appsys_get_app_state(const char* app_id) {
+    AppSlot_t* slot = appsys_find_slot(app_id);
+    if (slot != NULL) {
+        return slot->state;
+    }
+    return appsys_find_hibernated(app_id) >= 0 ? APP_STATE_HIBERNATED : APP_STATE_NONE;
+}
+
+/**
+ * @brief appsys_get_foreground_app 获取前台应用 ID
+ * @return const char* 没有前台应用时返回 NULL
+ */
+const char* appsys_get_foreground_app(void) {
+    return foreground_slot == NULL ? NULL : foreground_slot->package->app_id;
+}
+
+/**
+ * @brief appsys_get_resident_app 按槽位下标获取驻留的应用（包括后台挂起的应用）
+ * @param index 槽位下标，0 ~ APPSYS_MAX_RESIDENT_APPS - 1
+ * @param screen 输出：应用的屏幕，可为 NULL
+ * @return const ApplicationPackage_t* 槽位空闲或下标越界时返回 NULL
+ */
+const ApplicationPackage_t* appsys_get_resident_app(uint32_t index, lv_obj_t** screen) {
+    if (index >= APPSYS_MAX_RESIDENT_APPS || app_slots[index].state == APP_STATE_NONE) {
+        return NULL;
+    }
+    if (screen != NULL) {
+        *screen = app_slots[index].screen;
+    }
+    return app_slots[index].package;
+}
+
+/**
+ * @brief appsys_get_exec_budget 获取应用单次同步执行的时间预算
+ * @param realm 应用的 realm
+ * @return uint32_t 预算 [ms]，未设置或找不到应用时返回 APPSYS_WATCHDOG_BUDGET_MS
+ */
+uint32_t appsys_get_exec_budget(jerry_value_t realm) {
+    AppSlot_t* slot = appsys_find_slot_by_realm(realm);
+    if (slot == NULL || slot->package->exec_budget_ms == 0) {
+        return APPSYS_WATCHDOG_BUDGET_MS;
+    }
+    return slot->package->exec_budget_ms;
+}
+
+/**
+ * @brief appsys_get_package 获取 realm 所属应用的应用包
+ * @param realm 应用的 realm
+ * @return const ApplicationPackage_t* 找不到应用（如系统 realm）时返回 NULL
+ */
+const ApplicationPackage_t* appsys_get_package(jerry_value_t realm) {
+    AppSlot_t* slot = appsys_find_slot_by_realm(realm);
+    return slot == NULL ? NULL : slot->package;
+}
+
+/**
+ * @brief appsys_terminate_async_cb 调用栈退出后执行终止
+ * @param user_data 应用槽位
+ */
+static void appsys_terminate_async_cb(void* user_data) {
+    AppSlot_t* slot = (AppSlot_t*)user_data;
+    // 期间应用可能已被关闭，槽位被清零后标志随之清除
+    if (slot->terminate_pending) {
+        appsys_free_slot(slot);
+    }
+}
+
+/**
+ * @brief appsys_request_terminate 请求终止应用。调用时应用的 JS 可能仍在调用栈上，
+ *        因此推迟到下一次 lv_timer_handler 再释放
+ * @param realm 应用的 realm
+ * @param reason 终止原因，仅用于打印
+ */
+void appsys_request_terminate(jerry_value_t realm, AppRunResult_t reason) {
+    AppSlot_t* slot = appsys_find_slot_by_realm(realm);
+    if (slot == NULL || slot->terminate_pending) {
+        return;
+    }
+    printf("appsys: terminating %s (reason %d)\n", slot->package->app_id, (int)reason);
+    slot->terminate_pending = true;
+    lv_async_call(appsys_terminate_async_cb, slot);
+}
@@ -0,0 +1,585 @@
+﻿/**
+ * @file appsys_event.c
+ * @brief JS 事件回调的快速分发路径实现
+ * @author Sab1e
+ * @date 2025-08-06
+ *
+ * 每个 JS 回调按事件码单独注册到 LVGL（lv_obj_add_event_cb 的 filter 参数），
+ * 未订阅的事件在 LVGL 内部就被过滤，不会进入 JerryScript。
+ * 分发时复用所在 realm 预先创建的事件对象（每个 realm 一个，不在应用之间共享），
+ * 事件信息通过 lv_event_get_* 原生函数按需读取，单次分发不再创建任何 JS 对象。
+ * 默认方式下释放对象记录的 LV_EVENT_DELETE 回调始终保持在该对象回调的最后，
+ * 保证删除事件先分发给全部 JS 回调，再释放回调结构。
+ *
+ * APPSYS_COMPACT_OBJ 为 1 时改为每个对象只注册一个 LV_EVENT_ALL 回调，在原生侧按事件码查找 JS 回调，
+ * 并在同一个回调中处理 LV_EVENT_DELETE：对象只持有一个事件描述符（默认方式为回调数 + 1 个），
+ * 代价是该对象的每个事件（包括绘制事件）都会进入一次分发函数，未订阅的事件码由位掩码直接过滤。
+ * 带 LV_EVENT_PREPROCESS 标志的回调只在 LVGL 的预处理阶段调用，LV_EVENT_ALL 回调收不到，
+ * 这类回调仍按事件码单独注册。
+ */
+
+#include "appsys_event.h"
+#include "appsys_core.h"
+#include "appsys_js_utils.h"
+#include "appsys_watchdog.h"
+#include "appsys_conf.h"
+#include "uthash.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+struct AppSysEventTarget;
+
+/**
+ * @brief 单个 JS 事件回调
+ */
+typedef struct AppSysEventHandler {
+    lv_event_code_t code;
+    jerry_value_t func;
+    jerry_value_t user_data;
+    struct AppSysEventTarget* target;
+    struct AppSysEventHandler* next;
+} AppSysEventHandler_t;
+
+/**
+ * @brief 注册了 JS 回调的 LVGL 对象
+ */
+typedef struct AppSysEventTarget {
+    lv_obj_t* obj;                   // 哈希键
+    jerry_value_t js_obj;            // 注册时传入的 JS 对象，作为 this / current_target 复用
+    jerry_value_t event_obj;         // 所在 realm 的事件对象
+    AppSysEventHandler_t* handlers;
+#if APPSYS_COMPACT_OBJ
+    uint64_t code_mask;              // 由对象回调分发的事件码位掩码，见 appsys_event_code_bit
+#endif
+    UT_hash_handle hh;
+} AppSysEventTarget_t;
+
+static AppSysEventTarget_t* event_targets = NULL;
+static jerry_value_t key_event_obj = 0;              // realm 全局对象上保存事件对象的内部属性名
+static lv_event_t* current_event = NULL;             // 正在分发的事件
+static AppSysEventHandler_t* current_handler = NULL;
+
+static void appsys_event_dispatch_cb(lv_event_t* e);
+#if APPSYS_COMPACT_OBJ
+static void appsys_event_target_cb(lv_event_t* e);
+#else
+static void appsys_event_delete_cb(lv_event_t* e);
+#endif
+
+/**
+ * @brief 回调是否单独注册到 LVGL（紧凑模式下只有预处理回调单独注册）
+ */
+static bool appsys_event_is_separate(const AppSysEventHandler_t* h) {
+#if APPSYS_COMPACT_OBJ
+    return (h->code & LV_EVENT_PREPROCESS) != 0;
+#else
+    (void)h;
+    return true;
+#endif
+}
+
+/**
+ * @brief 释放单个回调持有的 JS 值
+ */
+static void appsys_event_free_handler(AppSysEventHandler_t* h) {
+    if (h == current_handler) {
+        // 回调中删除了自身所在的对象
+        current_handler = NULL;
+    }
+    jerry_value_free(h->func);
+    jerry_value_free(h->user_data);
+    free(h);
+}
+
+/**
+ * @brief 释放对象记录及其全部回调
+ * @param target 对象记录
+ * @param detach 是否同时从 LVGL 对象上移除回调（对象被删除时不需要）
+ */
+static void appsys_event_free_target(AppSysEventTarget_t* target, bool detach) {
+    AppSysEventHandler_t* h = target->handlers;
+    while (h != NULL) {
+        AppSysEventHandler_t* next = h->next;
+        if (detach && appsys_event_is_separate(h)) {
+            lv_obj_remove_event_cb_with_user_data(target->obj, appsys_event_dispatch_cb, h);
+        }
+        appsys_event_free_handler(h);
+        h = next;
+    }
+    if (detach) {
+#if APPSYS_COMPACT_OBJ
+        lv_obj_remove_event_cb_with_user_data(target->obj, appsys_event_target_cb, target);
+#else
+        lv_obj_remove_event_cb_with_user_data(target->obj, appsys_event_delete_cb, target);
+#endif
+    }
+    HASH_DEL(event_targets, target);
+    jerry_value_free(target->js_obj);
+    jerry_value_free(target->event_obj);
+    free(target);
+}
+
+/**
+ * @brief 取得当前 realm 的事件对象，不存在时创建
+ * @return jerry_value_t 事件对象，调用者负责释放
+ */
+static jerry_value_t appsys_event_realm_obj(void) {
+    jerry_value_t global = jerry_current_realm();
+    jerry_value_t obj = jerry_object_get_internal(global, key_event_obj);
+    if (!jerry_value_is_object(obj)) {
+        jerry_value_free(obj);
+        obj = jerry_object();
+        jerry_object_set_internal(global, key_event_obj, obj);
+    }
+    jerry_value_free(global);
+    return obj;
+}
+
+/**
+ * @brief 调用单个 JS 回调
+ */
+static void appsys_event_dispatch(lv_event_t* e, AppSysEventHandler_t* h) {
+    lv_event_t* prev_event = current_event;
+    AppSysEventHandler_t* prev_handler = current_handler;
+
+    // 回调中可能同步触发其他事件，分发结束后恢复外层的事件信息
+    current_event = e;
+    current_handler = h;
+    jerry_value_t ret = appsys_event_call(h->func, h->target->js_obj, &h->target->event_obj, 1);
+    jerry_value_free(ret);
+    current_event = prev_event;
+    current_handler = prev_handler;
+}
+
+/**
+ * @brief LVGL 事件回调：调用对应的 JS 函数
+ */
+static void appsys_event_dispatch_cb(lv_event_t* e) {
+    appsys_event_dispatch(e, (AppSysEventHandler_t*)lv_event_get_user_data(e));
+}
+
+#if APPSYS_COMPACT_OBJ
+/**
+ * @brief 事件码在 code_mask 中对应的位，63 及以上的事件码共用最高位
+ */
+static uint64_t appsys_event_code_bit(lv_event_code_t code) {
+    return (uint64_t)1 << (code < 63 ? code : 63);
+}
+
+/**
+ * @brief 按当前回调重新计算对象记录的事件码位掩码
+ */
+static void appsys_event_update_mask(AppSysEventTarget_t* target) {
+    uint64_t mask = 0;
+    AppSysEventHandler_t* h;
+    for (h = target->handlers; h != NULL; h = h->next) {
+        if (!appsys_event_is_separate(h)) {
+            mask |= appsys_event_code_bit(h->code);
+        }
+    }
+    target->code_mask = mask;
+}
+
+/**
+ * @brief 回调是否仍属于对象记录（可能已在之前的回调中被注销）
+ */
+static bool appsys_event_has_handler(AppSysEventTarget_t* target, AppSysEventHandler_t* handler) {
+    AppSysEventHandler_t* h;
+    for (h = target->handlers; h != NULL; h = h->next) {
+        if (h == handler) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief LVGL 事件回调（紧凑模式）：按事件码依注册顺序调用 JS 回调，对象删除时释放记录
+ */
+static void appsys_event_target_cb(lv_event_t* e) {
+    AppSysEventTarget_t* target = (AppSysEventTarget_t*)lv_event_get_user_data(e);
+    lv_obj_t* obj = target->obj;
+    lv_event_code_t code = lv_event_get_code(e);
+
+    // 绘制等高频事件通常没有订阅，不必遍历回调链表
+    if ((target->code_mask & (appsys_event_code_bit(code) | appsys_event_code_bit(LV_EVENT_ALL))) == 0) {
+        if (code == LV_EVENT_DELETE) {
+            appsys_event_free_target(target, false);
+        }
+        return;
+    }
+
+    // 回调中可能注销回调或删除对象，先记下本次要调用的回调
+    AppSysEventHandler_t* local[8];
+    AppSysEventHandler_t** matched = local;
+    uint32_t count = 0;
+    AppSysEventHandler_t* h;
+    for (h = target->handlers; h != NULL; h = h->next) {
+        if (!appsys_event_is_separate(h) && (h->code == code || h->code == LV_EVENT_ALL)) {
+            count++;
+        }
+    }
+    if (count > sizeof(local) / sizeof(local[0])) {
+        matched = (AppSysEventHandler_t**)malloc(count * sizeof(AppSysEventHandler_t*));
+        if (matched == NULL) {
+            return;
+        }
+    }
+    count = 0;
+    for (h = target->handlers; h != NULL; h = h->next) {
+        if (!appsys_event_is_separate(h) && (h->code == code || h->code == LV_EVENT_ALL)) {
+            matched[count++] = h;
+        }
+    }
+
+    // 链表头部是最后注册的回调，倒序调用以保持注册顺序
+    bool alive = true;
+    for (uint32_t i = count; i-- > 0 && alive;) {
+        if (!appsys_event_has_handler(target, matched[i])) {
+            continue;
+        }
+        appsys_event_dispatch(e, matched[i]);
+        AppSysEventTarget_t* found = NULL;
+        HASH_FIND_PTR(event_targets, &obj, found);
+        alive = found == target;
+    }
+    if (matched != local) {
+        free(matched);
+    }
+    if (alive && code == LV_EVENT_DELETE) {
+        appsys_event_free_target(target, false);
+    }
+}
+#else
+/**
+ * @brief 对象被删除时释放其全部 JS 回调
+ */
+static void appsys_event_delete_cb(lv_event_t* e) {
+    AppSysEventTarget_t* target = (AppSysEventTarget_t*)lv_event_get_user_data(e);
+    appsys_event_free_target(target, false);
+}
+#endif
+
+/**
+ * @brief 调用 JS 函数，出现异常时打印并返回 undefined。调用受看门狗监控，
+ *        超时后不再进入 JS
+ * @param func JS 函数
+ * @param this_val this 值
+ * @param args_p 参数数组
+ * @param args_count 参数数量
+ * @return jerry_value_t 函数返回值，调用者负责释放
+ */
+jerry_value_t appsys_event_call(jerry_value_t func, jerry_value_t this_val,
+    const jerry_value_t* args_p, jerry_length_t args_count) {
+    if (!appsys_watchdog_begin()) {
+        return jerry_undefined();
+    }
+    jerry_value_t ret = jerry_call(func, this_val, args_p, args_count);
+    appsys_watchdog_end();
+    if (jerry_value_is_exception(ret)) {
+        appsys_report_exception(ret);
+        jerry_value_free(ret);
+        return jerry_undefined();
+    }
+    return ret;
+}
+
+/**
+ * @brief 注册 JS 事件回调
+ * @param obj LVGL 对象
+ * @param js_obj 对象对应的 JS 包装
+ * @param code 订阅的事件码
+ * @param func JS 函数
+ * @param user_data 用户数据（可为 undefined）
+ * @return true 注册成功
+ */
+bool appsys_event_register(lv_obj_t* obj, jerry_value_t js_obj, lv_event_code_t code,
+    jerry_value_t func, jerry_value_t user_data) {
+    if (obj == NULL || !jerry_value_is_function(func)) {
+        return false;
+    }
+
+    AppSysEventTarget_t* target = NULL;
+    HASH_FIND_PTR(event_targets, &obj, target);
+    if (target == NULL) {
+        target = (AppSysEventTarget_t*)calloc(1, sizeof(AppSysEventTarget_t));
+        if (target == NULL) {
+            return false;
+        }
+        target->obj = obj;
+        target->js_obj = jerry_value_copy(js_obj);
+        target->event_obj = appsys_event_realm_obj();
+        HASH_ADD_PTR(event_targets, obj, target);
+#if APPSYS_COMPACT_OBJ
+        lv_obj_add_event_cb(obj, appsys_event_target_cb, LV_EVENT_ALL, target);
+#else
+        lv_obj_add_event_cb(obj, appsys_event_delete_cb, LV_EVENT_DELETE, target);
+#endif
+    }
+
+    AppSysEventHandler_t* h = (AppSysEventHandler_t*)malloc(sizeof(AppSysEventHandler_t));
+    if (h == NULL) {
+        if (target->handlers == NULL) {
+            appsys_event_free_target(target, true);
+        }
+        return false;
+    }
+    h->code = code;
+    h->func = jerry_value_copy(func);
+    h->user_data = jerry_value_copy(user_data);
+    h->target = target;
+    h->next = target->handlers;
+    target->handlers = h;
+
+    if (appsys_event_is_separate(h)) {
+        lv_obj_add_event_cb(obj, appsys_event_dispatch_cb, code, h);
+    }
+#if APPSYS_COMPACT_OBJ
+    appsys_event_update_mask(target);
+#else
+    // LVGL 按注册顺序调用回调：把释放记录的删除回调移到最后，
+    // 否则 LV_EVENT_DELETE / LV_EVENT_ALL 的 JS 回调会拿到已释放的 h
+    lv_obj_remove_event_cb_with_user_data(obj, appsys_event_delete_cb, target);
+    lv_obj_add_event_cb(obj, appsys_event_delete_cb, LV_EVENT_DELETE, target);
+#endif
+    return true;
+}
+
+/**
+ * @brief 注销 JS 事件回调
+ * @param obj LVGL 对象
+ * @param code 事件码
+ * @param func 要注销的函数，为 undefined 时注销该事件码下的全部回调
+ * @return uint32_t 注销的回调数量
+ */
+uint32_t appsys_event_unregister(lv_obj_t* obj, lv_event_code_t code, jerry_value_t func) {
+    AppSysEventTarget_t* target = NULL;
+    HASH_FIND_PTR(event_targets, &obj, target);
+    if (target == NULL) {
+        return 0;
+    }
+
+    uint32_t removed = 0;
+    AppSysEventHandler_t** link = &target->handlers;
+    while (*link != NULL) {
+        AppSysEventHandler_t* h = *link;
+        bool match = h->code == code;
+        if (match && !jerry_value_is_undefined(func)) {
+            jerry_value_t eq = jerry_binary_op(JERRY_BIN_OP_STRICT_EQUAL, h->func, func);
+            match = jerry_value_is_true(eq);
+            jerry_value_free(eq);
+        }
+        if (match) {
+            *link = h->next;
+            if (appsys_event_is_separate(h)) {
+                lv_obj_remove_event_cb_with_user_data(obj, appsys_event_dispatch_cb, h);
+            }
+            appsys_event_free_handler(h);
+            removed++;
+        }
+        else {
+            link = &h->next;
+        }
+    }
+
+    if (target->handlers == NULL) {
+        appsys_event_free_target(target, true);
+    }
+#if APPSYS_COMPACT_OBJ
+    else {
+        appsys_event_update_mask(target);
+    }
+#endif
+    return removed;
+}
+
+/**
+ * @brief 统计对象的 JS 回调占用的原生内存
+ * @param obj LVGL 对象
+ * @param wrapper_count 输出：对象持有的 JS 包装数量（0 或 1），可为 NULL
+ * @return size_t 对象记录与回调结构的大小 [byte]，未注册回调时返回 0
+ */
+size_t appsys_event_get_footprint(lv_obj_t* obj, uint32_t* wrapper_count) {
+    AppSysEventTarget_t* target = NULL;
+    HASH_FIND_PTR(event_targets, &obj, target);
+    if (wrapper_count != NULL) {
+        *wrapper_count = target != NULL ? 1 : 0;
+    }
+    if (target == NULL) {
+        return 0;
+    }
+    size_t bytes = sizeof(AppSysEventTarget_t);
+    AppSysEventHandler_t* h;
+    for (h = target->handlers; h != NULL; h = h->next) {
+        bytes += sizeof(AppSysEventHandler_t);
+    }
+    return bytes;
+}
+
+/********************************** 原生函数定义 **********************************/
+
+/**
+ * @brief register_lv_event_handler(obj, code, func[, user_data])
+ */
+static jerry_value_t js_register_lv_event_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (args_count < 3) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "register_lv_event_handler: expected (obj, code, func[, user_data])");
+    }
+    lv_obj_t* obj = (lv_obj_t*)appsys_js_get_ptr(args_p[0]);
+    lv_event_code_t code = (lv_event_code_t)appsys_js_get_int(args_p, args_count, 1, LV_EVENT_ALL);
+    jerry_value_t user_data = args_count > 3 ? args_p[3] : jerry_undefined();
+
+    bool ok = appsys_event_register(obj, args_p[0], code, args_p[2], user_data);
+    if (args_count <= 3) {
+        jerry_value_free(user_data);
+    }
+    if (!ok) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "register_lv_event_handler: invalid object or function");
+    }
+    return jerry_undefined();
+}
+
+/**
+ * @brief unregister_lv_event_handler(obj, code[, func])
+ */
+static jerry_value_t js_unregister_lv_event_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (args_count < 2) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "unregister_lv_event_handler: expected (obj, code[, func])");
+    }
+    lv_obj_t* obj = (lv_obj_t*)appsys_js_get_ptr(args_p[0]);
+    lv_event_code_t code = (lv_event_code_t)appsys_js_get_int(args_p, args_count, 1, LV_EVENT_ALL);
+    jerry_value_t func = args_count > 2 ? args_p[2] : jerry_undefined();
+    uint32_t removed = appsys_event_unregister(obj, code, func);
+    return jerry_number((double)removed);
+}
+
+/**
+ * @brief lv_event_get_code(e)
+ */
+static jerry_value_t js_lv_event_get_code(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p; (void)args_p; (void)args_count;
+    if (current_event == NULL) {
+        return jerry_undefined();
+    }
+    return jerry_number((double)lv_event_get_code(current_event));
+}
+
+/**
+ * @brief lv_event_get_target(e)：目标就是注册对象时直接复用其 JS 包装
+ */
+static jerry_value_t js_lv_event_get_target(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p; (void)args_p; (void)args_count;
+    if (current_event == NULL) {
+        return jerry_undefined();
+    }
+    lv_obj_t* target_obj = (lv_obj_t*)lv_event_get_target(current_event);
+    AppSysEventTarget_t* target = NULL;
+    HASH_FIND_PTR(event_targets, &target_obj, target);
+    if (target != NULL) {
+        return jerry_value_copy(target->js_obj);
+    }
+    return appsys_js_new_ptr(target_obj);
+}
+
+/**
+ * @brief lv_event_get_current_target(e)
+ */
+static jerry_value_t js_lv_event_get_current_target(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p; (void)args_p; (void)args_count;
+    if (current_handler == NULL) {
+        return jerry_undefined();
+    }
+    return jerry_value_copy(current_handler->target->js_obj);
+}
+
+/**
+ * @brief lv_event_get_user_data(e)
+ */
+static jerry_value_t js_lv_event_get_user_data(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p; (void)args_p; (void)args_count;
+    if (current_handler == NULL) {
+        return jerry_undefined();
+    }
+    return jerry_value_copy(current_handler->user_data);
+}
+
+/**
+ * @brief 事件相关原生函数列表（覆盖绑定中的同名函数）
+ */
+static const AppSysFuncEntry appsys_event_funcs[] = {
+    {
+        .name = "register_lv_event_handler",
+        .handler = js_register_lv_event_handler
+    },
+    {
+        .name = "unregister_lv_event_handler",
+        .handler = js_unregister_lv_event_handler
+    },
+    {
+        .name = "lv_event_get_code",
+        .handler = js_lv_event_get_code
+    },
+    {
+        .name = "lv_event_get_target",
+        .handler = js_lv_event_get_target
+    },
+    {
+        .name = "lv_event_get_current_target",
+        .handler = js_lv_event_get_current_target
+    },
+    {
+        .name = "lv_event_get_user_data",
+        .handler = js_lv_event_get_user_data
+    },
+};
+
+/**
+ * @brief 初始化事件分发（需在 jerry_init 之后调用）
+ */
+void appsys_event_init(void) {
+    key_event_obj = jerry_string_sz("appsys_event_obj");
+}
+
+/**
+ * @brief 将事件函数注册到当前 realm（需在 lv_binding_init 之后调用，以覆盖绑定中的事件函数）
+ */
+void appsys_event_register_natives(void) {
+    appsys_register_functions(appsys_event_funcs, sizeof(appsys_event_funcs) / sizeof(AppSysFuncEntry));
+}
+
+/**
+ * @brief 移除所有 JS 回调并释放缓存的属性名（需在 jerry_cleanup 之前调用）
+ */
+void appsys_event_deinit(void) {
+    AppSysEventTarget_t* target;
+    AppSysEventTarget_t* tmp;
+    HASH_ITER(hh, event_targets, target, tmp) {
+        appsys_event_free_target(target, true);
+    }
+    if (key_event_obj != 0) {
+        jerry_value_free(key_event_obj);
+        key_event_obj = 0;
+    }
+    current_event = NULL;
+    current_handler = NULL;
+}
@@ -0,0 +1,367 @@
+﻿/**
+ * @file appsys_golden.c
+ * @brief 渲染回归测试实现
+ * @author Sab1e
+ * @date 2025-08-23
+ *
+ * 绘制路径的优化必须保证输出不变。回归测试创建一个不依赖窗口的虚拟显示器（DIRECT 模式，
+ * 帧缓冲始终保存完整画面），把 LVGL 时钟替换为虚拟时钟，依次运行各个脚本：
+ *   - 脚本中调用 golden_checkpoint("name") 时立即刷新并截图（不在回归测试中运行时什么也不做）；
+ *   - 虚拟时钟只在脚本返回后推进，run_lvgl 在回归测试中直接返回（见 stdlib.js），不会卡住；
+ *   - 每个脚本运行 run_ms 虚拟时间后截取 "final" 检查点，然后关闭应用。
+ * 截图与 <golden_dir>/<脚本名>/<检查点>.png 比较，不一致时在同一目录写出 <检查点>.actual.png 与
+ * <检查点>.diff.png（不同的像素标红，其余像素变暗），并打印差异像素数、最大误差与包围盒。
+ * 指定 update（--update）时用当前截图覆盖基准图；未指定时缺少基准图视为失败并写出 <检查点>.actual.png，
+ * 避免基准图丢失或检查点改名后回归测试仍然通过。
+ *
+ * 虚拟时间只作用于 LVGL 定时器与动画（包括 setTimeout / setInterval）；脚本不应依赖 Date 等墙上时间，
+ * 否则截图不可复现。
+ */
+
+#include "appsys_golden.h"
+#include "appsys_core.h"
+#include "appsys_png.h"
+#include "appsys_port.h"
+#include "appsys_str.h"
+#include "appsys_conf.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 单次运行的状态
+ */
+typedef struct {
+    const AppSysGoldenConfig_t* config;
+    lv_display_t* display;
+    lv_draw_buf_t* frame;
+    char app_name[64];            // 当前脚本名（不含路径与扩展名）
+    uint32_t checkpoints;
+    uint32_t failures;
+} AppSysGolden_t;
+
+static AppSysGolden_t* golden = NULL;   // 不在回归测试中时为 NULL
+static uint32_t golden_tick = 0;        // 虚拟时钟 [ms]
+
+static uint32_t appsys_golden_tick_cb(void) {
+    return golden_tick;
+}
+
+static void appsys_golden_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+/**
+ * @brief 创建不依赖窗口的虚拟显示器并设为默认显示器：整帧缓冲 + DIRECT 模式，缓冲区始终保存完整画面
+ * @param width 分辨率 [px]
+ * @param height 分辨率 [px]
+ * @return lv_display_t* 创建失败时返回 NULL
+ */
+lv_display_t* appsys_golden_create_display(uint32_t width, uint32_t height) {
+    lv_display_t* display = lv_display_create((int32_t)width, (int32_t)height);
+    if (display == NULL) {
+        return NULL;
+    }
+    lv_draw_buf_t* frame = lv_draw_buf_create(width, height, lv_display_get_color_format(display), 0);
+    if (frame == NULL) {
+        lv_display_delete(display);
+        return NULL;
+    }
+    lv_display_set_draw_buffers(display, frame, NULL);
+    lv_display_set_render_mode(display, LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_display_set_flush_cb(display, appsys_golden_flush_cb);
+    lv_display_set_default(display);
+    return display;
+}
+
+/**
+ * @brief 把帧缓冲转换为 RGB888
+ * @return uint8_t* width * height * 3 字节，调用者负责 free
+ */
+static uint8_t* appsys_golden_grab(AppSysGolden_t* g) {
+    uint32_t w = g->frame->header.w;
+    uint32_t h = g->frame->header.h;
+    uint32_t stride = g->frame->header.stride;
+    lv_color_format_t cf = (lv_color_format_t)g->frame->header.cf;
+    uint8_t* rgb = (uint8_t*)malloc((size_t)w * h * 3);
+    if (rgb == NULL) {
+        return NULL;
+    }
+    for (uint32_t y = 0; y < h; y++) {
+        const uint8_t* src = g->frame->data + (size_t)y * stride;
+        uint8_t* dst = rgb + (size_t)y * w * 3;
+        for (uint32_t x = 0; x < w; x++, dst += 3) {
+            if (cf == LV_COLOR_FORMAT_RGB565) {
+                uint16_t c = ((const uint16_t*)src)[x];
+                dst[0] = (uint8_t)(((c >> 11) & 0x1F) * 255 / 31);
+                dst[1] = (uint8_t)(((c >> 5) & 0x3F) * 255 / 63);
+                dst[2] = (uint8_t)((c & 0x1F) * 255 / 31);
+            }
+            else {
+                // RGB888 / XRGB8888 / ARGB8888 在内存中均为 B G R [A]
+                const uint8_t* p = src + x * lv_color_format_get_size(cf);
+                dst[0] = p[2];
+                dst[1] = p[1];
+                dst[2] = p[0];
+            }
+        }
+    }
+    return rgb;
+}
+
+/**
+ * @brief 比较截图与基准图，不一致时写出实际截图与差异图
+ * @return true 一致
+ */
+static bool appsys_golden_compare(AppSysGolden_t* g, const char* name, const char* dir,
+    const uint8_t* actual, uint32_t w, uint32_t h) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.png", dir, name);
+    uint32_t gw = 0;
+    uint32_t gh = 0;
+    if (g->config->update) {
+        bool ok = appsys_png_write(path, actual, w, h);
+        printf("[golden] %s/%s: %s\n", g->app_name, name, ok ? "golden written" : "failed to write golden");
+        return ok;
+    }
+    uint8_t* expected = appsys_png_read(path, &gw, &gh);
+    if (expected == NULL) {
+        printf("[golden] %s/%s: FAIL missing golden %s (run with --update to create it)\n", g->app_name, name, path);
+        snprintf(path, sizeof(path), "%s/%s.actual.png", dir, name);
+        appsys_png_write(path, actual, w, h);
+        return false;
+    }
+    if (gw != w || gh != h) {
+        printf("[golden] %s/%s: FAIL size %ux%u, golden %ux%u\n", g->app_name, name, w, h, gw, gh);
+        free(expected);
+        snprintf(path, sizeof(path), "%s/%s.actual.png", dir, name);
+        appsys_png_write(path, actual, w, h);
+        return false;
+    }
+
+    uint32_t diff_count = 0;
+    uint32_t max_delta = 0;
+    lv_area_t bbox = { INT32_MAX, INT32_MAX, -1, -1 };
+    uint8_t* diff = (uint8_t*)malloc((size_t)w * h * 3);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            size_t i = ((size_t)y * w + x) * 3;
+            uint32_t delta = 0;
+            for (int c = 0; c < 3; c++) {
+                uint32_t d = (uint32_t)abs((int)actual[i + c] - (int)expected[i + c]);
+                delta = LV_MAX(delta, d);
+            }
+            bool differs = delta > g->config->tolerance;
+            if (differs) {
+                diff_count++;
+                max_delta = LV_MAX(max_delta, delta);
+                bbox.x1 = LV_MIN(bbox.x1, (int32_t)x);
+                bbox.y1 = LV_MIN(bbox.y1, (int32_t)y);
+                bbox.x2 = LV_MAX(bbox.x2, (int32_t)x);
+                bbox.y2 = LV_MAX(bbox.y2, (int32_t)y);
+            }
+            if (diff != NULL) {
+                uint8_t gray = (uint8_t)((expected[i] + expected[i + 1] + expected[i + 2]) / 12);
+                diff[i] = differs ? 255 : gray;
+                diff[i + 1] = differs ? 0 : gray;
+                diff[i + 2] = differs ? 0 : gray;
+            }
+        }
+    }
+    free(expected);
+
+    if (diff_count == 0) {
+        printf("[golden] %s/%s: ok\n", g->app_name, name);
+        free(diff);
+        return true;
+    }
+    printf("[golden] %s/%s: FAIL %u px differ (%u.%02u%%), max delta %u, bbox (%d,%d)-(%d,%d)\n",
+        g->app_name, name, diff_count,
+        (uint32_t)((uint64_t)diff_count * 100 / ((uint64_t)w * h)),
+        (uint32_t)((uint64_t)diff_count * 10000 / ((uint64_t)w * h) % 100),
+        max_delta, (int)bbox.x1, (int)bbox.y1, (int)bbox.x2, (int)bbox.y2);
+    snprintf(path, sizeof(path), "%s/%s.actual.png", dir, name);
+    appsys_png_write(path, actual, w, h);
+    if (diff != NULL) {
+        snprintf(path, sizeof(path), "%s/%s.diff.png", dir, name);
+        appsys_png_write(path, diff, w, h);
+        free(diff);
+    }
+    return false;
+}
+
+/**
+ * @brief 刷新显示器并处理一个检查点
+ * @return true 与基准图一致（或已写入新基准图）
+ */
+static bool appsys_golden_checkpoint(AppSysGolden_t* g, const char* name) {
+    lv_refr_now(g->display);
+    g->checkpoints++;
+
+    char dir[192];
+    snprintf(dir, sizeof(dir), "%s/%s", g->config->golden_dir, g->app_name);
+    appsys_port_make_dir(g->config->golden_dir);
+    appsys_port_make_dir(dir);
+
+    uint8_t* actual = appsys_golden_grab(g);
+    bool ok = actual != NULL
+        && appsys_golden_compare(g, name, dir, actual, g->frame->header.w, g->frame->header.h);
+    free(actual);
+    if (!ok) {
+        g->failures++;
+    }
+    return ok;
+}
+
+/**
+ * @brief 读取脚本文件
+ * @return char* 以 '\0' 结尾的源码，调用者负责 free
+ */
+static char* appsys_golden_load_script(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* source = len >= 0 ? (char*)malloc((size_t)len + 1) : NULL;
+    if (source == NULL || fread(source, 1, (size_t)len, file) != (size_t)len) {
+        fclose(file);
+        free(source);
+        return NULL;
+    }
+    fclose(file);
+    source[len] = '\0';
+    return source;
+}
+
+/**
+ * @brief 依次运行脚本并比较检查点截图
+ * @param scripts 脚本路径
+ * @param script_count 脚本数量
+ * @param config 配置
+ * @return uint32_t 失败的检查点数量（脚本无法加载或启动也计为失败）
+ */
+uint32_t appsys_golden_run(const char* const* scripts, uint32_t script_count, const AppSysGoldenConfig_t* config) {
+    AppSysGolden_t g;
+    memset(&g, 0, sizeof(g));
+    g.config = config;
+
+    lv_tick_set_cb(appsys_golden_tick_cb);
+    g.display = appsys_golden_create_display(config->width, config->height);
+    if (g.display == NULL) {
+        printf("[golden] failed to create virtual display\n");
+        return 1;
+    }
+    g.frame = lv_display_get_buf_active(g.display);
+    golden = &g;
+
+    for (uint32_t i = 0; i < script_count; i++) {
+        // 脚本名：去掉目录与扩展名
+        const char* base = scripts[i];
+        for (const char* p = scripts[i]; *p != '\0'; p++) {
+            if (*p == '/' || *p == '\\') {
+                base = p + 1;
+            }
+        }
+        snprintf(g.app_name, sizeof(g.app_name), "%s", base);
+        char* dot = strrchr(g.app_name, '.');
+        if (dot != NULL) {
+            *dot = '\0';
+        }
+
+        char* source = appsys_golden_load_script(scripts[i]);
+        if (source == NULL) {
+            printf("[golden] %s: cannot read %s\n", g.app_name, scripts[i]);
+            g.failures++;
+            continue;
+        }
+        char app_id[80];
+        snprintf(app_id, sizeof(app_id), "golden.%s", g.app_name);
+        ApplicationPackage_t app = {
+            .app_id = app_id,
+            .name = g.app_name,
+            .version = "0",
+            .author = "golden",
+            .description = "rendering regression test",
+            .mainjs_str = source,
+        };
+
+        AppRunResult_t result = appsys_run_app(&app);
+        if (result != APP_SUCCESS) {
+            printf("[golden] %s: app failed to start (%d)\n", g.app_name, (int)result);
+            g.failures++;
+        }
+        else {
+            for (uint32_t t = 0; t < config->run_ms; t += APPSYS_GOLDEN_STEP_MS) {
+                golden_tick += APPSYS_GOLDEN_STEP_MS;
+                lv_timer_handler();
+            }
+            appsys_golden_checkpoint(&g, "final");
+            appsys_kill_app(app_id);
+        }
+        free(source);
+    }
+
+    printf("[golden] %u checkpoints, %u failed\n", g.checkpoints, g.failures);
+    golden = NULL;
+    return g.failures;
+}
+
+/**
+ * @brief golden_checkpoint(name) 在回归测试中截图比较，返回是否一致；平时返回 undefined
+ */
+static jerry_value_t js_golden_checkpoint(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (golden == NULL) {
+        return jerry_undefined();
+    }
+    const char* name = args_count > 0 ? appsys_str_get(args_p[0], NULL) : NULL;
+    if (name == NULL || name[0] == '\0' || strpbrk(name, "/\\.:") != NULL) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "golden_checkpoint: expected a plain checkpoint name");
+    }
+    char checkpoint[64];
+    snprintf(checkpoint, sizeof(checkpoint), "%s", name);
+    return jerry_boolean(appsys_golden_checkpoint(golden, checkpoint));
+}
+
+/**
+ * @brief golden_active() 是否正在回归测试中运行
+ */
+static jerry_value_t js_golden_active(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    (void)args_p;
+    (void)args_count;
+    return jerry_boolean(golden != NULL);
+}
+
+/**
+ * @brief 回归测试原生函数列表
+ */
+static const AppSysFuncEntry appsys_golden_funcs[] = {
+    {
+        .name = "golden_checkpoint",
+        .handler = js_golden_checkpoint
+    },
+    {
+        .name = "golden_active",
+        .handler = js_golden_active
+    },
+};
+
+/**
+ * @brief 将回归测试函数注册到当前 realm
+ */
+void appsys_golden_register_natives(void) {
+    appsys_register_functions(appsys_golden_funcs, sizeof(appsys_golden_funcs) / sizeof(AppSysFuncEntry));
+}
@@ -0,0 +1,967 @@
+﻿/**
+ * @file appsys_hibernate.c
+ * @brief 应用休眠实现
+ * @author Sab1e
+ * @date 2025-08-10
+ *
+ * 休眠数据格式（小端，整数为变长编码，见 appsys_buf.c）：
+ *   "EHIB" | 版本 u8 | app_id str | 状态长度 u32 | 状态 | 控件数 | 屏幕树
+ * 状态：应用通过 app_declare_state(obj) 声明的对象，按类型标记递归编码，函数等不可序列化的值记为 undefined。
+ * 屏幕树：每个控件记录类型、位置尺寸、常用标志、状态以及文本/数值/选项等内容，子控件递归跟随。
+ *
+ * 恢复时先按屏幕树原生重建控件并立即刷新一帧，用户马上看到离开时的画面；随后照常执行主脚本，
+ * 脚本调用 app_declare_state 时取回休眠前的状态。脚本执行期间 lv_*_create 被替换为领取版本：
+ * 父控件下按顺序下一个尚未领取的重建控件类型相同时直接返回该控件，不再新建，
+ * 脚本无需修改即可在已有控件上设置样式、绑定事件。类型不一致（脚本按状态走了不同分支）时照常新建，
+ * 主脚本执行完后仍未被领取的重建控件连同子控件一起删除，结果与冷启动一致。
+ * 类型表之外的控件只重建占位的基础对象，不参与领取。
+ */
+
+#include "appsys_hibernate.h"
+#include "appsys_core.h"
+#include "appsys_conf.h"
+#include "appsys_buf.h"
+#include "appsys_port.h"
+#include "appsys_js_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIBERNATE_MAGIC         "EHIB"
+#define HIBERNATE_VERSION       3
+#define NODE_CLASS_OTHER        0xFF  // 类型表之外的控件
+
+/**
+ * @brief JS 值类型标记
+ */
+typedef enum {
+    VALUE_TAG_UNDEFINED = 0,
+    VALUE_TAG_NULL,
+    VALUE_TAG_FALSE,
+    VALUE_TAG_TRUE,
+    VALUE_TAG_INT,
+    VALUE_TAG_DOUBLE,
+    VALUE_TAG_STRING,
+    VALUE_TAG_ARRAY,
+    VALUE_TAG_OBJECT,
+} AppSysValueTag_t;
+
+/**
+ * @brief 控件内容的记录方式
+ */
+typedef enum {
+    NODE_KIND_PLAIN = 0,      // 只记录通用属性
+    NODE_KIND_TEXT,           // 文本
+    NODE_KIND_RANGE,          // 范围与当前值
+    NODE_KIND_OPTIONS,        // 选项列表与选中项
+} AppSysNodeKind_t;
+
+/**
+ * @brief 可重建的控件类型
+ */
+typedef struct {
+    const lv_obj_class_t* cls;
+    lv_obj_t* (*create)(lv_obj_t* parent);
+    AppSysNodeKind_t kind;
+    bool own_children;        // 子控件由控件自身创建，不单独记录
+} AppSysNodeClass_t;
+
+/**
+ * @brief 类型表下标（同时是领取版 lv_*_create 的参数）
+ */
+typedef enum {
+    NODE_CLASS_OBJ = 0,
+    NODE_CLASS_LABEL,
+    NODE_CLASS_BUTTON,
+    NODE_CLASS_CHECKBOX,
+    NODE_CLASS_TEXTAREA,
+    NODE_CLASS_SLIDER,
+    NODE_CLASS_BAR,
+    NODE_CLASS_ARC,
+    NODE_CLASS_SWITCH,
+    NODE_CLASS_DROPDOWN,
+    NODE_CLASS_ROLLER,
+    NODE_CLASS_CHART,
+    NODE_CLASS_TABLE,
+    NODE_CLASS_COUNT,
+} AppSysNodeClassId_t;
+
+static const AppSysNodeClass_t node_classes[NODE_CLASS_COUNT] = {
+    [NODE_CLASS_OBJ]      = { &lv_obj_class,      lv_obj_create,      NODE_KIND_PLAIN,   false },
+    [NODE_CLASS_LABEL]    = { &lv_label_class,    lv_label_create,    NODE_KIND_TEXT,    false },
+    [NODE_CLASS_BUTTON]   = { &lv_button_class,   lv_button_create,   NODE_KIND_PLAIN,   false },
+    [NODE_CLASS_CHECKBOX] = { &lv_checkbox_class, lv_checkbox_create, NODE_KIND_TEXT,    false },
+    [NODE_CLASS_TEXTAREA] = { &lv_textarea_class, lv_textarea_create, NODE_KIND_TEXT,    true  },
+    [NODE_CLASS_SLIDER]   = { &lv_slider_class,   lv_slider_create,   NODE_KIND_RANGE,   false },
+    [NODE_CLASS_BAR]      = { &lv_bar_class,      lv_bar_create,      NODE_KIND_RANGE,   false },
+    [NODE_CLASS_ARC]      = { &lv_arc_class,      lv_arc_create,      NODE_KIND_RANGE,   false },
+    [NODE_CLASS_SWITCH]   = { &lv_switch_class,   lv_switch_create,   NODE_KIND_PLAIN,   false },
+    [NODE_CLASS_DROPDOWN] = { &lv_dropdown_class, lv_dropdown_create, NODE_KIND_OPTIONS, false },
+    [NODE_CLASS_ROLLER]   = { &lv_roller_class,   lv_roller_create,   NODE_KIND_OPTIONS, true  },
+    [NODE_CLASS_CHART]    = { &lv_chart_class,    lv_chart_create,    NODE_KIND_PLAIN,   false },
+    [NODE_CLASS_TABLE]    = { &lv_table_class,    lv_table_create,    NODE_KIND_PLAIN,   false },
+};
+
+/**
+ * @brief 记录的对象标志（按位序编码）
+ */
+static const lv_obj_flag_t node_flags[] = {
+    LV_OBJ_FLAG_HIDDEN,
+    LV_OBJ_FLAG_CLICKABLE,
+    LV_OBJ_FLAG_CHECKABLE,
+    LV_OBJ_FLAG_SCROLLABLE,
+};
+#define NODE_FLAG_COUNT (sizeof(node_flags) / sizeof(node_flags[0]))
+
+/**
+ * @brief 重建控件的领取状态
+ */
+typedef enum {
+    RESTORED_PENDING = 0,     // 等待脚本领取
+    RESTORED_ADOPTED,         // 已由脚本领取
+    RESTORED_REJECTED,        // 与脚本创建的类型不一致，恢复结束时删除
+} AppSysRestoredState_t;
+
+/**
+ * @brief 重建的控件（按前序排列）
+ */
+typedef struct {
+    lv_obj_t* obj;
+    int32_t parent;           // 父控件在数组中的下标，-1 表示屏幕
+    uint8_t cls;              // 类型表下标或 NODE_CLASS_OTHER
+    uint8_t state;            // AppSysRestoredState_t
+} AppSysRestoredNode_t;
+
+// 正在恢复的应用：状态部分在脚本调用 app_declare_state 时才反序列化
+static uint8_t* restore_blob = NULL;
+static AppSysReader_t restore_state;
+static jerry_value_t restore_realm = 0;
+static bool restore_pending = false;
+
+// 正在恢复的应用的重建控件，主脚本执行完后释放
+static lv_obj_t* restore_screen = NULL;
+static AppSysRestoredNode_t* restore_nodes = NULL;
+static uint32_t restore_node_count = 0;
+static uint32_t restore_node_capacity = 0;
+static uint32_t restore_scan_from = 0;        // 之前的控件均已领取或拒绝
+static uint32_t restore_adopted = 0;
+
+/**
+ * @brief 拼接休眠文件路径
+ */
+static void appsys_hibernate_path(const char* app_id, char* path, size_t size) {
+    snprintf(path, size, "%s/%s.bin", APPSYS_HIBERNATE_DIR, app_id);
+}
+
+/********************************** 状态对象 **********************************/
+
+static void appsys_hibernate_put_value(AppSysBuf_t* buf, jerry_value_t value, int depth);
+
+/**
+ * @brief 编码字符串值
+ */
+static void appsys_hibernate_put_js_string(AppSysBuf_t* buf, jerry_value_t str) {
+    jerry_size_t size = jerry_string_size(str, JERRY_ENCODING_UTF8);
+    appsys_buf_put_varint(buf, size);
+    // 直接写入预留空间，避免额外的临时缓冲
+    uint8_t* dst = appsys_buf_reserve(buf, size);
+    if (dst != NULL) {
+        jerry_string_to_buffer(str, JERRY_ENCODING_UTF8, dst, size);
+    }
+    appsys_buf_put_u8(buf, 0);
+}
+
+/**
+ * @brief 编码对象的自有属性
+ */
+static void appsys_hibernate_put_object(AppSysBuf_t* buf, jerry_value_t obj, int depth) {
+    jerry_value_t keys = jerry_object_keys(obj);
+    uint32_t count = jerry_value_is_exception(keys) ? 0 : jerry_array_length(keys);
+    appsys_buf_put_u8(buf, VALUE_TAG_OBJECT);
+    appsys_buf_put_varint(buf, count);
+    for (uint32_t i = 0; i < count; i++) {
+        jerry_value_t key = jerry_object_get_index(keys, i);
+        jerry_value_t val = jerry_object_get(obj, key);
+        appsys_hibernate_put_js_string(buf, key);
+        appsys_hibernate_put_value(buf, val, depth + 1);
+        jerry_value_free(val);
+        jerry_value_free(key);
+    }
+    jerry_value_free(keys);
+}
+
+/**
+ * @brief 按类型标记递归编码 JS 值
+ */
+static void appsys_hibernate_put_value(AppSysBuf_t* buf, jerry_value_t value, int depth) {
+    if (depth > APPSYS_HIBERNATE_MAX_DEPTH || jerry_value_is_undefined(value) || jerry_value_is_function(value)) {
+        appsys_buf_put_u8(buf, VALUE_TAG_UNDEFINED);
+    }
+    else if (jerry_value_is_null(value)) {
+        appsys_buf_put_u8(buf, VALUE_TAG_NULL);
+    }
+    else if (jerry_value_is_boolean(value)) {
+        appsys_buf_put_u8(buf, jerry_value_is_true(value) ? VALUE_TAG_TRUE : VALUE_TAG_FALSE);
+    }
+    else if (jerry_value_is_number(value)) {
+        double d = jerry_value_as_number(value);
+        if (d >= INT32_MIN && d <= INT32_MAX && d == (double)(int32_t)d) {
+            appsys_buf_put_u8(buf, VALUE_TAG_INT);
+            appsys_buf_put_svarint(buf, (int32_t)d);
+        }
+        else {
+            appsys_buf_put_u8(buf, VALUE_TAG_DOUBLE);
+            appsys_buf_put(buf, &d, sizeof(d));
+        }
+    }
+    else if (jerry_value_is_string(value)) {
+        appsys_buf_put_u8(buf, VALUE_TAG_STRING);
+        appsys_hibernate_put_js_string(buf, value);
+    }
+    else if (jerry_value_is_array(value)) {
+        uint32_t len = jerry_array_length(value);
+        appsys_buf_put_u8(buf, VALUE_TAG_ARRAY);
+        appsys_buf_put_varint(buf, len);
+        for (uint32_t i = 0; i < len; i++) {
+            jerry_value_t item = jerry_object_get_index(value, i);
+            appsys_hibernate_put_value(buf, item, depth + 1);
+            jerry_value_free(item);
+        }
+    }
+    else if (jerry_value_is_object(value)) {
+        appsys_hibernate_put_object(buf, value, depth);
+    }
+    else {
+        appsys_buf_put_u8(buf, VALUE_TAG_UNDEFINED);
+    }
+}
+
+/**
+ * @brief 解码 JS 值（在当前 realm 中创建对象）
+ * @return jerry_value_t 调用者负责释放
+ */
+static jerry_value_t appsys_hibernate_get_value(AppSysReader_t* rd, int depth) {
+    if (depth > APPSYS_HIBERNATE_MAX_DEPTH) {
+        rd->error = true;
+        return jerry_undefined();
+    }
+    uint32_t len;
+    const char* str;
+    switch (appsys_reader_u8(rd)) {
+    case VALUE_TAG_NULL:
+        return jerry_null();
+    case VALUE_TAG_FALSE:
+        return jerry_boolean(false);
+    case VALUE_TAG_TRUE:
+        return jerry_boolean(true);
+    case VALUE_TAG_INT:
+        return jerry_number((double)appsys_reader_svarint(rd));
+    case VALUE_TAG_DOUBLE: {
+        double d = 0;
+        const uint8_t* p = appsys_reader_get(rd, sizeof(d));
+        if (p != NULL) {
+            memcpy(&d, p, sizeof(d));
+        }
+        return jerry_number(d);
+    }
+    case VALUE_TAG_STRING:
+        str = appsys_reader_str(rd, &len);
+        return jerry_string((const jerry_char_t*)str, len, JERRY_ENCODING_UTF8);
+    case VALUE_TAG_ARRAY: {
+        uint32_t count = appsys_reader_varint(rd);
+        jerry_value_t arr = jerry_array(0);
+        for (uint32_t i = 0; i < count && !rd->error; i++) {
+            jerry_value_t item = appsys_hibernate_get_value(rd, depth + 1);
+            jerry_value_free(jerry_object_set_index(arr, i, item));
+            jerry_value_free(item);
+        }
+        return arr;
+    }
+    case VALUE_TAG_OBJECT: {
+        uint32_t count = appsys_reader_varint(rd);
+        jerry_value_t obj = jerry_object();
+        for (uint32_t i = 0; i < count && !rd->error; i++) {
+            str = appsys_reader_str(rd, &len);
+            jerry_value_t key = jerry_string((const jerry_char_t*)str, len, JERRY_ENCODING_UTF8);
+            jerry_value_t val = appsys_hibernate_get_value(rd, depth + 1);
+            jerry_value_free(jerry_object_set(obj, key, val));
+            jerry_value_free(val);
+            jerry_value_free(key);
+        }
+        return obj;
+    }
+    default:
+        return jerry_undefined();
+    }
+}
+
+/********************************** 屏幕树 **********************************/
+
+/**
+ * @brief 查找控件对应的类型表下标
+ * @return uint8_t 不在类型表中时返回 NODE_CLASS_OTHER
+ */
+static uint8_t appsys_hibernate_class_index(const lv_obj_t* obj) {
+    const lv_obj_class_t* cls = lv_obj_get_class(obj);
+    for (uint8_t i = 0; i < NODE_CLASS_COUNT; i++) {
+        if (node_classes[i].cls == cls) {
+            return i;
+        }
+    }
+    return NODE_CLASS_OTHER;
+}
+
+/**
+ * @brief 编码控件及其子控件
+ */
+static void appsys_hibernate_put_node(AppSysBuf_t* buf, lv_obj_t* obj, int depth, uint32_t* nodes) {
+    uint8_t index = appsys_hibernate_class_index(obj);
+    (*nodes)++;
+
+    appsys_buf_put_u8(buf, index);
+    appsys_buf_put_svarint(buf, lv_obj_get_x(obj));
+    appsys_buf_put_svarint(buf, lv_obj_get_y(obj));
+    appsys_buf_put_svarint(buf, lv_obj_get_width(obj));
+    appsys_buf_put_svarint(buf, lv_obj_get_height(obj));
+
+    uint32_t flags = 0;
+    for (uint32_t i = 0; i < NODE_FLAG_COUNT; i++) {
+        if (lv_obj_has_flag(obj, node_flags[i])) {
+            flags |= 1u << i;
+        }
+    }
+    appsys_buf_put_varint(buf, flags);
+    appsys_buf_put_varint(buf, lv_obj_get_state(obj));
+
+    // 类型表之外的控件只记录占位所需的通用属性，内部结构由其自身决定，不记录子控件
+    if (index == NODE_CLASS_OTHER) {
+        return;
+    }
+    const AppSysNodeClass_t* nc = &node_classes[index];
+    switch (nc->kind) {
+    case NODE_KIND_TEXT:
+        if (index == NODE_CLASS_LABEL) {
+            appsys_buf_put_str(buf, lv_label_get_text(obj));
+        }
+        else if (index == NODE_CLASS_CHECKBOX) {
+            appsys_buf_put_str(buf, lv_checkbox_get_text(obj));
+        }
+        else {
+            appsys_buf_put_str(buf, lv_textarea_get_text(obj));
+        }
+        break;
+    case NODE_KIND_RANGE:
+        if (index == NODE_CLASS_ARC) {
+            appsys_buf_put_svarint(buf, lv_arc_get_min_value(obj));
+            appsys_buf_put_svarint(buf, lv_arc_get_max_value(obj));
+            appsys_buf_put_svarint(buf, lv_arc_get_value(obj));
+        }
+        else {
+            // 滑块继承自进度条，共用进度条的取值接口
+            appsys_buf_put_svarint(buf, lv_bar_get_min_value(obj));
+            appsys_buf_put_svarint(buf, lv_bar_get_max_value(obj));
+            appsys_buf_put_svarint(buf, lv_bar_get_value(obj));
+        }
+        break;
+    case NODE_KIND_OPTIONS:
+        if (index == NODE_CLASS_DROPDOWN) {
+            appsys_buf_put_str(buf, lv_dropdown_get_options(obj));
+            appsys_buf_put_varint(buf, lv_dropdown_get_selected(obj));
+        }
+        else {
+            appsys_buf_put_str(buf, lv_roller_get_options(obj));
+            appsys_buf_put_varint(buf, lv_roller_get_selected(obj));
+        }
+        break;
+    default:
+        break;
+    }
+
+    uint32_t child_count = (nc->own_children || depth >= APPSYS_HIBERNATE_MAX_DEPTH) ? 0 : lv_obj_get_child_count(obj);
+    appsys_buf_put_varint(buf, child_count);
+    for (uint32_t i = 0; i < child_count; i++) {
+        appsys_hibernate_put_node(buf, lv_obj_get_child(obj, (int32_t)i), depth + 1, nodes);
+    }
+}
+
+/**
+ * @brief 解码控件，在 parent 下重建并追加到重建控件表
+ * @param parent_index 父控件在重建控件表中的下标，-1 表示屏幕
+ */
+static void appsys_hibernate_get_node(AppSysReader_t* rd, lv_obj_t* parent, int32_t parent_index, int depth) {
+    uint8_t index = appsys_reader_u8(rd);
+    if (rd->error || (index >= NODE_CLASS_COUNT && index != NODE_CLASS_OTHER)
+        || depth > APPSYS_HIBERNATE_MAX_DEPTH || restore_node_count >= restore_node_capacity) {
+        rd->error = true;
+        return;
+    }
+    lv_obj_t* obj = index == NODE_CLASS_OTHER ? lv_obj_create(parent) : node_classes[index].create(parent);
+    int32_t self_index = (int32_t)restore_node_count;
+    AppSysRestoredNode_t* node = &restore_nodes[restore_node_count++];
+    node->obj = obj;
+    node->parent = parent_index;
+    node->cls = index;
+    node->state = RESTORED_PENDING;
+
+    int32_t x = appsys_reader_svarint(rd);
+    int32_t y = appsys_reader_svarint(rd);
+    int32_t w = appsys_reader_svarint(rd);
+    int32_t h = appsys_reader_svarint(rd);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+
+    uint32_t flags = appsys_reader_varint(rd);
+    for (uint32_t i = 0; i < NODE_FLAG_COUNT; i++) {
+        if (flags & (1u << i)) {
+            lv_obj_add_flag(obj, node_flags[i]);
+        }
+        else {
+            lv_obj_remove_flag(obj, node_flags[i]);
+        }
+    }
+    lv_obj_add_state(obj, (lv_state_t)appsys_reader_varint(rd));
+
+    if (index == NODE_CLASS_OTHER) {
+        return;
+    }
+    switch (node_classes[index].kind) {
+    case NODE_KIND_TEXT: {
+        const char* text = appsys_reader_str(rd, NULL);
+        if (index == NODE_CLASS_LABEL) {
+            lv_label_set_text(obj, text);
+        }
+        else if (index == NODE_CLASS_CHECKBOX) {
+            lv_checkbox_set_text(obj, text);
+        }
+        else {
+            lv_textarea_set_text(obj, text);
+        }
+        break;
+    }
+    case NODE_KIND_RANGE: {
+        int32_t min = appsys_reader_svarint(rd);
+        int32_t max = appsys_reader_svarint(rd);
+        int32_t value = appsys_reader_svarint(rd);
+        if (index == NODE_CLASS_ARC) {
+            lv_arc_set_range(obj, min, max);
+            lv_arc_set_value(obj, value);
+        }
+        else {
+            lv_bar_set_range(obj, min, max);
+            lv_bar_set_value(obj, value, LV_ANIM_OFF);
+        }
+        break;
+    }
+    case NODE_KIND_OPTIONS: {
+        const char* options = appsys_reader_str(rd, NULL);
+        uint32_t selected = appsys_reader_varint(rd);
+        if (index == NODE_CLASS_DROPDOWN) {
+            lv_dropdown_set_options(obj, options);
+            lv_dropdown_set_selected(obj, selected);
+        }
+        else {
+            lv_roller_set_options(obj, options, LV_ROLLER_MODE_NORMAL);
+            lv_roller_set_selected(obj, selected, LV_ANIM_OFF);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    uint32_t child_count = appsys_reader_varint(rd);
+    for (uint32_t i = 0; i < child_count && !rd->error; i++) {
+        appsys_hibernate_get_node(rd, obj, self_index, depth + 1);
+    }
+}
+
+/**
+ * @brief 为脚本创建的控件领取重建控件：parent 下第一个等待领取的重建控件类型相同时返回它
+ * @param parent 脚本传入的父控件
+ * @param cls 类型表下标
+ * @return lv_obj_t* 领取到的控件，没有可领取的控件时返回 NULL
+ */
+static lv_obj_t* appsys_hibernate_adopt(lv_obj_t* parent, uint8_t cls) {
+    if (restore_nodes == NULL || parent == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = restore_scan_from; i < restore_node_count; i++) {
+        AppSysRestoredNode_t* node = &restore_nodes[i];
+        if (node->state != RESTORED_PENDING) {
+            if (i == restore_scan_from) {
+                restore_scan_from++;
+            }
+            continue;
+        }
+        lv_obj_t* node_parent = node->parent < 0 ? restore_screen : restore_nodes[node->parent].obj;
+        if (node_parent != parent) {
+            continue;
+        }
+        if (node->cls != cls) {
+            // 脚本创建的控件与休眠前不同，这个重建控件不再有对应的脚本句柄
+            node->state = RESTORED_REJECTED;
+            return NULL;
+        }
+        node->state = RESTORED_ADOPTED;
+        restore_adopted++;
+        return node->obj;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 删除未被领取的重建控件并释放重建控件表
+ */
+static void appsys_hibernate_release_nodes(void) {
+    // 只删除父控件仍然保留的那一层，其子控件随之删除
+    for (uint32_t i = 0; i < restore_node_count; i++) {
+        AppSysRestoredNode_t* node = &restore_nodes[i];
+        bool parent_kept = node->parent < 0 || restore_nodes[node->parent].state == RESTORED_ADOPTED;
+        if (node->state != RESTORED_ADOPTED && parent_kept) {
+            lv_obj_delete(node->obj);
+        }
+    }
+    free(restore_nodes);
+    restore_nodes = NULL;
+    restore_node_count = 0;
+    restore_node_capacity = 0;
+    restore_scan_from = 0;
+    restore_adopted = 0;
+    restore_screen = NULL;
+}
+
+/********************************** 休眠 / 恢复 **********************************/
+
+/**
+ * @brief 读取应用声明的状态对象
+ * @return jerry_value_t 未声明时返回 undefined，调用者负责释放
+ */
+static jerry_value_t appsys_hibernate_get_declared_state(jerry_value_t realm) {
+    jerry_value_t prev_realm = jerry_set_realm(realm);
+    jerry_value_t global = jerry_current_realm();
+    jerry_value_t key = jerry_string_sz("__app_state");
+    jerry_value_t state = jerry_object_get(global, key);
+    jerry_value_free(key);
+    jerry_value_free(global);
+    jerry_set_realm(prev_realm);
+    if (jerry_value_is_exception(state)) {
+        jerry_value_free(state);
+        return jerry_undefined();
+    }
+    return state;
+}
+
+/**
+ * @brief 把应用声明的状态与屏幕树写入休眠文件
+ * @param app_id 应用 ID
+ * @param realm 应用的 realm
+ * @param screen 应用的屏幕
+ * @param stats 输出统计信息，可为 NULL
+ * @return true 写入成功
+ */
+bool appsys_hibernate_save(const char* app_id, jerry_value_t realm, lv_obj_t* screen, AppSysHibernateStats_t* stats) {
+    uint64_t start_us = appsys_port_get_time_us();
+    AppSysBuf_t buf;
+    appsys_buf_init(&buf);
+
+    appsys_buf_put(&buf, HIBERNATE_MAGIC, 4);
+    appsys_buf_put_u8(&buf, HIBERNATE_VERSION);
+    appsys_buf_put_str(&buf, app_id);
+
+    // 状态长度先占位，写完后回填
+    size_t state_len_pos = buf.len;
+    appsys_buf_put_u32(&buf, 0);
+    jerry_value_t state = appsys_hibernate_get_declared_state(realm);
+    appsys_hibernate_put_value(&buf, state, 0);
+    jerry_value_free(state);
+    uint32_t state_size = (uint32_t)(buf.len - state_len_pos - 4);
+    if (!buf.oom) {
+        buf.data[state_len_pos + 0] = (uint8_t)state_size;
+        buf.data[state_len_pos + 1] = (uint8_t)(state_size >> 8);
+        buf.data[state_len_pos + 2] = (uint8_t)(state_size >> 16);
+        buf.data[state_len_pos + 3] = (uint8_t)(state_size >> 24);
+    }
+
+    // 控件总数先写出，恢复时据此一次分配重建控件表
+    uint32_t nodes = 0;
+    AppSysBuf_t tree;
+    appsys_buf_init(&tree);
+    lv_obj_update_layout(screen);
+    uint32_t child_count = lv_obj_get_child_count(screen);
+    appsys_buf_put_varint(&tree, child_count);
+    for (uint32_t i = 0; i < child_count; i++) {
+        appsys_hibernate_put_node(&tree, lv_obj_get_child(screen, (int32_t)i), 1, &nodes);
+    }
+    appsys_buf_put_varint(&buf, nodes);
+    appsys_buf_put(&buf, tree.data, tree.len);
+    buf.oom |= tree.oom;
+    appsys_buf_free(&tree);
+
+    bool ok = false;
+    char path[128];
+    appsys_hibernate_path(app_id, path, sizeof(path));
+    if (!buf.oom && appsys_port_make_dir(APPSYS_HIBERNATE_DIR)) {
+        FILE* file = fopen(path, "wb");
+        if (file != NULL) {
+            ok = fwrite(buf.data, 1, buf.len, file) == buf.len;
+            fclose(file);
+        }
+    }
+    if (!ok) {
+        printf("appsys: failed to write %s\n", path);
+    }
+
+    if (stats != NULL) {
+        stats->blob_size = (uint32_t)buf.len;
+        stats->state_size = state_size;
+        stats->tree_nodes = nodes;
+        stats->adopted_nodes = 0;
+        stats->elapsed_us = (uint32_t)(appsys_port_get_time_us() - start_us);
+    }
+    appsys_buf_free(&buf);
+    return ok;
+}
+
+/**
+ * @brief 读取休眠文件并在 screen 上重建屏幕树，状态留待 app_declare_state 取回，
+ *        重建的控件留待主脚本领取
+ * @param app_id 应用 ID
+ * @param realm 恢复后应用所在的 realm
+ * @param screen 应用的屏幕
+ * @param stats 输出统计信息，可为 NULL
+ * @return true 读取成功
+ */
+bool appsys_hibernate_begin_restore(const char* app_id, jerry_value_t realm, lv_obj_t* screen, AppSysHibernateStats_t* stats) {
+    uint64_t start_us = appsys_port_get_time_us();
+    appsys_hibernate_end_restore(NULL);
+
+    char path[128];
+    appsys_hibernate_path(app_id, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    rewind(file);
+    restore_blob = (uint8_t*)malloc(len > 0 ? (size_t)len : 1);
+    if (restore_blob == NULL || len <= 0 || fread(restore_blob, 1, (size_t)len, file) != (size_t)len) {
+        fclose(file);
+        appsys_hibernate_end_restore(NULL);
+        return false;
+    }
+    fclose(file);
+
+    AppSysReader_t rd;
+    appsys_reader_init(&rd, restore_blob, (size_t)len);
+    const uint8_t* magic = appsys_reader_get(&rd, 4);
+    uint8_t version = appsys_reader_u8(&rd);
+    const char* id = appsys_reader_str(&rd, NULL);
+    if (magic == NULL || memcmp(magic, HIBERNATE_MAGIC, 4) != 0 || version != HIBERNATE_VERSION || strcmp(id, app_id) != 0) {
+        printf("appsys: invalid hibernate data %s\n", path);
+        appsys_hibernate_end_restore(NULL);
+        return false;
+    }
+
+    uint32_t state_size = appsys_reader_u32(&rd);
+    const uint8_t* state = appsys_reader_get(&rd, state_size);
+    appsys_reader_init(&restore_state, state, state == NULL ? 0 : state_size);
+
+    uint32_t nodes = appsys_reader_varint(&rd);
+    if (!rd.error && nodes > 0 && nodes <= rd.len) {
+        restore_nodes = (AppSysRestoredNode_t*)malloc(nodes * sizeof(AppSysRestoredNode_t));
+        restore_node_capacity = restore_nodes != NULL ? nodes : 0;
+    }
+    restore_screen = screen;
+    uint32_t child_count = appsys_reader_varint(&rd);
+    for (uint32_t i = 0; i < child_count && !rd.error; i++) {
+        appsys_hibernate_get_node(&rd, screen, -1, 1);
+    }
+    if (rd.error) {
+        // 屏幕树损坏时不做领取，已重建的部分在恢复结束时删除
+        restore_scan_from = restore_node_count;
+    }
+
+    restore_realm = realm;
+    restore_pending = state != NULL;
+
+    if (stats != NULL) {
+        stats->blob_size = (uint32_t)len;
+        stats->state_size = state_size;
+        stats->tree_nodes = restore_node_count;
+        stats->adopted_nodes = 0;
+        stats->elapsed_us = (uint32_t)(appsys_port_get_time_us() - start_us);
+    }
+    return state != NULL;
+}
+
+/**
+ * @brief 结束恢复：丢弃未被取回的状态，删除未被领取的重建控件
+ * @param stats 输出被领取的控件数，可为 NULL
+ */
+void appsys_hibernate_end_restore(AppSysHibernateStats_t* stats) {
+    if (stats != NULL) {
+        stats->adopted_nodes = restore_adopted;
+    }
+    appsys_hibernate_release_nodes();
+    free(restore_blob);
+    restore_blob = NULL;
+    restore_realm = 0;
+    restore_pending = false;
+}
+
+/**
+ * @brief 删除休眠文件
+ * @param app_id 应用 ID
+ */
+void appsys_hibernate_discard(const char* app_id) {
+    char path[128];
+    appsys_hibernate_path(app_id, path, sizeof(path));
+    remove(path);
+}
+
+/********************************** 原生函数定义 **********************************/
+
+/**
+ * @brief app_declare_state(obj)：声明需要在休眠时保存的状态对象。
+ *        应用从休眠中恢复时，休眠前的属性会先合并到 obj 中。
+ * @return 传入的对象
+ */
+static jerry_value_t js_app_declare_state_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (args_count < 1 || !jerry_value_is_object(args_p[0])) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "app_declare_state: expected an object");
+    }
+    jerry_value_t obj = args_p[0];
+    jerry_value_t global = jerry_current_realm();
+
+    if (restore_pending && global == restore_realm) {
+        restore_pending = false;
+        jerry_value_t saved = appsys_hibernate_get_value(&restore_state, 0);
+        if (jerry_value_is_object(saved)) {
+            jerry_value_t keys = jerry_object_keys(saved);
+            uint32_t count = jerry_array_length(keys);
+            for (uint32_t i = 0; i < count; i++) {
+                jerry_value_t key = jerry_object_get_index(keys, i);
+                jerry_value_t val = jerry_object_get(saved, key);
+                jerry_value_free(jerry_object_set(obj, key, val));
+                jerry_value_free(val);
+                jerry_value_free(key);
+            }
+            jerry_value_free(keys);
+        }
+        jerry_value_free(saved);
+    }
+
+    jerry_value_t key = jerry_string_sz("__app_state");
+    jerry_value_free(jerry_object_set(global, key, obj));
+    jerry_value_free(key);
+    jerry_value_free(global);
+    return jerry_value_copy(obj);
+}
+
+/**
+ * @brief 领取版 lv_*_create(parent)：恢复期间优先返回重建的控件，否则照常新建
+ */
+static jerry_value_t appsys_hibernate_create(const jerry_value_t args_p[], jerry_length_t args_count, uint8_t cls) {
+    lv_obj_t* parent = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    lv_obj_t* obj = appsys_hibernate_adopt(parent, cls);
+    if (obj == NULL) {
+        obj = node_classes[cls].create(parent);
+    }
+    return appsys_js_new_ptr(obj);
+}
+
+static jerry_value_t js_obj_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_OBJ);
+}
+
+static jerry_value_t js_label_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_LABEL);
+}
+
+static jerry_value_t js_button_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_BUTTON);
+}
+
+static jerry_value_t js_checkbox_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_CHECKBOX);
+}
+
+static jerry_value_t js_textarea_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_TEXTAREA);
+}
+
+static jerry_value_t js_slider_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_SLIDER);
+}
+
+static jerry_value_t js_bar_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_BAR);
+}
+
+static jerry_value_t js_arc_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_ARC);
+}
+
+static jerry_value_t js_switch_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_SWITCH);
+}
+
+static jerry_value_t js_dropdown_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_DROPDOWN);
+}
+
+static jerry_value_t js_roller_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_ROLLER);
+}
+
+static jerry_value_t js_chart_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_CHART);
+}
+
+static jerry_value_t js_table_create_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_hibernate_create(args_p, args_count, NODE_CLASS_TABLE);
+}
+
+/**
+ * @brief 领取版控件创建函数列表（只在恢复中的 realm 里覆盖绑定中的同名函数）
+ */
+static const AppSysFuncEntry appsys_hibernate_create_funcs[] = {
+    {
+        .name = "lv_obj_create",
+        .handler = js_obj_create_handler
+    },
+    {
+        .name = "lv_label_create",
+        .handler = js_label_create_handler
+    },
+    {
+        .name = "lv_button_create",
+        .handler = js_button_create_handler
+    },
+    {
+        .name = "lv_btn_create",
+        .handler = js_button_create_handler
+    },
+    {
+        .name = "lv_checkbox_create",
+        .handler = js_checkbox_create_handler
+    },
+    {
+        .name = "lv_textarea_create",
+        .handler = js_textarea_create_handler
+    },
+    {
+        .name = "lv_slider_create",
+        .handler = js_slider_create_handler
+    },
+    {
+        .name = "lv_bar_create",
+        .handler = js_bar_create_handler
+    },
+    {
+        .name = "lv_arc_create",
+        .handler = js_arc_create_handler
+    },
+    {
+        .name = "lv_switch_create",
+        .handler = js_switch_create_handler
+    },
+    {
+        .name = "lv_dropdown_create",
+        .handler = js_dropdown_create_handler
+    },
+    {
+        .name = "lv_roller_create",
+        .handler = js_roller_create_handler
+    },
+    {
+        .name = "lv_chart_create",
+        .handler = js_chart_create_handler
+    },
+    {
+        .name = "lv_table_create",
+        .handler = js_table_create_handler
+    }
+};
+
+/**
+ * @brief 休眠相关原生函数列表
+ */
+static const AppSysFuncEntry appsys_hibernate_funcs[] = {
+    {
+        .name = "app_declare_state",
+        .handler = js_app_declare_state_handler
+    },
+};
+
+/**
+ * @brief 将休眠相关函数注册到当前 realm
+ */
+void appsys_hibernate_register_natives(void) {
+    appsys_register_functions(appsys_hibernate_funcs, sizeof(appsys_hibernate_funcs) / sizeof(AppSysFuncEntry));
+
+    // 正在从休眠中恢复的应用：主脚本创建控件时领取重建的控件（需在 lv_binding_init 之后调用）
+    jerry_value_t global = jerry_current_realm();
+    if (restore_nodes != NULL && global == restore_realm) {
+        appsys_register_functions(appsys_hibernate_create_funcs,
+            sizeof(appsys_hibernate_create_funcs) / sizeof(AppSysFuncEntry));
+    }
+    jerry_value_free(global);
+}
@@ -0,0 +1,90 @@
+﻿/**
+ * @file appsys_image.c
+ * @brief 图片解码辅助实现
+ * @author Sab1e
+ * @date 2025-08-23
+ *
+ * 启用对齐的绘制缓冲（LV_DRAW_BUF_STRIDE_ALIGN > 1）时，appsys_image_align_decoders 包装已注册解码器的
+ * open_cb，渲染时按需解码的图片与预热时预解码的图片一样按对齐的行宽输出，而不是保留文件中的紧凑行宽。
+ * 解码器与解码描述符的结构体只在 lvgl_private.h 中可见，相关代码集中在这里，其他模块只用公开接口。
+ */
+
+#include "appsys_image.h"
+#include "lvgl/lvgl.h"
+#include "lvgl/lvgl_private.h"
+#include <stdio.h>
+#include <string.h>
+
+#if LV_DRAW_BUF_STRIDE_ALIGN > 1
+#define IMAGE_MAX_DECODERS      8
+
+/**
+ * @brief 被包装的解码器及其原始 open_cb
+ */
+typedef struct {
+    lv_image_decoder_t* decoder;
+    lv_image_decoder_open_f_t open_cb;
+} AppSysAlignedDecoder_t;
+
+static AppSysAlignedDecoder_t aligned_decoders[IMAGE_MAX_DECODERS];
+static uint32_t aligned_decoder_count = 0;
+
+/**
+ * @brief 包装后的 open_cb：强制按对齐的行宽输出后调用原始 open_cb
+ */
+static lv_result_t appsys_image_aligned_open_cb(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc) {
+    for (uint32_t i = 0; i < aligned_decoder_count; i++) {
+        if (aligned_decoders[i].decoder == decoder) {
+            dsc->args.stride_auto = true;
+            return aligned_decoders[i].open_cb(decoder, dsc);
+        }
+    }
+    return LV_RESULT_INVALID;
+}
+#endif
+
+/**
+ * @brief 让之后的图片解码都按 LV_DRAW_BUF_STRIDE_ALIGN 对齐行宽（需在 lv_init 之后、绘制之前调用）。
+ *        只包装调用时已注册的解码器，未启用对齐时什么也不做
+ * @return uint32_t 包装的解码器数量
+ */
+uint32_t appsys_image_align_decoders(void) {
+#if LV_DRAW_BUF_STRIDE_ALIGN > 1
+    lv_image_decoder_t* decoder = NULL;
+    while ((decoder = lv_image_decoder_get_next(decoder)) != NULL) {
+        if (decoder->open_cb == NULL || decoder->open_cb == appsys_image_aligned_open_cb) {
+            continue;
+        }
+        if (aligned_decoder_count >= IMAGE_MAX_DECODERS) {
+            printf("[image] too many image decoders, %s keeps its packed stride\n",
+                decoder->name != NULL ? decoder->name : "?");
+            continue;
+        }
+        aligned_decoders[aligned_decoder_count].decoder = decoder;
+        aligned_decoders[aligned_decoder_count].open_cb = decoder->open_cb;
+        aligned_decoder_count++;
+        lv_image_decoder_set_open_cb(decoder, appsys_image_aligned_open_cb);
+    }
+    return aligned_decoder_count;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 解码一张图片后立即关闭，解码结果留在图片缓存中。
+ *        启用对齐的绘制缓冲时按对齐的行宽解码，绘制时每行都从对齐的地址开始
+ * @param src 图片源（路径）
+ * @return bool 解码成功
+ */
+bool appsys_image_predecode(const char* src) {
+    lv_image_decoder_args_t args;
+    memset(&args, 0, sizeof(args));
+    args.stride_auto = LV_DRAW_BUF_STRIDE_ALIGN > 1;
+    lv_image_decoder_dsc_t dsc;
+    if (lv_image_decoder_open(&dsc, src, &args) != LV_RESULT_OK) {
+        return false;
+    }
+    lv_image_decoder_close(&dsc);
+    return true;
+}
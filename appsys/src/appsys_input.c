@@ -0,0 +1,332 @@
+﻿/**
+ * @file appsys_input.c
+ * @brief 输入管线实现
+ * @author Sab1e
+ * @date 2025-08-05
+ *
+ * 输入设备默认由各自的定时器独立轮询，每次读取都会单独走一遍 LVGL 的事件处理并分发到 JS。
+ * 这里把读取改为在显示刷新开始（LV_EVENT_REFR_START）时执行一次：
+ * - 指针：一帧内的多次移动只保留最新位置，可选地按速度向前预测一帧（手指停住或样本过期时不预测）；
+ * - 编码器：一帧内的刻度累加后一次下发；
+ * - 延迟：在读取回调中记录样本被读到的时间，在该帧最后一次 flush 完成（LV_EVENT_FLUSH_FINISH）时结算，
+ *   即“读取到刷出”的延迟。样本在驱动中等待被读取的时间（帧同步时最多一帧）不包含在内。
+ */
+
+#include "appsys_input.h"
+#include "appsys_conf.h"
+#include "appsys_port.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief 每个接入管线的输入设备的上下文
+ */
+typedef struct {
+    lv_indev_t* indev;
+    lv_indev_read_cb_t orig_read_cb;   // 驱动原始的读取回调
+    lv_indev_data_t last;              // 上一次下发给 LVGL 的数据
+    lv_point_t prev_point;             // 上上次的真实位置，用于估计速度
+    uint64_t prev_time_us;
+    uint64_t last_time_us;
+    bool has_prev;
+    lv_indev_data_t stash;             // 编码器批处理时暂存的按键状态变化
+    bool has_stash;
+} AppSysInputSlot_t;
+
+static AppSysInputSlot_t input_slots[APPSYS_INPUT_MAX_INDEV];
+static uint32_t input_slot_count = 0;
+static lv_display_t* input_disp = NULL;
+static AppSysInputStats_t input_stats;
+static bool input_predict = APPSYS_INPUT_PREDICT;
+
+static uint64_t frame_start_us = 0;
+static uint32_t frame_interval_us = LV_DEF_REFR_PERIOD * 1000;   // 帧间隔的滑动平均
+static uint64_t pending_sample_us = 0;                            // 尚未显示的最早样本的读取时间
+static uint64_t last_flush_us = 0;                                // 本帧最后一次 flush 完成的时间
+static bool frame_rendered = false;
+
+/**
+ * @brief 查找输入设备对应的上下文
+ * @param indev 输入设备
+ * @return AppSysInputSlot_t* 未接入时返回 NULL
+ */
+static AppSysInputSlot_t* appsys_input_find_slot(lv_indev_t* indev) {
+    for (uint32_t i = 0; i < input_slot_count; i++) {
+        if (input_slots[i].indev == indev) {
+            return &input_slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 记录一个新样本的到达时间（只保留一帧内最早的样本）
+ * @param now_us 当前时间
+ */
+static void appsys_input_mark_sample(uint64_t now_us) {
+    if (pending_sample_us == 0) {
+        pending_sample_us = now_us;
+    }
+}
+
+/**
+ * @brief 按上两次真实样本估计速度，把位置向前预测一帧（指针停住时调用方已清除 has_prev）
+ * @param slot 设备上下文
+ * @param data 要修改的数据
+ * @return true 使用了预测位置
+ */
+static bool appsys_input_predict_point(AppSysInputSlot_t* slot, lv_indev_data_t* data) {
+    if (!slot->has_prev || data->state != LV_INDEV_STATE_PRESSED) {
+        return false;
+    }
+    uint64_t dt = slot->last_time_us - slot->prev_time_us;
+    if (dt == 0 || dt > 2ULL * frame_interval_us) {
+        return false;
+    }
+    int32_t dx = (int32_t)(((int64_t)(data->point.x - slot->prev_point.x) * frame_interval_us) / (int64_t)dt);
+    int32_t dy = (int32_t)(((int64_t)(data->point.y - slot->prev_point.y) * frame_interval_us) / (int64_t)dt);
+    if (dx == 0 && dy == 0) {
+        return false;
+    }
+    // 按距离（而不是分别按坐标轴）限制外推量，保持方向不变
+    int64_t dist2 = (int64_t)dx * dx + (int64_t)dy * dy;
+    if (dist2 > (int64_t)APPSYS_INPUT_PREDICT_MAX_PX * APPSYS_INPUT_PREDICT_MAX_PX) {
+        double scale = APPSYS_INPUT_PREDICT_MAX_PX / sqrt((double)dist2);
+        dx = (int32_t)(dx * scale);
+        dy = (int32_t)(dy * scale);
+    }
+
+    int32_t hor_res = lv_display_get_horizontal_resolution(input_disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(input_disp);
+    data->point.x = LV_CLAMP(0, data->point.x + dx, hor_res - 1);
+    data->point.y = LV_CLAMP(0, data->point.y + dy, ver_res - 1);
+    return true;
+}
+
+/**
+ * @brief 处理指针样本：位置未变化时不计为新样本并清除速度，按需预测
+ */
+static void appsys_input_process_pointer(AppSysInputSlot_t* slot, lv_indev_data_t* data, uint64_t now_us) {
+    bool changed = data->state != slot->last.state
+        || data->point.x != slot->last.point.x
+        || data->point.y != slot->last.point.y;
+
+    if (changed) {
+        input_stats.pointer_samples++;
+        appsys_input_mark_sample(now_us);
+        if (data->state == LV_INDEV_STATE_PRESSED && slot->last.state == LV_INDEV_STATE_PRESSED) {
+            slot->prev_point = slot->last.point;
+            slot->prev_time_us = slot->last_time_us;
+            slot->has_prev = true;
+        }
+        else {
+            slot->has_prev = false;
+        }
+        slot->last = *data;
+        slot->last_time_us = now_us;
+    }
+    else {
+        // 手指按住不动：速度归零，不再按旧速度漂移
+        slot->has_prev = false;
+    }
+
+    if (input_predict && appsys_input_predict_point(slot, data)) {
+        input_stats.predicted++;
+    }
+}
+
+/**
+ * @brief 处理编码器样本：驱动要求继续读取时在本帧内一次性读完并累加刻度
+ */
+static void appsys_input_process_encoder(AppSysInputSlot_t* slot, lv_indev_data_t* data, uint64_t now_us) {
+    int32_t enc_diff = data->enc_diff;
+
+    while (data->continue_reading) {
+        lv_indev_data_t next;
+        lv_memzero(&next, sizeof(next));
+        slot->orig_read_cb(slot->indev, &next);
+        if (next.state != data->state) {
+            // 按键状态变化必须单独下发，暂存到 LVGL 的下一次读取
+            slot->stash = next;
+            slot->has_stash = true;
+            break;
+        }
+        enc_diff += next.enc_diff;
+        data->continue_reading = next.continue_reading;
+    }
+    data->enc_diff = enc_diff;
+    data->continue_reading = slot->has_stash;
+
+    if (data->enc_diff != 0 || data->state != slot->last.state) {
+        input_stats.encoder_batches++;
+        input_stats.encoder_ticks += LV_ABS(data->enc_diff);
+        appsys_input_mark_sample(now_us);
+    }
+    slot->last = *data;
+}
+
+/**
+ * @brief 替换后的读取回调：调用驱动原始回调后按设备类型处理
+ */
+static void appsys_input_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {
+    AppSysInputSlot_t* slot = appsys_input_find_slot(indev);
+    if (slot == NULL || slot->orig_read_cb == NULL) {
+        return;
+    }
+    if (slot->has_stash) {
+        *data = slot->stash;
+        slot->has_stash = false;
+    }
+    else {
+        slot->orig_read_cb(indev, data);
+    }
+
+    uint64_t now_us = appsys_port_get_time_us();
+    switch (lv_indev_get_type(indev)) {
+    case LV_INDEV_TYPE_POINTER:
+        appsys_input_process_pointer(slot, data, now_us);
+        break;
+    case LV_INDEV_TYPE_ENCODER:
+        appsys_input_process_encoder(slot, data, now_us);
+        break;
+    default:
+        if (data->state != slot->last.state || data->key != slot->last.key) {
+            appsys_input_mark_sample(now_us);
+        }
+        slot->last = *data;
+        break;
+    }
+}
+
+#if APPSYS_INPUT_REPORT_PERIOD > 0
+/**
+ * @brief 打印输入延迟统计
+ */
+static void appsys_input_report_cb(lv_timer_t* timer) {
+    LV_UNUSED(timer);
+    if (input_stats.latency_count == 0) {
+        return;
+    }
+    printf("[input] frames=%u samples=%u predicted=%u enc_batches=%u enc_ticks=%d "
+        "read-to-flush latency avg=%u us max=%u us (n=%u)\n",
+        input_stats.frames,
+        input_stats.pointer_samples,
+        input_stats.predicted,
+        input_stats.encoder_batches,
+        input_stats.encoder_ticks,
+        (uint32_t)(input_stats.latency_sum_us / input_stats.latency_count),
+        input_stats.latency_max_us,
+        input_stats.latency_count);
+}
+#endif
+
+/**
+ * @brief 显示事件回调：帧开始时读取输入，记录 flush 完成时间，帧结束时结算延迟
+ */
+static void appsys_input_display_event_cb(lv_event_t* e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    uint64_t now_us = appsys_port_get_time_us();
+
+    if (code == LV_EVENT_REFR_START) {
+        if (frame_start_us != 0) {
+            uint32_t interval = (uint32_t)(now_us - frame_start_us);
+            frame_interval_us = (frame_interval_us * 7 + interval) / 8;
+        }
+        frame_start_us = now_us;
+        frame_rendered = false;
+        input_stats.frames++;
+#if APPSYS_INPUT_FRAME_SYNC
+        for (uint32_t i = 0; i < input_slot_count; i++) {
+            lv_indev_read(input_slots[i].indev);
+        }
+#endif
+    }
+    else if (code == LV_EVENT_FLUSH_FINISH) {
+        // 局部刷新模式下一帧可能有多次 flush，以最后一次为准
+        frame_rendered = true;
+        last_flush_us = now_us;
+    }
+    else if (code == LV_EVENT_REFR_READY) {
+        if (frame_rendered && pending_sample_us != 0 && last_flush_us >= pending_sample_us) {
+            uint32_t latency = (uint32_t)(last_flush_us - pending_sample_us);
+            input_stats.latency_count++;
+            input_stats.latency_sum_us += latency;
+            if (latency > input_stats.latency_max_us) {
+                input_stats.latency_max_us = latency;
+            }
+        }
+        // 本帧没有任何重绘时，说明该样本不会产生画面变化，同样不计入延迟
+        pending_sample_us = 0;
+    }
+}
+
+/**
+ * @brief 初始化输入管线
+ * @param disp 输入所属的显示器，读取与延迟测量都跟随它的刷新
+ */
+void appsys_input_init(lv_display_t* disp) {
+    input_disp = disp;
+    input_slot_count = 0;
+    lv_memzero(input_slots, sizeof(input_slots));
+    lv_memzero(&input_stats, sizeof(input_stats));
+
+    lv_display_add_event_cb(disp, appsys_input_display_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, appsys_input_display_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+    lv_display_add_event_cb(disp, appsys_input_display_event_cb, LV_EVENT_REFR_READY, NULL);
+
+#if APPSYS_INPUT_REPORT_PERIOD > 0
+    lv_timer_create(appsys_input_report_cb, APPSYS_INPUT_REPORT_PERIOD, NULL);
+#endif
+}
+
+/**
+ * @brief 把输入设备接入管线，替换其读取回调
+ * @param indev 由驱动创建的输入设备
+ * @return true 接入成功；false 管线已满或未初始化
+ */
+bool appsys_input_attach(lv_indev_t* indev) {
+    if (input_disp == NULL || indev == NULL || input_slot_count >= APPSYS_INPUT_MAX_INDEV) {
+        return false;
+    }
+    if (appsys_input_find_slot(indev) != NULL) {
+        return true;
+    }
+
+    AppSysInputSlot_t* slot = &input_slots[input_slot_count++];
+    lv_memzero(slot, sizeof(*slot));
+    slot->indev = indev;
+    slot->orig_read_cb = lv_indev_get_read_cb(indev);
+    lv_indev_set_read_cb(indev, appsys_input_read_cb);
+
+#if APPSYS_INPUT_FRAME_SYNC
+    // 关闭设备自身的读取定时器，改为每帧由显示刷新驱动
+    lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
+#endif
+    return true;
+}
+
+/**
+ * @brief 运行时开关指针位置预测
+ * @param enable 是否启用
+ */
+void appsys_input_set_predict(bool enable) {
+    input_predict = enable;
+}
+
+/**
+ * @brief 获取统计信息
+ * @param stats 输出
+ */
+void appsys_input_get_stats(AppSysInputStats_t* stats) {
+    if (stats != NULL) {
+        *stats = input_stats;
+    }
+}
+
+/**
+ * @brief 清空统计信息
+ */
+void appsys_input_reset_stats(void) {
+    lv_memzero(&input_stats, sizeof(input_stats));
+}
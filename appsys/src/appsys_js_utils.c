@@ -0,0 +1,129 @@
+﻿/**
+ * @file appsys_js_utils.c
+ * @brief JS 与原生对象互转的辅助函数实现
+ * @author Sab1e
+ * @date 2025-08-06
+ *
+ * LVGL 绑定把原生指针保存在 JS 对象的 `__ptr` 属性中（如 lv_obj_t*、lv_style_t*），
+ * appsys 中的原生函数统一通过这里读写，避免每个模块各自拼属性名。
+ */
+
+#include "appsys_js_utils.h"
+#include <string.h>
+
+static jerry_value_t key_ptr = 0;     // 缓存的 "__ptr" 属性名
+
+/**
+ * @brief 初始化缓存的属性名（需在 jerry_init 之后调用）
+ */
+void appsys_js_utils_init(void) {
+    key_ptr = jerry_string_sz("__ptr");
+}
+
+/**
+ * @brief 释放缓存的属性名（需在 jerry_cleanup 之前调用）
+ */
+void appsys_js_utils_deinit(void) {
+    if (key_ptr != 0) {
+        jerry_value_free(key_ptr);
+        key_ptr = 0;
+    }
+}
+
+/**
+ * @brief 从绑定对象中取出原生指针
+ * @param value JS 对象
+ * @return void* 原生指针，非绑定对象时返回 NULL
+ */
+void* appsys_js_get_ptr(jerry_value_t value) {
+    if (!jerry_value_is_object(value)) {
+        return NULL;
+    }
+    jerry_value_t ptr = jerry_object_get(value, key_ptr);
+    void* result = NULL;
+    if (jerry_value_is_number(ptr)) {
+        result = (void*)(uintptr_t)jerry_value_as_number(ptr);
+    }
+    jerry_value_free(ptr);
+    return result;
+}
+
+/**
+ * @brief 创建一个包装原生指针的 JS 对象，格式与绑定生成的对象一致
+ * @param ptr 原生指针
+ * @return jerry_value_t 新对象，调用者负责释放；ptr 为 NULL 时返回 null
+ */
+jerry_value_t appsys_js_new_ptr(void* ptr) {
+    if (ptr == NULL) {
+        return jerry_null();
+    }
+    jerry_value_t obj = jerry_object();
+    jerry_value_t num = jerry_number((double)(uintptr_t)ptr);
+    jerry_value_free(jerry_object_set(obj, key_ptr, num));
+    jerry_value_free(num);
+    return obj;
+}
+
+/**
+ * @brief 读取整数参数
+ * @param args_p 参数数组
+ * @param args_count 参数数量
+ * @param index 参数下标
+ * @param def 参数缺失或不是数字时的默认值
+ * @return int32_t 参数值
+ */
+int32_t appsys_js_get_int(const jerry_value_t args_p[], jerry_length_t args_count, jerry_length_t index, int32_t def) {
+    if (index >= args_count || !jerry_value_is_number(args_p[index])) {
+        return def;
+    }
+    return (int32_t)jerry_value_as_int32(args_p[index]);
+}
+
+/**
+ * @brief 在对象上定义只读属性（不可写、不可配置、可枚举），已存在的同名属性被替换
+ * @param obj JS 对象
+ * @param key 属性名
+ * @param value 属性值（不会被释放）
+ */
+void appsys_js_define_const(jerry_value_t obj, jerry_value_t key, jerry_value_t value) {
+    jerry_property_descriptor_t desc = jerry_property_descriptor();
+    desc.flags |= JERRY_PROP_IS_VALUE_DEFINED
+        | JERRY_PROP_IS_WRITABLE_DEFINED
+        | JERRY_PROP_IS_CONFIGURABLE_DEFINED
+        | JERRY_PROP_IS_ENUMERABLE_DEFINED | JERRY_PROP_IS_ENUMERABLE;
+    desc.value = jerry_value_copy(value);
+    jerry_value_free(jerry_object_define_own_prop(obj, key, &desc));
+    jerry_property_descriptor_free(&desc);
+}
+
+/**
+ * @brief 把对象上名字以 prefix 开头、值为数字的属性全部改为只读
+ * @param obj JS 对象
+ * @param prefix 属性名前缀
+ * @return uint32_t 处理的属性数量
+ */
+uint32_t appsys_js_freeze_numbers(jerry_value_t obj, const char* prefix) {
+    size_t prefix_len = strlen(prefix);
+    jerry_value_t keys = jerry_object_keys(obj);
+    uint32_t count = jerry_array_length(keys);
+    uint32_t frozen = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        jerry_value_t key = jerry_object_get_index(keys, i);
+        jerry_char_t name[64];
+        jerry_size_t size = jerry_string_size(key, JERRY_ENCODING_UTF8);
+        if (size >= prefix_len && size < sizeof(name)) {
+            jerry_string_to_buffer(key, JERRY_ENCODING_UTF8, name, size);
+            if (memcmp(name, prefix, prefix_len) == 0) {
+                jerry_value_t value = jerry_object_get(obj, key);
+                if (jerry_value_is_number(value)) {
+                    appsys_js_define_const(obj, key, value);
+                    frozen++;
+                }
+                jerry_value_free(value);
+            }
+        }
+        jerry_value_free(key);
+    }
+    jerry_value_free(keys);
+    return frozen;
+}
@@ -0,0 +1,104 @@
+﻿/**
+ * @file appsys_lazy.c
+ * @brief 延迟编译函数的运行时支持与启动剖析
+ * @author Sab1e
+ * @date 2025-08-17
+ *
+ * bundle.py --lazy 把顶层函数保存为字符串，原位置只留一个转发桩，首次调用时由 bundle 内的
+ * __lazy 编译并调用 appsys_lazy_mark 记录。加载时 JerryScript 只需扫描字符串字面量，
+ * 启动耗时与启动路径上实际执行的代码量相关，而不是整个应用的大小。
+ *
+ * 主脚本执行期间（启动阶段）被编译的函数记为启动函数。APPSYS_LAZY_PROFILE 开启时写入
+ * APPSYS_LAZY_PROFILE_DIR/<app_id>.txt，打包时用 bundle.py --profile 读取，
+ * 这些函数保持立即编译并排在 bundle 最前面。
+ */
+
+#include "appsys_lazy.h"
+#include "appsys_core.h"
+#include "appsys_port.h"
+#include "appsys_buf.h"
+#include "appsys_conf.h"
+#include "jerryscript.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* startup_app_id = NULL;      // 正在启动的应用，NULL 表示不在启动阶段
+static AppSysBuf_t startup_names;              // 启动阶段编译的函数名，每行一个
+static uint32_t startup_count = 0;
+
+/**
+ * @brief 记录一个延迟函数完成编译
+ * @param args_p[0] 函数名
+ */
+static jerry_value_t js_appsys_lazy_mark_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count) {
+    (void)call_info_p;
+    if (startup_app_id == NULL || args_count < 1 || !jerry_value_is_string(args_p[0])) {
+        return jerry_undefined();
+    }
+#if APPSYS_LAZY_PROFILE
+    char name[128];
+    jerry_size_t size = jerry_string_to_buffer(args_p[0], JERRY_ENCODING_UTF8,
+        (jerry_char_t*)name, sizeof(name) - 1);
+    name[size] = '\n';
+    appsys_buf_put(&startup_names, name, size + 1);
+#endif
+    startup_count++;
+    return jerry_undefined();
+}
+
+/**
+ * @brief 延迟编译相关原生函数列表
+ */
+static const AppSysFuncEntry appsys_lazy_funcs[] = {
+    {
+        .name = "appsys_lazy_mark",
+        .handler = js_appsys_lazy_mark_handler
+    },
+};
+
+/**
+ * @brief 将延迟编译相关函数注册到当前 realm
+ */
+void appsys_lazy_register_natives(void) {
+    appsys_register_functions(appsys_lazy_funcs, sizeof(appsys_lazy_funcs) / sizeof(AppSysFuncEntry));
+}
+
+/**
+ * @brief 开始记录应用的启动函数（执行主脚本前调用）
+ * @param app_id 应用 ID，需在 appsys_lazy_end_startup 前保持有效
+ */
+void appsys_lazy_begin_startup(const char* app_id) {
+    appsys_buf_free(&startup_names);
+    appsys_buf_init(&startup_names);
+    startup_count = 0;
+    startup_app_id = app_id;
+}
+
+/**
+ * @brief 结束启动阶段，APPSYS_LAZY_PROFILE 开启时打印并写出启动剖析
+ * @return uint32_t 启动阶段编译的延迟函数数量
+ */
+uint32_t appsys_lazy_end_startup(void) {
+    const char* app_id = startup_app_id;
+    startup_app_id = NULL;
+    if (app_id == NULL || startup_count == 0) {
+        return 0;
+    }
+#if APPSYS_LAZY_PROFILE
+    printf("[lazy] %s: %u functions compiled during startup\n", app_id, startup_count);
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s.txt", APPSYS_LAZY_PROFILE_DIR, app_id);
+    if (!startup_names.oom && appsys_port_make_dir(APPSYS_LAZY_PROFILE_DIR)) {
+        FILE* file = fopen(path, "wb");
+        if (file != NULL) {
+            fwrite(startup_names.data, 1, startup_names.len, file);
+            fclose(file);
+            printf("[lazy] %s: startup profile written to %s\n", app_id, path);
+        }
+    }
+#endif
+    appsys_buf_free(&startup_names);
+    return startup_count;
+}
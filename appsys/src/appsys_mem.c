@@ -0,0 +1,457 @@
+﻿/**
+ * @file appsys_mem.c
+ * @brief 内存占用报告实现
+ * @author Sab1e
+ * @date 2025-08-23
+ *
+ * 从应用的屏幕开始递归遍历对象树，按对象实际持有的结构计算字节数（不含分配器自身的开销）：
+ *   - 控件：类的 instance_size、spec_attr（子对象表、事件表）以及控件自己分配的数据
+ *     （label / dropdown 的文本、chart 的数据点、table 的单元格）；
+ *   - 样式：对象的样式表与本地样式（lv_obj_set_style_* 创建的属性数组），
+ *     多个对象共享的 lv_style_t（主题、JS 创建的样式）不属于任何一个对象，不计入；
+ *   - 用户数据：只统计设置了 user_data 的对象数量，指向的内容由使用者定义，大小未知；
+ *   - JS：appsys_event 为对象保存的回调记录，以及被持有的 JS 包装对象在 JS 堆中的大小；
+ *   - 绘制缓冲：canvas 的缓冲区。显示器的绘制缓冲由所有应用共享，在报告末尾单独列出。
+ *
+ * 报告按驻留应用分别统计（后台挂起的应用同样占用内存），超出 APPSYS_MEM_APP_BUDGET 的应用会被标出。
+ */
+
+#include "appsys_mem.h"
+#include "appsys_core.h"
+#include "appsys_event.h"
+#include "appsys_js_utils.h"
+#include "appsys_str.h"
+#include "lvgl/lvgl.h"
+#include "lvgl/lvgl_private.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief 已知控件类的名称
+ */
+typedef struct {
+    const lv_obj_class_t* class_p;
+    const char* name;
+} AppSysMemClassName_t;
+
+static const AppSysMemClassName_t mem_class_names[] = {
+    { &lv_obj_class,          "obj" },
+    { &lv_label_class,        "label" },
+    { &lv_button_class,       "button" },
+    { &lv_image_class,        "image" },
+#if LV_USE_SLIDER
+    { &lv_slider_class,       "slider" },
+#endif
+#if LV_USE_SWITCH
+    { &lv_switch_class,       "switch" },
+#endif
+#if LV_USE_DROPDOWN
+    { &lv_dropdown_class,     "dropdown" },
+    { &lv_dropdownlist_class, "dropdown_list" },
+#endif
+#if LV_USE_TEXTAREA
+    { &lv_textarea_class,     "textarea" },
+#endif
+#if LV_USE_CHECKBOX
+    { &lv_checkbox_class,     "checkbox" },
+#endif
+#if LV_USE_ARC
+    { &lv_arc_class,          "arc" },
+#endif
+#if LV_USE_BAR
+    { &lv_bar_class,          "bar" },
+#endif
+#if LV_USE_CHART
+    { &lv_chart_class,        "chart" },
+#endif
+#if LV_USE_TABLE
+    { &lv_table_class,        "table" },
+#endif
+#if LV_USE_ROLLER
+    { &lv_roller_class,       "roller" },
+#endif
+#if LV_USE_CANVAS
+    { &lv_canvas_class,       "canvas" },
+#endif
+#if LV_USE_MSGBOX
+    { &lv_msgbox_class,       "msgbox" },
+#endif
+};
+
+static size_t js_wrapper_size = 0;      // 一个 JS 包装对象在 JS 堆中的大小，首次使用时测量
+static bool js_wrapper_measured = false;
+
+/**
+ * @brief 获取控件类型的名称
+ * @param class_p 控件类，为 NULL 时表示未知类型
+ * @return const char* 未知类型返回 "other"
+ */
+const char* appsys_mem_get_type_name(const lv_obj_class_t* class_p) {
+    for (size_t i = 0; i < sizeof(mem_class_names) / sizeof(mem_class_names[0]); i++) {
+        if (mem_class_names[i].class_p == class_p) {
+            return mem_class_names[i].name;
+        }
+    }
+    return "other";
+}
+
+/**
+ * @brief 查找或添加控件类型的统计项，未知类型与超出 APPSYS_MEM_MAX_TYPES 的类型合并为 "other"
+ */
+static AppSysMemType_t* appsys_mem_get_type(AppSysMemFootprint_t* fp, const lv_obj_class_t* class_p) {
+    if (strcmp(appsys_mem_get_type_name(class_p), "other") == 0) {
+        class_p = NULL;
+    }
+    for (uint32_t i = 0; i < fp->type_count; i++) {
+        if (fp->types[i].class_p == class_p) {
+            return &fp->types[i];
+        }
+    }
+    if (fp->type_count >= APPSYS_MEM_MAX_TYPES) {
+        // 最后一项改作 "other"
+        AppSysMemType_t* last = &fp->types[APPSYS_MEM_MAX_TYPES - 1];
+        last->class_p = NULL;
+        return last;
+    }
+    AppSysMemType_t* type = &fp->types[fp->type_count++];
+    memset(type, 0, sizeof(*type));
+    type->class_p = class_p;
+    return type;
+}
+
+/**
+ * @brief 测量 JS 包装对象的大小，JerryScript 未开启内存统计时为 0
+ */
+static size_t appsys_mem_get_js_wrapper_size(void) {
+    if (!js_wrapper_measured) {
+        js_wrapper_measured = true;
+        jerry_heap_stats_t before, after;
+        memset(&before, 0, sizeof(before));
+        memset(&after, 0, sizeof(after));
+        if (jerry_heap_stats(&before)) {
+            jerry_value_t wrapper = appsys_js_new_ptr((void*)&js_wrapper_size);
+            jerry_heap_stats(&after);
+            jerry_value_free(wrapper);
+            js_wrapper_size = after.allocated_bytes > before.allocated_bytes
+                ? after.allocated_bytes - before.allocated_bytes : 0;
+        }
+    }
+    return js_wrapper_size;
+}
+
+/**
+ * @brief 控件自己分配的数据
+ */
+static size_t appsys_mem_widget_data(lv_obj_t* obj) {
+    size_t bytes = 0;
+    if (obj->class_p == &lv_label_class) {
+        lv_label_t* label = (lv_label_t*)obj;
+        if (label->text != NULL && !label->static_txt) {
+            bytes += strlen(label->text) + 1;
+        }
+    }
+#if LV_USE_DROPDOWN
+    else if (obj->class_p == &lv_dropdown_class) {
+        lv_dropdown_t* dropdown = (lv_dropdown_t*)obj;
+        if (dropdown->options != NULL && !dropdown->static_txt) {
+            bytes += strlen(dropdown->options) + 1;
+        }
+    }
+#endif
+#if LV_USE_CHART
+    else if (obj->class_p == &lv_chart_class) {
+        lv_chart_t* chart = (lv_chart_t*)obj;
+        lv_chart_series_t* ser;
+        LV_LL_READ_BACK(&chart->series_ll, ser) {
+            bytes += sizeof(lv_chart_series_t);
+            if (ser->y_points != NULL && !ser->y_ext_buf_assigned) {
+                bytes += chart->point_cnt * sizeof(int32_t);
+            }
+            if (ser->x_points != NULL && !ser->x_ext_buf_assigned) {
+                bytes += chart->point_cnt * sizeof(int32_t);
+            }
+        }
+        lv_chart_cursor_t* cursor;
+        LV_LL_READ_BACK(&chart->cursor_ll, cursor) {
+            bytes += sizeof(lv_chart_cursor_t);
+        }
+    }
+#endif
+#if LV_USE_TABLE
+    else if (obj->class_p == &lv_table_class) {
+        lv_table_t* table = (lv_table_t*)obj;
+        uint32_t cells = table->row_cnt * table->col_cnt;
+        bytes += cells * sizeof(lv_table_cell_t*);
+        bytes += table->row_cnt * sizeof(int32_t) + table->col_cnt * sizeof(int32_t);
+        for (uint32_t i = 0; i < cells; i++) {
+            if (table->cell_data[i] != NULL) {
+                bytes += sizeof(lv_table_cell_t) + strlen(table->cell_data[i]->txt) + 1;
+            }
+        }
+    }
+#endif
+    return bytes;
+}
+
+/**
+ * @brief 对象的样式表与本地样式
+ */
+static size_t appsys_mem_styles(lv_obj_t* obj) {
+    size_t bytes = obj->style_cnt * sizeof(lv_obj_style_t);
+    for (uint32_t i = 0; i < obj->style_cnt; i++) {
+        const lv_obj_style_t* s = &obj->styles[i];
+        if (s->is_local || s->is_trans) {
+            bytes += sizeof(lv_style_t)
+                + s->style->prop_cnt * (sizeof(lv_style_value_t) + sizeof(lv_style_prop_t));
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief 统计单个对象
+ */
+static void appsys_mem_measure_obj(lv_obj_t* obj, AppSysMemFootprint_t* fp) {
+    size_t bytes = obj->class_p->instance_size;
+    if (obj->spec_attr != NULL) {
+        const lv_array_t* events = &obj->spec_attr->event_list.array;
+        bytes += sizeof(lv_obj_spec_attr_t);
+        bytes += obj->spec_attr->child_cnt * sizeof(lv_obj_t*);
+        bytes += events->capacity * events->element_size + events->size * sizeof(lv_event_dsc_t);
+    }
+    bytes += appsys_mem_widget_data(obj);
+
+    AppSysMemType_t* type = appsys_mem_get_type(fp, obj->class_p);
+    type->count++;
+    type->bytes += bytes;
+    fp->objects++;
+    fp->widget_bytes += bytes;
+    fp->style_bytes += appsys_mem_styles(obj);
+    if (obj->user_data != NULL) {
+        fp->user_data_count++;
+    }
+
+    uint32_t wrappers = 0;
+    fp->js_bytes += appsys_event_get_footprint(obj, &wrappers);
+    if (wrappers > 0) {
+        fp->js_bytes += wrappers * appsys_mem_get_js_wrapper_size();
+    }
+
+#if LV_USE_CANVAS
+    if (obj->class_p == &lv_canvas_class) {
+        lv_draw_buf_t* buf = lv_canvas_get_draw_buf(obj);
+        if (buf != NULL) {
+            fp->draw_buf_bytes += buf->data_size;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief 递归统计一棵对象树，结果累加到 fp（首次使用前由调用者清零）
+ * @param root 根对象
+ * @param fp 统计结果
+ */
+void appsys_mem_measure_tree(lv_obj_t* root, AppSysMemFootprint_t* fp) {
+    if (root == NULL) {
+        return;
+    }
+    appsys_mem_measure_obj(root, fp);
+    uint32_t count = lv_obj_get_child_count(root);
+    for (uint32_t i = 0; i < count; i++) {
+        appsys_mem_measure_tree(lv_obj_get_child(root, (int32_t)i), fp);
+    }
+}
+
+/**
+ * @brief 统计结果的总字节数
+ */
+size_t appsys_mem_get_total(const AppSysMemFootprint_t* fp) {
+    return fp->widget_bytes + fp->style_bytes + fp->js_bytes + fp->draw_buf_bytes;
+}
+
+/**
+ * @brief 所有显示器的绘制缓冲大小
+ * @return size_t [byte]
+ */
+size_t appsys_mem_get_display_buffers(void) {
+    size_t bytes = 0;
+    for (lv_display_t* disp = lv_display_get_next(NULL); disp != NULL; disp = lv_display_get_next(disp)) {
+        if (disp->buf_1 != NULL) {
+            bytes += disp->buf_1->data_size;
+        }
+        if (disp->buf_2 != NULL) {
+            bytes += disp->buf_2->data_size;
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief 打印一棵对象树的统计结果
+ */
+static void appsys_mem_print_footprint(const char* title, const AppSysMemFootprint_t* fp) {
+    size_t total = appsys_mem_get_total(fp);
+    printf("%s: %u objects, %u B%s\n", title, fp->objects, (unsigned)total,
+        total > APPSYS_MEM_APP_BUDGET ? "  ** over budget **" : "");
+    for (uint32_t i = 0; i < fp->type_count; i++) {
+        const AppSysMemType_t* type = &fp->types[i];
+        printf("    %-16s %6u x %8.1f B = %8u B\n", appsys_mem_get_type_name(type->class_p), type->count,
+            type->count > 0 ? (double)type->bytes / type->count : 0.0, (unsigned)type->bytes);
+    }
+    printf("    %-16s %25u B\n", "styles", (unsigned)fp->style_bytes);
+    printf("    %-16s %6u objects\n", "user data", fp->user_data_count);
+    printf("    %-16s %25u B\n", "js", (unsigned)fp->js_bytes);
+    printf("    %-16s %25u B\n", "draw buffers", (unsigned)fp->draw_buf_bytes);
+}
+
+/**
+ * @brief 打印所有驻留应用与系统层的内存占用
+ */
+void appsys_mem_print_report(void) {
+    printf("[mem] budget per app: %u B\n", (unsigned)APPSYS_MEM_APP_BUDGET);
+    for (uint32_t i = 0; i < APPSYS_MAX_RESIDENT_APPS; i++) {
+        lv_obj_t* screen = NULL;
+        const ApplicationPackage_t* app = appsys_get_resident_app(i, &screen);
+        if (app == NULL) {
+            continue;
+        }
+        AppSysMemFootprint_t fp;
+        memset(&fp, 0, sizeof(fp));
+        appsys_mem_measure_tree(screen, &fp);
+        appsys_mem_print_footprint(app->app_id, &fp);
+    }
+
+    AppSysMemFootprint_t sys;
+    memset(&sys, 0, sizeof(sys));
+    appsys_mem_measure_tree(lv_layer_top(), &sys);
+    appsys_mem_measure_tree(lv_layer_sys(), &sys);
+    appsys_mem_print_footprint("system layers", &sys);
+    printf("display draw buffers: %u B (shared)\n", (unsigned)appsys_mem_get_display_buffers());
+
+    jerry_heap_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    if (jerry_heap_stats(&stats)) {
+        printf("js heap: %u / %u B, peak %u B (shared)\n", (unsigned)stats.allocated_bytes,
+            (unsigned)stats.size, (unsigned)stats.peak_allocated_bytes);
+    }
+}
+
+/********************************** 原生函数定义 **********************************/
+
+static void appsys_mem_set_number(jerry_value_t obj, const char* name, double value) {
+    jerry_value_t key = jerry_string_sz(name);
+    jerry_value_t val = jerry_number(value);
+    jerry_value_free(jerry_object_set(obj, key, val));
+    jerry_value_free(val);
+    jerry_value_free(key);
+}
+
+/**
+ * @brief mem_report([app_id]) 返回应用的内存占用，默认为调用者所在的应用：
+ *        { app_id, objects, total, styles, user_data（对象数量）, js, draw_buffers, budget,
+ *          widgets: { label: { count, bytes }, ... } }，应用未驻留时返回 null
+ */
+static jerry_value_t js_mem_report(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    const ApplicationPackage_t* app = NULL;
+    if (args_count > 0 && jerry_value_is_string(args_p[0])) {
+        char app_id[64];
+        snprintf(app_id, sizeof(app_id), "%s", appsys_str_get(args_p[0], NULL));
+        for (uint32_t i = 0; i < APPSYS_MAX_RESIDENT_APPS && app == NULL; i++) {
+            const ApplicationPackage_t* p = appsys_get_resident_app(i, NULL);
+            if (p != NULL && strcmp(p->app_id, app_id) == 0) {
+                app = p;
+            }
+        }
+    }
+    else {
+        jerry_value_t realm = jerry_current_realm();
+        app = appsys_get_package(realm);
+        jerry_value_free(realm);
+    }
+
+    lv_obj_t* screen = NULL;
+    for (uint32_t i = 0; i < APPSYS_MAX_RESIDENT_APPS && app != NULL; i++) {
+        lv_obj_t* s = NULL;
+        if (appsys_get_resident_app(i, &s) == app) {
+            screen = s;
+            break;
+        }
+    }
+    if (screen == NULL) {
+        return jerry_null();
+    }
+
+    AppSysMemFootprint_t fp;
+    memset(&fp, 0, sizeof(fp));
+    appsys_mem_measure_tree(screen, &fp);
+
+    jerry_value_t result = jerry_object();
+    jerry_value_t key = jerry_string_sz("app_id");
+    jerry_value_t val = jerry_string_sz(app->app_id);
+    jerry_value_free(jerry_object_set(result, key, val));
+    jerry_value_free(val);
+    jerry_value_free(key);
+    appsys_mem_set_number(result, "objects", fp.objects);
+    appsys_mem_set_number(result, "total", (double)appsys_mem_get_total(&fp));
+    appsys_mem_set_number(result, "styles", (double)fp.style_bytes);
+    appsys_mem_set_number(result, "user_data", fp.user_data_count);
+    appsys_mem_set_number(result, "js", (double)fp.js_bytes);
+    appsys_mem_set_number(result, "draw_buffers", (double)fp.draw_buf_bytes);
+    appsys_mem_set_number(result, "budget", APPSYS_MEM_APP_BUDGET);
+
+    jerry_value_t widgets = jerry_object();
+    for (uint32_t i = 0; i < fp.type_count; i++) {
+        jerry_value_t entry = jerry_object();
+        appsys_mem_set_number(entry, "count", fp.types[i].count);
+        appsys_mem_set_number(entry, "bytes", (double)fp.types[i].bytes);
+        key = jerry_string_sz(appsys_mem_get_type_name(fp.types[i].class_p));
+        jerry_value_free(jerry_object_set(widgets, key, entry));
+        jerry_value_free(key);
+        jerry_value_free(entry);
+    }
+    key = jerry_string_sz("widgets");
+    jerry_value_free(jerry_object_set(result, key, widgets));
+    jerry_value_free(key);
+    jerry_value_free(widgets);
+    return result;
+}
+
+/**
+ * @brief mem_print_report() 在控制台打印所有驻留应用的内存占用
+ */
+static jerry_value_t js_mem_print_report(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    (void)args_p;
+    (void)args_count;
+    appsys_mem_print_report();
+    return jerry_undefined();
+}
+
+/**
+ * @brief 内存报告原生函数列表
+ */
+static const AppSysFuncEntry appsys_mem_funcs[] = {
+    {
+        .name = "mem_report",
+        .handler = js_mem_report
+    },
+    {
+        .name = "mem_print_report",
+        .handler = js_mem_print_report
+    },
+};
+
+/**
+ * @brief 将内存报告函数注册到当前 realm
+ */
+void appsys_mem_register_natives(void) {
+    appsys_register_functions(appsys_mem_funcs, sizeof(appsys_mem_funcs) / sizeof(AppSysFuncEntry));
+}
@@ -0,0 +1,385 @@
+﻿/**
+ * @file appsys_module.c
+ * @brief ES 模块加载实现
+ * @author Sab1e
+ * @date 2025-08-16
+ *
+ * 应用包声明 mainjs_is_module 后，main.js 作为 ES 模块执行，import 按以下规则解析：
+ *   - "./x.js"、"../x.js" 等相对路径：相对于引用方所在目录，在应用包的 modules 表中查找；
+ *     系统模块中的相对路径在系统模块目录中查找
+ *   - "name" 等裸名称：系统模块，对应 APPSYS_MODULE_DIR/name.js
+ *
+ * 应用模块按 (realm, 路径) 缓存，同一应用内多次 import 得到同一个模块实例，应用退出时释放。
+ * 系统模块在专用的系统 realm 中解析和求值，整个 VM 生命周期内只加载一次，所有应用共享同一个
+ * 模块实例（包括其中的模块级状态）。系统模块的函数在系统 realm 中运行，其中创建的定时器等资源
+ * 不随应用退出释放，系统模块应以导出纯函数和常量为主。
+ *
+ * JerryScript 的快照不支持模块，模块记录本身就是编译结果的缓存：系统模块只在首次 import 时
+ * 读取文件并解析一次，之后的应用直接链接已求值的模块。
+ */
+
+#include "appsys_module.h"
+#include "appsys_conf.h"
+#include "utlist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 已加载的模块
+ */
+typedef struct AppSysModule {
+    char path[APPSYS_MODULE_PATH_MAX];  // 相对应用包根目录或系统模块目录的规范化路径
+    bool is_system;                     // 系统模块（所有 realm 共享）
+    jerry_value_t owner;                // 所属应用的 realm（不持有引用），系统模块无效
+    jerry_value_t module;
+    struct AppSysModule* next;
+} AppSysModule_t;
+
+/**
+ * @brief 一次链接过程的上下文
+ */
+typedef struct {
+    const ApplicationPackage_t* app;
+    jerry_value_t realm;
+} AppSysModuleLink_t;
+
+static AppSysModule_t* module_cache = NULL;
+static jerry_value_t system_realm;
+static bool system_realm_ready = false;
+
+/**
+ * @brief 抛出带格式的 Error
+ */
+static jerry_value_t appsys_module_throw(const char* fmt, const char* arg) {
+    char msg[APPSYS_MODULE_PATH_MAX + 64];
+    snprintf(msg, sizeof(msg), fmt, arg);
+    return jerry_throw_sz(JERRY_ERROR_COMMON, msg);
+}
+
+/**
+ * @brief 把 base 所在目录与 spec 拼接并规范化（处理 . 与 ..）
+ * @param base 引用方路径，NULL 表示根目录
+ * @param spec 引用路径
+ * @param out 输出缓冲区，大小为 APPSYS_MODULE_PATH_MAX
+ * @return bool 路径超长或越出根目录时返回 false
+ */
+static bool appsys_module_join(const char* base, const char* spec, char* out) {
+    char buf[APPSYS_MODULE_PATH_MAX * 2];
+    size_t len = 0;
+
+    if (base != NULL && spec[0] != '/') {
+        const char* slash = strrchr(base, '/');
+        len = slash != NULL ? (size_t)(slash - base) + 1 : 0;
+        if (len >= sizeof(buf)) {
+            return false;
+        }
+        memcpy(buf, base, len);
+    }
+    if (len + strlen(spec) >= sizeof(buf)) {
+        return false;
+    }
+    strcpy(buf + len, spec);
+
+    // 逐段写入 out，遇到 .. 回退一段
+    size_t out_len = 0;
+    char* seg = buf;
+    while (seg != NULL) {
+        char* next = strchr(seg, '/');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        if (seg[0] == '\0' || strcmp(seg, ".") == 0) {
+            // 跳过空段与当前目录
+        }
+        else if (strcmp(seg, "..") == 0) {
+            if (out_len == 0) {
+                return false;
+            }
+            while (out_len > 0 && out[out_len - 1] != '/') {
+                out_len--;
+            }
+            if (out_len > 0) {
+                out_len--;
+            }
+        }
+        else {
+            size_t seg_len = strlen(seg);
+            if (out_len + seg_len + 2 > APPSYS_MODULE_PATH_MAX) {
+                return false;
+            }
+            if (out_len > 0) {
+                out[out_len++] = '/';
+            }
+            memcpy(out + out_len, seg, seg_len);
+            out_len += seg_len;
+        }
+        seg = next;
+    }
+    out[out_len] = '\0';
+    return out_len > 0;
+}
+
+/**
+ * @brief 在缓存中查找模块
+ * @param is_system 查找系统模块
+ * @param owner 应用 realm（查找应用模块时使用）
+ * @param path 规范化路径
+ */
+static AppSysModule_t* appsys_module_find(bool is_system, jerry_value_t owner, const char* path) {
+    AppSysModule_t* entry;
+    LL_FOREACH(module_cache, entry) {
+        if (entry->is_system == is_system && (is_system || entry->owner == owner)
+            && strcmp(entry->path, path) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 按模块对象查找缓存记录（解析相对路径时确定引用方位置）
+ */
+static AppSysModule_t* appsys_module_find_value(jerry_value_t module) {
+    AppSysModule_t* entry;
+    LL_FOREACH(module_cache, entry) {
+        if (entry->module == module) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 以模块方式解析源码
+ * @param path 模块路径，用作异常信息中的源文件名
+ * @param source 源码
+ * @param size 源码长度 [byte]
+ * @param is_system 系统模块，在系统 realm 中解析
+ * @param owner 应用 realm
+ * @return jerry_value_t 成功时返回缓存中的模块（新引用）
+ */
+static jerry_value_t appsys_module_parse(const char* path, const char* source, size_t size,
+    bool is_system, jerry_value_t owner) {
+    jerry_parse_options_t opts;
+    opts.options = JERRY_PARSE_MODULE | JERRY_PARSE_HAS_SOURCE_NAME;
+    opts.source_name = jerry_string_sz(path);
+
+    jerry_value_t module;
+    if (is_system) {
+        // 系统模块的求值 realm 即解析时的 realm
+        jerry_value_t prev_realm = jerry_set_realm(system_realm);
+        module = jerry_parse((const jerry_char_t*)source, size, &opts);
+        jerry_set_realm(prev_realm);
+    }
+    else {
+        module = jerry_parse((const jerry_char_t*)source, size, &opts);
+    }
+    jerry_value_free(opts.source_name);
+    if (jerry_value_is_exception(module)) {
+        return module;
+    }
+
+    AppSysModule_t* entry = (AppSysModule_t*)calloc(1, sizeof(AppSysModule_t));
+    if (entry == NULL) {
+        jerry_value_free(module);
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "Out of memory");
+    }
+    strcpy(entry->path, path);
+    entry->is_system = is_system;
+    entry->owner = owner;
+    entry->module = module;
+    LL_PREPEND(module_cache, entry);
+    return jerry_value_copy(module);
+}
+
+/**
+ * @brief 加载应用包中的模块
+ */
+static jerry_value_t appsys_module_load_app(const AppSysModuleLink_t* link, const char* path) {
+    AppSysModule_t* entry = appsys_module_find(false, link->realm, path);
+    if (entry != NULL) {
+        return jerry_value_copy(entry->module);
+    }
+    const ApplicationPackage_t* app = link->app;
+    for (uint32_t i = 0; i < app->module_count; i++) {
+        const char* name = app->modules[i].path;
+        // 包内路径允许带 "./" 前缀
+        if (strncmp(name, "./", 2) == 0) {
+            name += 2;
+        }
+        if (strcmp(name, path) == 0) {
+            const char* source = app->modules[i].source;
+            return appsys_module_parse(path, source, strlen(source), false, link->realm);
+        }
+    }
+    return appsys_module_throw("Cannot find module '%s' in app package", path);
+}
+
+/**
+ * @brief 加载系统模块，首次加载时读取 APPSYS_MODULE_DIR 下的文件
+ */
+static jerry_value_t appsys_module_load_system(const char* path) {
+    AppSysModule_t* entry = appsys_module_find(true, 0, path);
+    if (entry != NULL) {
+        return jerry_value_copy(entry->module);
+    }
+
+    char file_path[APPSYS_MODULE_PATH_MAX + sizeof(APPSYS_MODULE_DIR) + 1];
+    snprintf(file_path, sizeof(file_path), "%s/%s", APPSYS_MODULE_DIR, path);
+    FILE* file = fopen(file_path, "rb");
+    if (file == NULL) {
+        return appsys_module_throw("Cannot find system module '%s'", path);
+    }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* source = len > 0 ? (char*)malloc((size_t)len) : NULL;
+    if (source == NULL || fread(source, 1, (size_t)len, file) != (size_t)len) {
+        fclose(file);
+        free(source);
+        return appsys_module_throw("Cannot read system module '%s'", path);
+    }
+    fclose(file);
+
+    if (!system_realm_ready) {
+        system_realm = appsys_create_system_realm();
+        system_realm_ready = true;
+    }
+    // 解析后源码已复制进字节码，文件内容不再需要
+    jerry_value_t module = appsys_module_parse(path, source, (size_t)len, true, 0);
+    free(source);
+    return module;
+}
+
+/**
+ * @brief jerry_module_link 的解析回调
+ * @param specifier import 中的模块名
+ * @param referrer 引用方模块
+ * @param user_p AppSysModuleLink_t
+ */
+static jerry_value_t appsys_module_resolve_cb(const jerry_value_t specifier, const jerry_value_t referrer,
+    void* user_p) {
+    const AppSysModuleLink_t* link = (const AppSysModuleLink_t*)user_p;
+    char spec[APPSYS_MODULE_PATH_MAX];
+    char path[APPSYS_MODULE_PATH_MAX];
+
+    jerry_size_t size = jerry_string_to_buffer(specifier, JERRY_ENCODING_UTF8,
+        (jerry_char_t*)spec, sizeof(spec) - 1);
+    spec[size] = '\0';
+
+    AppSysModule_t* from = appsys_module_find_value(referrer);
+    bool relative = spec[0] == '.' || spec[0] == '/';
+
+    if (relative) {
+        if (!appsys_module_join(from != NULL ? from->path : NULL, spec, path)) {
+            return appsys_module_throw("Invalid module path '%s'", spec);
+        }
+        if (from != NULL && from->is_system) {
+            return appsys_module_load_system(path);
+        }
+        return appsys_module_load_app(link, path);
+    }
+
+    // 裸名称：系统模块，省略扩展名时补 .js
+    if (!appsys_module_join(NULL, spec, path)) {
+        return appsys_module_throw("Invalid module name '%s'", spec);
+    }
+    const char* base = strrchr(path, '/');
+    if (strchr(base != NULL ? base : path, '.') == NULL) {
+        if (strlen(path) + 4 > sizeof(path)) {
+            return appsys_module_throw("Invalid module name '%s'", spec);
+        }
+        strcat(path, ".js");
+    }
+    return appsys_module_load_system(path);
+}
+
+/**
+ * @brief 删除求值失败的系统模块，下次 import 时重新加载
+ */
+static void appsys_module_drop_failed_system(void) {
+    AppSysModule_t* entry;
+    AppSysModule_t* tmp;
+    LL_FOREACH_SAFE(module_cache, entry, tmp) {
+        if (entry->is_system && jerry_module_state(entry->module) == JERRY_MODULE_STATE_ERROR) {
+            LL_DELETE(module_cache, entry);
+            jerry_value_free(entry->module);
+            free(entry);
+        }
+    }
+}
+
+/**
+ * @brief 在当前 realm 中以 ES 模块方式执行应用的 main.js
+ * @param app 应用包
+ * @return jerry_value_t 求值结果或异常，调用方释放
+ */
+jerry_value_t appsys_module_run_main(const ApplicationPackage_t* app) {
+    if (!jerry_feature_enabled(JERRY_FEATURE_MODULE)) {
+        return jerry_throw_sz(JERRY_ERROR_SYNTAX, "ES modules are not enabled in this engine build");
+    }
+    AppSysModuleLink_t link = { app, jerry_current_realm() };
+
+    jerry_value_t main_module = appsys_module_parse("main.js", app->mainjs_str, strlen(app->mainjs_str),
+        false, link.realm);
+
+    jerry_value_t result = main_module;
+    if (!jerry_value_is_exception(main_module)) {
+        result = jerry_module_link(main_module, appsys_module_resolve_cb, &link);
+        if (!jerry_value_is_exception(result)) {
+            jerry_value_free(result);
+            result = jerry_module_evaluate(main_module);
+        }
+        jerry_value_free(main_module);
+    }
+    if (jerry_value_is_exception(result)) {
+        appsys_module_drop_failed_system();
+    }
+    jerry_value_free(link.realm);
+    return result;
+}
+
+/**
+ * @brief 释放应用 realm 的模块缓存（应用退出时调用）
+ * @param realm 应用的 realm
+ */
+void appsys_module_free_realm(jerry_value_t realm) {
+    AppSysModule_t* entry;
+    AppSysModule_t* tmp;
+    LL_FOREACH_SAFE(module_cache, entry, tmp) {
+        if (!entry->is_system && entry->owner == realm) {
+            LL_DELETE(module_cache, entry);
+            jerry_value_free(entry->module);
+            free(entry);
+        }
+    }
+}
+
+/**
+ * @brief 释放全部模块与系统 realm（销毁 VM 前调用）
+ */
+void appsys_module_deinit(void) {
+    AppSysModule_t* entry;
+    AppSysModule_t* tmp;
+    LL_FOREACH_SAFE(module_cache, entry, tmp) {
+        LL_DELETE(module_cache, entry);
+        jerry_value_free(entry->module);
+        free(entry);
+    }
+    if (system_realm_ready) {
+        jerry_value_free(system_realm);
+        system_realm_ready = false;
+    }
+}
+
+/**
+ * @brief 获取已缓存的模块数量
+ * @return uint32_t 应用模块与系统模块之和
+ */
+uint32_t appsys_module_get_cached_count(void) {
+    uint32_t count = 0;
+    AppSysModule_t* entry;
+    LL_COUNT(module_cache, entry, count);
+    return count;
+}
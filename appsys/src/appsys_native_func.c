@@ -13,6 +13,8 @@
 #include <windows.h>
 #include "lvgl/lvgl.h"
 #include "appsys_core.h"
+#include "appsys_watchdog.h"
+#include "appsys_str.h"
 /********************************** 原生函数定义 **********************************/
 /**
  * @brief 处理 JavaScript 的 print 调用，将所有参数转换为字符串并打印到标准输出。每个参数之间以空格分隔，末尾换行。适用于 JerryScript 引擎的原生函数绑定。
@@ -28,43 +30,41 @@ jerry_value_t js_print_handler(const jerry_call_info_t* call_info_p,
     (void)call_info_p; // 当前未用到 this/func_obj，可忽略
 
     for (jerry_length_t i = 0; i < args_count; i++) {
-        jerry_value_t str_val;
-
-        if (jerry_value_is_string(args_p[i])) {
-            str_val = jerry_value_copy(args_p[i]);
-        }
-        else {
-            str_val = jerry_value_to_string(args_p[i]);  // 转为字符串
-        }
-
-        jerry_size_t size = jerry_string_size(str_val, JERRY_ENCODING_UTF8);
-        jerry_char_t* buf = (jerry_char_t*)malloc(size + 1); // Explicitly cast void* to jerry_char_t*
-        if (!buf) {
-            jerry_value_free(str_val);
+        // 转为字符串并写入共享的暂存缓冲区，不再逐个参数分配
+        const char* str = appsys_str_get(args_p[i], NULL);
+        if (str == NULL) {
             continue;
         }
 
-        jerry_string_to_buffer(str_val, JERRY_ENCODING_UTF8, buf, size);
-        buf[size] = '\0';
-
-        printf("%s", buf);
+        printf("%s", str);
         if (i < args_count - 1) {
             printf(" ");
         }
-
-        free(buf);
-        jerry_value_free(str_val);
     }
 
     printf("\n");
     return jerry_undefined();
 }
 
+/**
+ * @brief 处理 JavaScript 的 delay(ms) 调用，阻塞当前线程指定毫秒数。
+ *        返回前检查看门狗，避免 while(true) { delay(...); } 这类循环绕过检查点。
+ * @param args_p 参数数组，args_p[0] 为毫秒数。
+ * @param args_count 参数数量。
+ * @return 返回 undefined，脚本超出执行预算时返回 abort。
+ */
 jerry_value_t js_delay_handler(const jerry_call_info_t* call_info_p,
     const jerry_value_t args_p[],
     const jerry_length_t args_count)
 {
-    Sleep(args_p[0]);
+    (void)call_info_p;
+    if (args_count > 0 && jerry_value_is_number(args_p[0])) {
+        double ms = jerry_value_as_number(args_p[0]);
+        if (ms > 0) {
+            Sleep((DWORD)ms);
+        }
+    }
+    return appsys_watchdog_poll();
 }
 
 /********************************** 注册原生函数 **********************************/
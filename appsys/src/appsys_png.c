@@ -0,0 +1,580 @@
+﻿/**
+ * @file appsys_png.c
+ * @brief 最小 PNG 编解码实现
+ * @author Sab1e
+ * @date 2025-08-23
+ *
+ * 模拟器没有启用 LV_USE_LODEPNG（启用后会改变图片解码路径），渲染回归测试只需要读写
+ * 截图，因此在这里实现一个够用的版本：
+ *   - 写入：8 位 RGB，逐行在 None / Sub / Up 中选择绝对值和最小的滤波器，deflate 使用固定
+ *     哈夫曼编码，只查找距离为 1 字节和 1 行的重复（界面截图大面积纯色，压缩率已足够）；
+ *   - 读取：8 位 RGB / RGBA、非隔行，完整支持 deflate（存储、固定与动态哈夫曼）和五种滤波器，
+ *     其他工具重新保存的基准图也能读取。
+ */
+
+#include "appsys_png.h"
+#include "appsys_buf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/********************************** 校验 **********************************/
+
+static uint32_t appsys_png_crc(uint32_t crc, const uint8_t* data, size_t len) {
+    static uint32_t table[256];
+    if (table[1] == 0) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t appsys_png_adler(const uint8_t* data, size_t len) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void appsys_png_put_be32(AppSysBuf_t* buf, uint32_t v) {
+    uint8_t bytes[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+    appsys_buf_put(buf, bytes, 4);
+}
+
+static uint32_t appsys_png_get_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/********************************** deflate 压缩 **********************************/
+
+/**
+ * @brief 低位在前的位写入器
+ */
+typedef struct {
+    AppSysBuf_t* buf;
+    uint32_t bits;
+    uint32_t count;
+} AppSysBitWriter_t;
+
+static void appsys_png_put_bits(AppSysBitWriter_t* bw, uint32_t value, uint32_t count) {
+    bw->bits |= value << bw->count;
+    bw->count += count;
+    while (bw->count >= 8) {
+        appsys_buf_put_u8(bw->buf, (uint8_t)bw->bits);
+        bw->bits >>= 8;
+        bw->count -= 8;
+    }
+}
+
+/**
+ * @brief 写入哈夫曼码（码字高位在前，需要反转后按低位在前写入）
+ */
+static void appsys_png_put_code(AppSysBitWriter_t* bw, uint32_t code, uint32_t len) {
+    uint32_t rev = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        rev = (rev << 1) | ((code >> i) & 1);
+    }
+    appsys_png_put_bits(bw, rev, len);
+}
+
+/**
+ * @brief 固定哈夫曼表中的字面量 / 长度符号
+ */
+static void appsys_png_put_symbol(AppSysBitWriter_t* bw, uint32_t sym) {
+    if (sym < 144) {
+        appsys_png_put_code(bw, 0x30 + sym, 8);
+    }
+    else if (sym < 256) {
+        appsys_png_put_code(bw, 0x190 + sym - 144, 9);
+    }
+    else if (sym < 280) {
+        appsys_png_put_code(bw, sym - 256, 7);
+    }
+    else {
+        appsys_png_put_code(bw, 0xC0 + sym - 280, 8);
+    }
+}
+
+static const uint16_t len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static void appsys_png_put_match(AppSysBitWriter_t* bw, uint32_t len, uint32_t dist) {
+    uint32_t i = 28;
+    while (len_base[i] > len) {
+        i--;
+    }
+    appsys_png_put_symbol(bw, 257 + i);
+    appsys_png_put_bits(bw, len - len_base[i], len_extra[i]);
+    uint32_t d = 29;
+    while (dist_base[d] > dist) {
+        d--;
+    }
+    appsys_png_put_code(bw, d, 5);
+    appsys_png_put_bits(bw, dist - dist_base[d], dist_extra[d]);
+}
+
+/**
+ * @brief zlib 压缩：一个固定哈夫曼块，只尝试距离 1 与 row 的匹配
+ */
+static void appsys_png_deflate(AppSysBuf_t* out, const uint8_t* data, size_t len, size_t row) {
+    static const uint8_t zlib_header[2] = { 0x78, 0x01 };
+    appsys_buf_put(out, zlib_header, 2);
+    AppSysBitWriter_t bw = { out, 0, 0 };
+    appsys_png_put_bits(&bw, 1, 1);          // BFINAL
+    appsys_png_put_bits(&bw, 1, 2);          // BTYPE = 固定哈夫曼
+
+    const size_t dists[2] = { 1, row };
+    size_t pos = 0;
+    while (pos < len) {
+        size_t best_len = 0;
+        size_t best_dist = 0;
+        for (int k = 0; k < 2; k++) {
+            size_t dist = dists[k];
+            if (dist == 0 || dist > pos || dist > 32768) {
+                continue;
+            }
+            size_t max = len - pos < 258 ? len - pos : 258;
+            size_t n = 0;
+            while (n < max && data[pos + n] == data[pos + n - dist]) {
+                n++;
+            }
+            if (n > best_len) {
+                best_len = n;
+                best_dist = dist;
+            }
+        }
+        if (best_len >= 3) {
+            appsys_png_put_match(&bw, (uint32_t)best_len, (uint32_t)best_dist);
+            pos += best_len;
+        }
+        else {
+            appsys_png_put_symbol(&bw, data[pos]);
+            pos++;
+        }
+    }
+    appsys_png_put_symbol(&bw, 256);
+    appsys_png_put_bits(&bw, 0, 7);          // 补齐到字节边界
+    appsys_png_put_be32(out, appsys_png_adler(data, len));
+}
+
+/********************************** deflate 解压 **********************************/
+
+/**
+ * @brief 解压状态
+ */
+typedef struct {
+    const uint8_t* in;
+    size_t in_len;
+    size_t in_pos;
+    uint32_t bits;
+    uint32_t count;
+    uint8_t* out;
+    size_t out_len;
+    size_t out_pos;
+    bool error;
+} AppSysInflate_t;
+
+/**
+ * @brief 规范哈夫曼表：每个码长的符号数与按码字排序的符号
+ */
+typedef struct {
+    uint16_t count[16];
+    uint16_t symbol[288];
+} AppSysHuffman_t;
+
+static uint32_t appsys_png_get_bits(AppSysInflate_t* s, uint32_t need) {
+    while (s->count < need) {
+        if (s->in_pos >= s->in_len) {
+            s->error = true;
+            return 0;
+        }
+        s->bits |= (uint32_t)s->in[s->in_pos++] << s->count;
+        s->count += 8;
+    }
+    uint32_t value = s->bits & ((1u << need) - 1);
+    s->bits >>= need;
+    s->count -= need;
+    return value;
+}
+
+static void appsys_png_build_huffman(AppSysHuffman_t* h, const uint8_t* lengths, uint32_t n) {
+    uint16_t offs[16];
+    memset(h->count, 0, sizeof(h->count));
+    for (uint32_t i = 0; i < n; i++) {
+        h->count[lengths[i]]++;
+    }
+    h->count[0] = 0;
+    offs[1] = 0;
+    for (int i = 1; i < 15; i++) {
+        offs[i + 1] = offs[i] + h->count[i];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (lengths[i] != 0) {
+            h->symbol[offs[lengths[i]]++] = (uint16_t)i;
+        }
+    }
+}
+
+static int appsys_png_decode_symbol(AppSysInflate_t* s, const AppSysHuffman_t* h) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len < 16; len++) {
+        code |= (int)appsys_png_get_bits(s, 1);
+        int count = h->count[len];
+        if (code - count < first) {
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+        if (s->error) {
+            break;
+        }
+    }
+    s->error = true;
+    return -1;
+}
+
+static void appsys_png_inflate_codes(AppSysInflate_t* s, const AppSysHuffman_t* lit, const AppSysHuffman_t* dist) {
+    while (!s->error) {
+        int sym = appsys_png_decode_symbol(s, lit);
+        if (sym < 0 || sym > 285) {
+            s->error = true;
+            return;
+        }
+        if (sym < 256) {
+            if (s->out_pos >= s->out_len) {
+                s->error = true;
+                return;
+            }
+            s->out[s->out_pos++] = (uint8_t)sym;
+            continue;
+        }
+        if (sym == 256) {
+            return;
+        }
+        sym -= 257;
+        size_t len = len_base[sym] + appsys_png_get_bits(s, len_extra[sym]);
+        int dsym = appsys_png_decode_symbol(s, dist);
+        if (dsym < 0 || dsym > 29) {
+            s->error = true;
+            return;
+        }
+        size_t d = dist_base[dsym] + appsys_png_get_bits(s, dist_extra[dsym]);
+        if (d > s->out_pos || s->out_pos + len > s->out_len) {
+            s->error = true;
+            return;
+        }
+        for (size_t i = 0; i < len; i++, s->out_pos++) {
+            s->out[s->out_pos] = s->out[s->out_pos - d];
+        }
+    }
+}
+
+/**
+ * @brief zlib 解压到已知大小的缓冲区
+ * @return true 成功且正好写满
+ */
+static bool appsys_png_inflate(const uint8_t* in, size_t in_len, uint8_t* out, size_t out_len) {
+    AppSysInflate_t s;
+    memset(&s, 0, sizeof(s));
+    if (in_len < 2 || (in[0] & 0x0F) != 8 || (in[1] & 0x20) != 0) {
+        return false;
+    }
+    s.in = in + 2;
+    s.in_len = in_len - 2;
+    s.out = out;
+    s.out_len = out_len;
+
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    AppSysHuffman_t lit;
+    AppSysHuffman_t dist;
+    uint32_t last;
+    do {
+        last = appsys_png_get_bits(&s, 1);
+        uint32_t type = appsys_png_get_bits(&s, 2);
+        if (type == 0) {
+            // 存储块：丢弃剩余位，读取 LEN / NLEN
+            s.bits = 0;
+            s.count = 0;
+            if (s.in_pos + 4 > s.in_len) {
+                return false;
+            }
+            size_t len = s.in[s.in_pos] | ((size_t)s.in[s.in_pos + 1] << 8);
+            s.in_pos += 4;
+            if (s.in_pos + len > s.in_len || s.out_pos + len > s.out_len) {
+                return false;
+            }
+            memcpy(s.out + s.out_pos, s.in + s.in_pos, len);
+            s.in_pos += len;
+            s.out_pos += len;
+        }
+        else if (type == 1) {
+            uint8_t lengths[320];
+            memset(lengths, 8, 144);
+            memset(lengths + 144, 9, 112);
+            memset(lengths + 256, 7, 24);
+            memset(lengths + 280, 8, 8);
+            memset(lengths + 288, 5, 30);
+            appsys_png_build_huffman(&lit, lengths, 288);
+            appsys_png_build_huffman(&dist, lengths + 288, 30);
+            appsys_png_inflate_codes(&s, &lit, &dist);
+        }
+        else if (type == 2) {
+            uint32_t nlen = appsys_png_get_bits(&s, 5) + 257;
+            uint32_t ndist = appsys_png_get_bits(&s, 5) + 1;
+            uint32_t ncode = appsys_png_get_bits(&s, 4) + 4;
+            uint8_t lengths[320];
+            memset(lengths, 0, sizeof(lengths));
+            for (uint32_t i = 0; i < ncode; i++) {
+                lengths[order[i]] = (uint8_t)appsys_png_get_bits(&s, 3);
+            }
+            AppSysHuffman_t code;
+            appsys_png_build_huffman(&code, lengths, 19);
+            uint32_t index = 0;
+            memset(lengths, 0, sizeof(lengths));
+            while (index < nlen + ndist && !s.error) {
+                int sym = appsys_png_decode_symbol(&s, &code);
+                if (sym < 16) {
+                    lengths[index++] = (uint8_t)sym;
+                    continue;
+                }
+                uint8_t value = 0;
+                uint32_t repeat;
+                if (sym == 16) {
+                    if (index == 0) {
+                        return false;
+                    }
+                    value = lengths[index - 1];
+                    repeat = 3 + appsys_png_get_bits(&s, 2);
+                }
+                else if (sym == 17) {
+                    repeat = 3 + appsys_png_get_bits(&s, 3);
+                }
+                else {
+                    repeat = 11 + appsys_png_get_bits(&s, 7);
+                }
+                if (index + repeat > nlen + ndist) {
+                    return false;
+                }
+                while (repeat-- > 0) {
+                    lengths[index++] = value;
+                }
+            }
+            appsys_png_build_huffman(&lit, lengths, nlen);
+            appsys_png_build_huffman(&dist, lengths + nlen, ndist);
+            appsys_png_inflate_codes(&s, &lit, &dist);
+        }
+        else {
+            return false;
+        }
+    } while (!last && !s.error);
+    return !s.error && s.out_pos == s.out_len;
+}
+
+/********************************** PNG 文件 **********************************/
+
+static void appsys_png_put_chunk(AppSysBuf_t* buf, const char* type, const uint8_t* data, size_t len) {
+    appsys_png_put_be32(buf, (uint32_t)len);
+    size_t start = buf->len;
+    appsys_buf_put(buf, type, 4);
+    appsys_buf_put(buf, data, len);
+    uint32_t crc = buf->oom ? 0 : appsys_png_crc(0, buf->data + start, len + 4);
+    appsys_png_put_be32(buf, crc);
+}
+
+static uint8_t appsys_png_paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = (int)a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+/**
+ * @brief 写入 8 位 RGB PNG
+ * @param rgb width * height * 3 字节，逐行排列
+ * @return true 写入成功
+ */
+bool appsys_png_write(const char* path, const uint8_t* rgb, uint32_t width, uint32_t height) {
+    size_t stride = (size_t)width * 3;
+    size_t raw_len = (stride + 1) * height;
+    uint8_t* raw = (uint8_t*)malloc(raw_len);
+    if (raw == NULL) {
+        return false;
+    }
+    // 逐行选择绝对值和最小的滤波器（None / Sub / Up）
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* cur = rgb + y * stride;
+        const uint8_t* prev = y > 0 ? cur - stride : NULL;
+        uint8_t* dst = raw + y * (stride + 1);
+        uint32_t best_sum = UINT32_MAX;
+        for (uint8_t filter = 0; filter < 3; filter++) {
+            if (filter == 2 && prev == NULL) {
+                break;
+            }
+            uint32_t sum = 0;
+            for (size_t i = 0; i < stride; i++) {
+                uint8_t left = i >= 3 ? cur[i - 3] : 0;
+                uint8_t v = filter == 0 ? cur[i] : filter == 1 ? (uint8_t)(cur[i] - left) : (uint8_t)(cur[i] - prev[i]);
+                sum += v < 128 ? v : 256 - v;
+            }
+            if (sum < best_sum) {
+                best_sum = sum;
+                dst[0] = filter;
+            }
+        }
+        for (size_t i = 0; i < stride; i++) {
+            uint8_t left = i >= 3 ? cur[i - 3] : 0;
+            dst[1 + i] = dst[0] == 0 ? cur[i] : dst[0] == 1 ? (uint8_t)(cur[i] - left) : (uint8_t)(cur[i] - prev[i]);
+        }
+    }
+
+    AppSysBuf_t idat;
+    appsys_buf_init(&idat);
+    appsys_png_deflate(&idat, raw, raw_len, stride + 1);
+    free(raw);
+
+    AppSysBuf_t png;
+    appsys_buf_init(&png);
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    appsys_buf_put(&png, signature, 8);
+    uint8_t ihdr[13] = {
+        (uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+        (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+        8, 2, 0, 0, 0 };         // 8 位, RGB, deflate, 自适应滤波, 非隔行
+    appsys_png_put_chunk(&png, "IHDR", ihdr, sizeof(ihdr));
+    appsys_png_put_chunk(&png, "IDAT", idat.data, idat.len);
+    appsys_png_put_chunk(&png, "IEND", NULL, 0);
+    bool ok = !idat.oom && !png.oom;
+    appsys_buf_free(&idat);
+
+    FILE* file = ok ? fopen(path, "wb") : NULL;
+    if (file != NULL) {
+        ok = fwrite(png.data, 1, png.len, file) == png.len;
+        fclose(file);
+    }
+    else {
+        ok = false;
+    }
+    appsys_buf_free(&png);
+    return ok;
+}
+
+/**
+ * @brief 读取 8 位 RGB / RGBA 非隔行 PNG，透明通道被丢弃
+ * @param width 输出宽度
+ * @param height 输出高度
+ * @return uint8_t* width * height * 3 字节的 RGB 数据，调用者负责 free；文件不存在或格式不支持时返回 NULL
+ */
+uint8_t* appsys_png_read(const char* path, uint32_t* width, uint32_t* height) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = len > 8 ? (uint8_t*)malloc((size_t)len) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)len, file) != (size_t)len) {
+        fclose(file);
+        free(data);
+        return NULL;
+    }
+    fclose(file);
+
+    uint8_t* rgb = NULL;
+    uint8_t* raw = NULL;
+    AppSysBuf_t idat;
+    appsys_buf_init(&idat);
+    uint32_t w = 0;
+    uint32_t h = 0;
+    uint32_t channels = 0;
+    size_t pos = 8;
+    while (pos + 12 <= (size_t)len) {
+        uint32_t chunk_len = appsys_png_get_be32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (chunk_len > (size_t)len - pos - 12) {
+            break;
+        }
+        if (memcmp(type, "IHDR", 4) == 0 && chunk_len >= 13) {
+            w = appsys_png_get_be32(body);
+            h = appsys_png_get_be32(body + 4);
+            // 只支持 8 位、RGB / RGBA、非隔行
+            if (body[8] == 8 && body[12] == 0 && (body[9] == 2 || body[9] == 6)) {
+                channels = body[9] == 2 ? 3 : 4;
+            }
+        }
+        else if (memcmp(type, "IDAT", 4) == 0) {
+            appsys_buf_put(&idat, body, chunk_len);
+        }
+        else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + chunk_len;
+    }
+
+    size_t stride = (size_t)w * channels;
+    size_t raw_len = (stride + 1) * h;
+    if (channels != 0 && w > 0 && h > 0 && w <= 16384 && h <= 16384 && !idat.oom) {
+        raw = (uint8_t*)malloc(raw_len);
+        rgb = (uint8_t*)malloc((size_t)w * h * 3);
+    }
+    if (raw != NULL && rgb != NULL && appsys_png_inflate(idat.data, idat.len, raw, raw_len)) {
+        // 原地反滤波，结果写回 raw 中每行的像素部分
+        for (uint32_t y = 0; y < h; y++) {
+            uint8_t* row = raw + y * (stride + 1);
+            uint8_t filter = row[0];
+            uint8_t* cur = row + 1;
+            const uint8_t* prev = y > 0 ? cur - (stride + 1) : NULL;
+            for (size_t i = 0; i < stride; i++) {
+                uint8_t a = i >= channels ? cur[i - channels] : 0;
+                uint8_t b = prev != NULL ? prev[i] : 0;
+                uint8_t c = (prev != NULL && i >= channels) ? prev[i - channels] : 0;
+                switch (filter) {
+                case 1: cur[i] = (uint8_t)(cur[i] + a); break;
+                case 2: cur[i] = (uint8_t)(cur[i] + b); break;
+                case 3: cur[i] = (uint8_t)(cur[i] + ((a + b) >> 1)); break;
+                case 4: cur[i] = (uint8_t)(cur[i] + appsys_png_paeth(a, b, c)); break;
+                default: break;
+                }
+            }
+            for (uint32_t x = 0; x < w; x++) {
+                memcpy(rgb + ((size_t)y * w + x) * 3, cur + (size_t)x * channels, 3);
+            }
+        }
+        *width = w;
+        *height = h;
+    }
+    else {
+        free(rgb);
+        rgb = NULL;
+    }
+    free(raw);
+    free(data);
+    appsys_buf_free(&idat);
+    return rgb;
+}
@@ -6,7 +6,52 @@
  */
 
 #include "appsys_port.h"
+#include <windows.h>
+#include <malloc.h>
 
 void appsys_port_init(void) {
-    // 初始化函数    
+    // 初始化函数
+}
+
+/**
+ * @brief 获取单调递增的微秒级时间戳，用于性能统计
+ * @return uint64_t 当前时间 [us]
+ */
+uint64_t appsys_port_get_time_us(void) {
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000ULL
+        + (uint64_t)(now.QuadPart % freq.QuadPart) * 1000000ULL / (uint64_t)freq.QuadPart;
+}
+
+/**
+ * @brief 创建目录（已存在时视为成功）
+ * @param path 目录路径
+ * @return true 目录可用
+ */
+bool appsys_port_make_dir(const char* path) {
+    if (CreateDirectoryA(path, NULL)) {
+        return true;
+    }
+    return GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+/**
+ * @brief 获取 C 堆（malloc）当前已分配的字节数，用于内存统计。遍历整个堆，不要在热路径调用
+ * @return size_t 已分配的字节数 [byte]
+ */
+size_t appsys_port_get_heap_used(void) {
+    _HEAPINFO info;
+    size_t used = 0;
+    info._pentry = NULL;
+    while (_heapwalk(&info) == _HEAPOK) {
+        if (info._useflag == _USEDENTRY) {
+            used += info._size;
+        }
+    }
+    return used;
 }
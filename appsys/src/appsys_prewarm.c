@@ -0,0 +1,234 @@
+﻿/**
+ * @file appsys_prewarm.c
+ * @brief 应用启动预热实现
+ * @author Sab1e
+ * @date 2025-08-12
+ *
+ * 启动器在用户可能打开某个应用时（例如手指停在图标上）调用 appsys_prewarm_app，
+ * 空闲调度器随后在系统空闲率不低于 APPSYS_PREWARM_IDLE_MIN 时，每个周期完成一个小任务：
+ * 把 main.js 编译成 JerryScript 快照，或预解码一张首屏图片放入图片缓存。
+ * 启动时直接执行快照，跳过解析；图片解码命中缓存，首帧只剩脚本本身的执行时间。
+ *
+ * 快照与 VM 无关，保存在普通内存中，VM 在所有应用退出后被销毁也不影响已缓存的快照。
+ *
+ * 预解码见 appsys_image.c，启用对齐的绘制缓冲时按对齐的行宽解码。
+ * 快照编译需要以 --snapshot-save=ON --snapshot-exec=ON 编译 JerryScript，否则只预热资源。
+ */
+
+#include "appsys_prewarm.h"
+#include "appsys_port.h"
+#include "appsys_conf.h"
+#include "appsys_image.h"
+#include "lvgl/lvgl.h"
+#include "utlist.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 单个应用的预热记录
+ */
+typedef struct AppSysPrewarm {
+    const ApplicationPackage_t* app;   // 应用包（预热期间必须保持有效）
+    const char* source;                // 生成快照时的脚本，脚本变化后快照失效
+    uint32_t* snapshot;                // 快照数据，NULL 表示尚未生成或不可用
+    size_t snapshot_size;
+    bool snapshot_done;                // 已尝试生成快照
+    uint32_t next_asset;               // 下一张待预解码的图片
+    struct AppSysPrewarm* prev;
+    struct AppSysPrewarm* next;
+} AppSysPrewarm_t;
+
+static AppSysPrewarm_t* prewarm_list = NULL;     // 按预热先后排列
+static lv_timer_t* idle_timer = NULL;
+
+/**
+ * @brief 按应用 ID 查找预热记录
+ */
+static AppSysPrewarm_t* appsys_prewarm_find(const char* app_id) {
+    AppSysPrewarm_t* p;
+    DL_FOREACH(prewarm_list, p) {
+        if (strcmp(p->app->app_id, app_id) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static void appsys_prewarm_free(AppSysPrewarm_t* p) {
+    DL_DELETE(prewarm_list, p);
+    free(p->snapshot);
+    free(p);
+}
+
+static bool appsys_prewarm_is_ready(const AppSysPrewarm_t* p) {
+    return p->snapshot_done
+        && (p->app->preload_assets == NULL || p->app->preload_assets[p->next_asset] == NULL);
+}
+
+/**
+ * @brief 把 main.js 编译为快照
+ */
+static void appsys_prewarm_snapshot(AppSysPrewarm_t* p) {
+    p->snapshot_done = true;
+    // 快照不支持 ES 模块，模块应用只预解码图片
+    if (p->app->mainjs_is_module
+        || !jerry_feature_enabled(JERRY_FEATURE_SNAPSHOT_SAVE)
+        || !jerry_feature_enabled(JERRY_FEATURE_SNAPSHOT_EXEC)) {
+        return;
+    }
+    uint64_t start_us = appsys_port_get_time_us();
+    appsys_vm_init();
+
+    jerry_value_t code = jerry_parse((const jerry_char_t*)p->app->mainjs_str,
+        strlen(p->app->mainjs_str), NULL);
+    if (jerry_value_is_exception(code)) {
+        // 语法错误留到启动时按正常路径报告
+        jerry_value_free(code);
+        return;
+    }
+
+    uint32_t* buf = (uint32_t*)malloc(APPSYS_PREWARM_SNAPSHOT_MAX);
+    if (buf != NULL) {
+        jerry_value_t result = jerry_generate_snapshot(code, 0, buf, APPSYS_PREWARM_SNAPSHOT_MAX);
+        if (!jerry_value_is_exception(result)) {
+            size_t size = (size_t)jerry_value_as_number(result);
+            uint32_t* fitted = (uint32_t*)realloc(buf, size);
+            p->snapshot = fitted != NULL ? fitted : buf;
+            p->snapshot_size = size;
+            p->source = p->app->mainjs_str;
+            buf = NULL;
+        }
+        jerry_value_free(result);
+        free(buf);
+    }
+    jerry_value_free(code);
+
+    printf("[prewarm] %s: snapshot %u B in %u us\n", p->app->app_id,
+        (uint32_t)p->snapshot_size, (uint32_t)(appsys_port_get_time_us() - start_us));
+}
+
+/**
+ * @brief 预解码一张首屏图片，解码结果留在图片缓存中
+ */
+static void appsys_prewarm_asset(AppSysPrewarm_t* p) {
+    const char* src = p->app->preload_assets[p->next_asset++];
+#if APPSYS_PREWARM_IMAGE_CACHE_SIZE > 0
+    if (!appsys_image_predecode(src)) {
+        printf("[prewarm] %s: failed to decode %s\n", p->app->app_id, src);
+    }
+#else
+    (void)src;
+#endif
+}
+
+/**
+ * @brief 空闲调度器：系统空闲时为最早排队的应用完成一个预热任务
+ */
+static void appsys_prewarm_idle_cb(lv_timer_t* timer) {
+    AppSysPrewarm_t* p;
+    DL_FOREACH(prewarm_list, p) {
+        if (!appsys_prewarm_is_ready(p)) {
+            break;
+        }
+    }
+    if (p == NULL) {
+        lv_timer_pause(timer);
+        return;
+    }
+    if (lv_timer_get_idle() < APPSYS_PREWARM_IDLE_MIN) {
+        return;
+    }
+    if (!p->snapshot_done) {
+        appsys_prewarm_snapshot(p);
+    }
+    else {
+        appsys_prewarm_asset(p);
+    }
+}
+
+/**
+ * @brief 请求预热应用，实际工作在系统空闲时分步完成
+ * @param app 应用包（预热期间必须保持有效）
+ * @return bool 已排队或已就绪
+ */
+bool appsys_prewarm_app(const ApplicationPackage_t* app) {
+    if (app == NULL || app->app_id == NULL || app->mainjs_str == NULL) {
+        return false;
+    }
+    if (idle_timer == NULL) {
+        idle_timer = lv_timer_create(appsys_prewarm_idle_cb, APPSYS_PREWARM_PERIOD, NULL);
+#if APPSYS_PREWARM_IMAGE_CACHE_SIZE > 0
+        lv_image_cache_resize(APPSYS_PREWARM_IMAGE_CACHE_SIZE, false);
+#endif
+    }
+
+    AppSysPrewarm_t* p = appsys_prewarm_find(app->app_id);
+    if (p != NULL) {
+        // 重新排到最后，作为最近一次预热保留
+        DL_DELETE(prewarm_list, p);
+        DL_APPEND(prewarm_list, p);
+        if (p->app != app || (p->source != NULL && p->source != app->mainjs_str)) {
+            free(p->snapshot);
+            memset(p, 0, offsetof(AppSysPrewarm_t, prev));
+            p->app = app;
+        }
+    }
+    else {
+        int count;
+        AppSysPrewarm_t* tmp;
+        DL_COUNT(prewarm_list, tmp, count);
+        if (count >= APPSYS_PREWARM_MAX_APPS) {
+            appsys_prewarm_free(prewarm_list);
+        }
+        p = (AppSysPrewarm_t*)calloc(1, sizeof(AppSysPrewarm_t));
+        if (p == NULL) {
+            return false;
+        }
+        p->app = app;
+        DL_APPEND(prewarm_list, p);
+    }
+    lv_timer_resume(idle_timer);
+    return true;
+}
+
+/**
+ * @brief 取消预热并释放快照
+ * @param app_id 应用 ID
+ */
+void appsys_prewarm_cancel(const char* app_id) {
+    AppSysPrewarm_t* p = appsys_prewarm_find(app_id);
+    if (p != NULL) {
+        appsys_prewarm_free(p);
+    }
+}
+
+/**
+ * @brief 查询预热状态
+ * @param app_id 应用 ID
+ * @return AppSysPrewarmState_t 预热状态
+ */
+AppSysPrewarmState_t appsys_prewarm_get_state(const char* app_id) {
+    AppSysPrewarm_t* p = appsys_prewarm_find(app_id);
+    if (p == NULL) {
+        return APPSYS_PREWARM_NONE;
+    }
+    return appsys_prewarm_is_ready(p) ? APPSYS_PREWARM_READY : APPSYS_PREWARM_QUEUED;
+}
+
+/**
+ * @brief 在当前 realm 中执行已预热的快照
+ * @param app 应用包
+ * @param result 输出执行结果，调用者负责释放
+ * @return bool 没有可用快照时返回 false，调用者应改用 jerry_eval
+ */
+bool appsys_prewarm_exec(const ApplicationPackage_t* app, jerry_value_t* result) {
+    AppSysPrewarm_t* p = appsys_prewarm_find(app->app_id);
+    if (p == NULL || p->snapshot == NULL || p->source != app->mainjs_str) {
+        return false;
+    }
+    // 快照缓冲区之后可能被释放，字节码需复制到 VM 堆中
+    *result = jerry_exec_snapshot(p->snapshot, p->snapshot_size, 0, JERRY_SNAPSHOT_EXEC_COPY_DATA, NULL);
+    return true;
+}
@@ -0,0 +1,121 @@
+﻿/**
+ * @file appsys_stdlib.c
+ * @brief 系统 JS 库加载实现
+ * @author Sab1e
+ * @date 2025-08-13
+ *
+ * appsys/js/stdlib.js 在构建期编译为静态快照嵌入只读数据段，每个 realm 建立时执行一次。
+ * 静态快照中的字面量全部引用内置应用共用的 magic string 表（见 gen_builtin.py），
+ * 以 JERRY_SNAPSHOT_EXEC_ALLOW_STATIC 执行时字节码与字面量都直接引用快照缓冲区，
+ * 不占用 JerryScript 堆，也不需要解析；所有应用共享同一份字节码。
+ *
+ * 构建期快照缺失或与当前引擎不兼容时，首次加载从嵌入的源码编译一份快照（优先编译为静态快照，
+ * magic string 表未覆盖全部字面量时退回普通快照），保存到进程结束且不再修改
+ * （VM 重建后字节码仍可能引用它），之后同样就地执行。
+ */
+
+#include "appsys_stdlib.h"
+#include "appsys_core.h"
+#include "jerryscript.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t* stdlib_snapshot = NULL;
+static size_t stdlib_snapshot_size = 0;
+static bool stdlib_builtin_failed = false;      // 构建期快照无法执行，已改用运行时快照
+
+/**
+ * @brief 从嵌入的源码编译快照，结果在进程生命周期内保留
+ * @return bool 编译成功
+ */
+static bool appsys_stdlib_compile(void) {
+    if (!jerry_feature_enabled(JERRY_FEATURE_SNAPSHOT_SAVE)) {
+        return false;
+    }
+    jerry_value_t code = jerry_parse((const jerry_char_t*)appsys_stdlib_source,
+        strlen(appsys_stdlib_source), NULL);
+    if (jerry_value_is_exception(code)) {
+        appsys_report_exception(code);
+        jerry_value_free(code);
+        return false;
+    }
+
+    // 源码长度的 4 倍足够容纳快照
+    size_t cap = (strlen(appsys_stdlib_source) * 4 + 1024) & ~(size_t)3;
+    uint32_t* buf = (uint32_t*)malloc(cap);
+    bool ok = false;
+    if (buf != NULL) {
+        jerry_value_t result = jerry_generate_snapshot(code, JERRY_SNAPSHOT_SAVE_STATIC, buf, cap);
+        if (jerry_value_is_exception(result)) {
+            // 有字面量不在 magic string 表中（如构建期未生成内置应用），只能生成普通快照
+            jerry_value_free(result);
+            result = jerry_generate_snapshot(code, 0, buf, cap);
+        }
+        if (!jerry_value_is_exception(result)) {
+            stdlib_snapshot_size = (size_t)jerry_value_as_number(result);
+            stdlib_snapshot = buf;
+            ok = true;
+        }
+        else {
+            free(buf);
+        }
+        jerry_value_free(result);
+    }
+    jerry_value_free(code);
+    return ok;
+}
+
+/**
+ * @brief 执行快照（静态快照与普通快照都不复制数据，就地执行）
+ */
+static jerry_value_t appsys_stdlib_exec(void) {
+    return jerry_exec_snapshot(stdlib_snapshot, stdlib_snapshot_size, 0, JERRY_SNAPSHOT_EXEC_ALLOW_STATIC, NULL);
+}
+
+/**
+ * @brief 在当前 realm 中加载系统 JS 库
+ * @return bool 加载成功
+ */
+bool appsys_stdlib_load(void) {
+    if (!jerry_feature_enabled(JERRY_FEATURE_SNAPSHOT_EXEC)) {
+        // 引擎不支持快照，退回到逐个 realm 解析源码
+        jerry_value_t result = jerry_eval((const jerry_char_t*)appsys_stdlib_source,
+            strlen(appsys_stdlib_source), JERRY_PARSE_NO_OPTS);
+        bool ok = !jerry_value_is_exception(result);
+        if (!ok) {
+            appsys_report_exception(result);
+        }
+        jerry_value_free(result);
+        return ok;
+    }
+
+    if (stdlib_snapshot == NULL && appsys_stdlib_snapshot_size > 0 && !stdlib_builtin_failed) {
+        stdlib_snapshot = appsys_stdlib_snapshot;
+        stdlib_snapshot_size = appsys_stdlib_snapshot_size;
+    }
+    if (stdlib_snapshot == NULL && !appsys_stdlib_compile()) {
+        printf("appsys: failed to build stdlib snapshot\n");
+        return false;
+    }
+
+    jerry_value_t result = appsys_stdlib_exec();
+    if (jerry_value_is_exception(result) && stdlib_snapshot == appsys_stdlib_snapshot) {
+        // 构建期快照与当前引擎版本或编译选项不符
+        printf("appsys: built-in stdlib snapshot rejected, compiling from source\n");
+        jerry_value_free(result);
+        stdlib_builtin_failed = true;
+        stdlib_snapshot = NULL;
+        if (!appsys_stdlib_compile()) {
+            return false;
+        }
+        result = appsys_stdlib_exec();
+    }
+
+    bool ok = !jerry_value_is_exception(result);
+    if (!ok) {
+        appsys_report_exception(result);
+    }
+    jerry_value_free(result);
+    return ok;
+}
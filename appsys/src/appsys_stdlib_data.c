@@ -0,0 +1,47 @@
+﻿/**
+ * @file appsys_stdlib_data.c
+ * @brief 系统 JS 库数据，由 appsys/tools/gen_stdlib.py 从 appsys/js/stdlib.js 生成，请勿手动修改
+ */
+
+#include "appsys_stdlib.h"
+
+const char appsys_stdlib_source[] =
+    "/**\n"
+    " * @file stdlib.js\n"
+    " * @brief \347\263\273\347\273\237 JS \350\276\205\345\212\251\345\207\275\346\225\260\345\272\223\357\274\214\347\274\226\350\257\221\344\270\272\345\277\253\347\205\247\345\220\216\345\234\250\346\257\217\344\270\252\345\272\224\347\224\250\347\232\204 realm \344\270\255\345\205\261\344\272\253\346\211\247\350\241\214\n"
+    " * @author Sab1e\n"
+    " * @date 2025-08-13\n"
+    " *\n"
+    " * \344\277\256\346\224\271\345\220\216\351\234\200\350\277\220\350\241\214 appsys/tools/gen_stdlib.py \351\207\215\346\226\260\347\224\237\346\210\220 appsys_stdlib_data.c\343\200\202\n"
+    " * \350\277\231\351\207\214\347\224\250\345\210\260\347\232\204 LVGL \347\273\221\345\256\232\345\207\275\346\225\260\345\277\205\351\241\273\345\220\214\346\227\266\345\207\272\347\216\260\345\234\250\347\224\237\346\210\220\347\273\221\345\256\232\346\227\266\346\211\253\346\217\217\347\232\204\350\204\232\346\234\254\344\270\255\343\200\202\n"
+    " */\n"
+    "\n"
+    "/**\n"
+    " * \345\234\250 JS \344\270\255\351\251\261\345\212\250 LVGL \344\270\273\345\276\252\347\216\257\n"
+    " * @param loop \344\270\272 true \346\227\266\344\270\200\347\233\264\345\276\252\347\216\257\357\274\233\345\220\246\345\210\231\350\277\220\350\241\214 3 \347\247\222\345\220\216\350\277\224\345\233\236\343\200\202\n"
+    " *             \345\233\236\345\275\222\346\265\213\350\257\225\344\270\255 LVGL \346\227\266\351\222\237\346\230\257\350\231\232\346\213\237\347\232\204\357\274\214\347\224\261\346\265\213\350\257\225\347\250\213\345\272\217\345\234\250\350\204\232\346\234\254\350\277\224\345\233\236\345\220\216\346\216\250\350\277\233\357\274\214\350\277\231\351\207\214\347\233\264\346\216\245\350\277\224\345\233\236\n"
+    " */\n"
+    "function run_lvgl(loop) {\n"
+    "  if (golden_active()) {\n"
+    "    return;\n"
+    "  }\n"
+    "  let startTime = new Date().getTime(); // \350\216\267\345\217\226\345\274\200\345\247\213\346\227\266\351\227\264\346\210\263\n"
+    "  let duration = 3000; // 3\347\247\222 = 3000\346\257\253\347\247\222\n"
+    "\n"
+    "  while (true) {\n"
+    "    let delay = lv_timer_handler();\n"
+    "    lv_delay_ms(delay);\n"
+    "\n"
+    "    // \346\243\200\346\237\245\346\230\257\345\220\246\345\267\262\347\273\217\350\266\205\350\277\2073\347\247\222\n"
+    "    if (!loop) {\n"
+    "      let currentTime = new Date().getTime();\n"
+    "      if (currentTime - startTime >= duration) {\n"
+    "        break; // \351\200\200\345\207\272\345\276\252\347\216\257\n"
+    "      }\n"
+    "    }\n"
+    "  }\n"
+    "}\n";
+
+// 未指定 --jerry-snapshot，运行时从源码编译快照
+const uint32_t appsys_stdlib_snapshot[] = { 0 };
+const size_t appsys_stdlib_snapshot_size = 0;
@@ -0,0 +1,469 @@
+﻿/**
+ * @file appsys_str.c
+ * @brief JS 字符串与 LVGL 文本接口之间的转换
+ * @author Sab1e
+ * @date 2025-08-21
+ *
+ * 绑定生成的文本函数每次调用都 malloc 一块缓冲区转换 JS 字符串，LVGL 随后再复制一次。
+ * 这里改为：
+ *   - 转换到一块常驻的暂存缓冲区，只在遇到更长的字符串时扩大，不再逐次分配；
+ *     lv_textarea_set_text 等设置函数会在 LVGL 仍读取文本时同步发送 INSERT/VALUE_CHANGED，
+ *     若 JS 回调中再转换字符串（print、其他 set_text），改用临时缓冲区，返回后释放，常驻缓冲区不被改写；
+ *   - JerryScript 内部以 CESU-8 保存字符串，只要没有代理对（BMP 以外的字符），CESU-8 与 UTF-8 相同，
+ *     直接按 CESU-8 拷贝即可；纯 ASCII 字符串（字节数等于字符数）连扫描都可以省去；
+ *   - lv_label_set_text_static 等静态文本接口要求字符串在控件生命周期内有效，JS 字符串做不到，
+ *     因此把文本驻留到只增不减的驻留表中（相同内容只保存一份），超出 APPSYS_STR_INTERN_LIMIT
+ *     后退化为普通的复制接口。界面中固定的标题、单位等文本应使用 *_static 版本。
+ *
+ * 计数器、计时器、传感器读数这类每帧更新的数字不必先在 JS 中拼接字符串，可直接调用
+ * label_set_int(label, value[, fmt]) / label_set_fixed(label, value, decimals[, suffix])，
+ * 在原生侧格式化后写入标签，文本未变化时不做任何更新；新文本不长于旧文本时直接写入标签自有的缓冲区，
+ * 不经过 LVGL 的释放与重新分配。
+ *
+ * appsys_str_register_natives 需在 lv_binding_init 之后调用，以覆盖绑定中的同名函数。
+ */
+
+#include "appsys_str.h"
+#include "appsys_core.h"
+#include "appsys_js_utils.h"
+#include "appsys_conf.h"
+#include "lvgl/lvgl.h"
+#include "lvgl/lvgl_private.h"
+#include "uthash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief 驻留的静态文本
+ */
+typedef struct {
+    UT_hash_handle hh;
+    size_t len;
+    char text[];
+} AppSysStrIntern_t;
+
+static char* str_scratch = NULL;             // 暂存缓冲区
+static size_t str_scratch_size = 0;
+static uint32_t str_scratch_depth = 0;       // 正在把暂存缓冲区交给 LVGL 的设置函数嵌套层数
+static AppSysStrIntern_t* str_interns = NULL;
+static size_t str_intern_bytes = 0;          // 驻留表已占用的字节数
+
+/**
+ * @brief 确保暂存缓冲区至少有 size 字节
+ */
+static bool appsys_str_reserve(size_t size) {
+    if (size <= str_scratch_size) {
+        return true;
+    }
+    // 嵌套在设置函数中时是用完即释放的临时缓冲区，按需分配即可
+    size_t new_size = str_scratch_size > 0 ? str_scratch_size
+        : str_scratch_depth > 0 ? size : APPSYS_STR_SCRATCH_SIZE;
+    while (new_size < size) {
+        new_size *= 2;
+    }
+    char* buf = (char*)realloc(str_scratch, new_size);
+    if (buf == NULL) {
+        return false;
+    }
+    str_scratch = buf;
+    str_scratch_size = new_size;
+    return true;
+}
+
+/**
+ * @brief 把 JS 字符串转换为 UTF-8，结果保存在暂存缓冲区中
+ * @param value JS 值，不是字符串时先转换为字符串
+ * @param len 输出字节数（不含 '\0'），可为 NULL
+ * @return const char* 以 '\0' 结尾的文本，在下一次调用前有效；分配失败时返回 NULL
+ */
+const char* appsys_str_get(jerry_value_t value, jerry_size_t* len) {
+    jerry_value_t str = jerry_value_is_string(value) ? value : jerry_value_to_string(value);
+    const char* result = NULL;
+    jerry_size_t size = 0;
+    if (jerry_value_is_string(str)) {
+        size = jerry_string_size(str, JERRY_ENCODING_CESU8);
+        if (appsys_str_reserve((size_t)size + 1)) {
+            jerry_string_to_buffer(str, JERRY_ENCODING_CESU8, (jerry_char_t*)str_scratch, size);
+            // 非 ASCII 时检查代理对（CESU-8 中以 0xED 0xA0~0xBF 开头），有则按 UTF-8 重新转换
+            if (jerry_string_length(str) != size
+                && memchr(str_scratch, 0xED, size) != NULL) {
+                size = jerry_string_to_buffer(str, JERRY_ENCODING_UTF8, (jerry_char_t*)str_scratch, size);
+            }
+            str_scratch[size] = '\0';
+            result = str_scratch;
+        }
+        else {
+            size = 0;
+        }
+    }
+    if (str != value) {
+        jerry_value_free(str);
+    }
+    if (len != NULL) {
+        *len = size;
+    }
+    return result;
+}
+
+/**
+ * @brief 调用会同步发送事件的设置函数：期间暂存缓冲区交给 LVGL 读取，
+ *        回调中的字符串转换改用临时缓冲区，返回后释放并恢复原缓冲区
+ */
+static void appsys_str_call_setter(void (*setter)(lv_obj_t*, const char*), lv_obj_t* obj, const char* text) {
+    char* saved = str_scratch;
+    size_t saved_size = str_scratch_size;
+    str_scratch = NULL;
+    str_scratch_size = 0;
+    str_scratch_depth++;
+    setter(obj, text);
+    str_scratch_depth--;
+    free(str_scratch);
+    str_scratch = saved;
+    str_scratch_size = saved_size;
+}
+
+/**
+ * @brief 把 JS 字符串驻留为静态文本（相同内容返回同一指针，VM 销毁前一直有效）
+ * @return const char* 驻留表已满或分配失败时返回 NULL
+ */
+const char* appsys_str_intern(jerry_value_t value) {
+    jerry_size_t len = 0;
+    const char* text = appsys_str_get(value, &len);
+    if (text == NULL) {
+        return NULL;
+    }
+    AppSysStrIntern_t* entry = NULL;
+    HASH_FIND(hh, str_interns, text, len, entry);
+    if (entry != NULL) {
+        return entry->text;
+    }
+    size_t bytes = sizeof(AppSysStrIntern_t) + (size_t)len + 1;
+    if (str_intern_bytes + bytes > APPSYS_STR_INTERN_LIMIT) {
+        return NULL;
+    }
+    entry = (AppSysStrIntern_t*)malloc(bytes);
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->len = (size_t)len;
+    memcpy(entry->text, text, (size_t)len + 1);
+    HASH_ADD_KEYPTR(hh, str_interns, entry->text, entry->len, entry);
+    str_intern_bytes += bytes;
+    return entry->text;
+}
+
+/**
+ * @brief 释放暂存缓冲区与驻留表（需在所有应用屏幕删除之后调用）
+ */
+void appsys_str_deinit(void) {
+    AppSysStrIntern_t* entry;
+    AppSysStrIntern_t* tmp;
+    HASH_ITER(hh, str_interns, entry, tmp) {
+        HASH_DEL(str_interns, entry);
+        free(entry);
+    }
+    str_intern_bytes = 0;
+    str_scratch_depth = 0;
+    free(str_scratch);
+    str_scratch = NULL;
+    str_scratch_size = 0;
+}
+
+/********************************** 文本函数 **********************************/
+
+typedef void (*AppSysTextSetter_t)(lv_obj_t* obj, const char* text);
+
+/**
+ * @brief 以暂存缓冲区中的文本调用复制型设置函数
+ * @param skip_same 文本与 getter 返回的当前文本相同时跳过（避免无意义的重排与重绘）
+ */
+static jerry_value_t appsys_str_set_text(const jerry_value_t args_p[], jerry_length_t args_count,
+    const lv_obj_class_t* cls, AppSysTextSetter_t setter, const char* (*getter)(const lv_obj_t*)) {
+    lv_obj_t* obj = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    if (obj == NULL || !lv_obj_check_type(obj, cls)) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "set_text: invalid object");
+    }
+    if (args_count < 2 || jerry_value_is_null(args_p[1]) || jerry_value_is_undefined(args_p[1])) {
+        // 只有标签接受 NULL（按当前文本刷新），其余控件视为空文本
+        setter(obj, cls == &lv_label_class ? NULL : "");
+        return jerry_undefined();
+    }
+    const char* text = appsys_str_get(args_p[1], NULL);
+    if (text == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "set_text: out of memory");
+    }
+    if (getter != NULL) {
+        const char* current = getter(obj);
+        if (current != NULL && strcmp(current, text) == 0) {
+            return jerry_undefined();
+        }
+    }
+    appsys_str_call_setter(setter, obj, text);
+    return jerry_undefined();
+}
+
+/**
+ * @brief 以驻留文本调用静态设置函数，驻留表已满时改用复制型函数
+ */
+static jerry_value_t appsys_str_set_text_static(const jerry_value_t args_p[], jerry_length_t args_count,
+    const lv_obj_class_t* cls, AppSysTextSetter_t setter_static, AppSysTextSetter_t setter) {
+    lv_obj_t* obj = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    if (obj == NULL || !lv_obj_check_type(obj, cls) || args_count < 2) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "set_text_static: expected (obj, text)");
+    }
+    const char* text = appsys_str_intern(args_p[1]);
+    if (text != NULL) {
+        setter_static(obj, text);
+        return jerry_undefined();
+    }
+    return appsys_str_set_text(args_p, args_count, cls, setter, NULL);
+}
+
+static const char* appsys_str_label_get_text(const lv_obj_t* obj) {
+    return lv_label_get_text(obj);
+}
+
+static const char* appsys_str_checkbox_get_text(const lv_obj_t* obj) {
+    return lv_checkbox_get_text(obj);
+}
+
+static const char* appsys_str_textarea_get_text(const lv_obj_t* obj) {
+    return lv_textarea_get_text(obj);
+}
+
+static jerry_value_t js_label_set_text(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text(args_p, args_count, &lv_label_class, lv_label_set_text, appsys_str_label_get_text);
+}
+
+static jerry_value_t js_label_set_text_static(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text_static(args_p, args_count, &lv_label_class,
+        lv_label_set_text_static, lv_label_set_text);
+}
+
+static jerry_value_t js_checkbox_set_text(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text(args_p, args_count, &lv_checkbox_class, lv_checkbox_set_text,
+        appsys_str_checkbox_get_text);
+}
+
+static jerry_value_t js_checkbox_set_text_static(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text_static(args_p, args_count, &lv_checkbox_class,
+        lv_checkbox_set_text_static, lv_checkbox_set_text);
+}
+
+static jerry_value_t js_textarea_set_text(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text(args_p, args_count, &lv_textarea_class, lv_textarea_set_text,
+        appsys_str_textarea_get_text);
+}
+
+static jerry_value_t js_textarea_add_text(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_str_set_text(args_p, args_count, &lv_textarea_class, lv_textarea_add_text, NULL);
+}
+
+/********************************** 数字格式化 **********************************/
+
+/**
+ * @brief 检查传给 printf 的格式字符串：只允许一个转换（可带标志、宽度与精度）和 %%
+ * @param fmt 格式字符串
+ * @param conversions 允许的转换字符，如整数用 "diuxXo"，字符串用 "s"
+ * @return true 格式安全
+ */
+bool appsys_str_check_fmt(const char* fmt, const char* conversions) {
+    int count = 0;
+    for (const char* p = fmt; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            continue;
+        }
+        while (*p != '\0' && strchr("-+ 0#", *p) != NULL) {
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+        if (*p == '.') {
+            p++;
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+        if (*p == '\0' || strchr(conversions, *p) == NULL) {
+            return false;
+        }
+        count++;
+    }
+    return count == 1;
+}
+
+/**
+ * @brief 文本与标签当前文本不同时才写入。标签自有的文本缓冲区放得下时直接改写，
+ *        再以 NULL 刷新（LVGL 对外部指针总是先释放再分配，对自身缓冲区只按新长度 realloc）
+ */
+static void appsys_str_label_update(lv_obj_t* label, const char* text) {
+    char* current = lv_label_get_text(label);
+    if (current != NULL && strcmp(current, text) == 0) {
+        return;
+    }
+    size_t len = strlen(text);
+    if (current != NULL && !((lv_label_t*)label)->static_txt && len <= strlen(current)) {
+        memcpy(current, text, len + 1);
+        lv_label_set_text(label, NULL);
+    }
+    else {
+        lv_label_set_text(label, text);
+    }
+}
+
+/**
+ * @brief label_set_int(label, value[, fmt]) 整数直接格式化为标签文本，fmt 默认 "%d"
+ */
+static jerry_value_t js_label_set_int(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* label = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    if (label == NULL || !lv_obj_check_type(label, &lv_label_class)) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "label_set_int: expected (label, value[, fmt])");
+    }
+    int32_t value = appsys_js_get_int(args_p, args_count, 1, 0);
+    char text[APPSYS_STR_FORMAT_SIZE];
+    if (args_count > 2 && jerry_value_is_string(args_p[2])) {
+        const char* fmt = appsys_str_get(args_p[2], NULL);
+        if (fmt == NULL || !appsys_str_check_fmt(fmt, "diuxXo")) {
+            return jerry_throw_sz(JERRY_ERROR_TYPE, "label_set_int: fmt must contain exactly one integer conversion");
+        }
+        snprintf(text, sizeof(text), fmt, value);
+    }
+    else {
+        snprintf(text, sizeof(text), "%d", (int)value);
+    }
+    appsys_str_label_update(label, text);
+    return jerry_undefined();
+}
+
+/**
+ * @brief label_set_fixed(label, value, decimals[, suffix]) 按固定小数位写入标签文本（四舍五入），
+ *        用整数运算格式化，不经过浮点 printf
+ */
+static jerry_value_t js_label_set_fixed(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    static const int64_t scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    lv_obj_t* label = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    if (label == NULL || !lv_obj_check_type(label, &lv_label_class)
+        || args_count < 2 || !jerry_value_is_number(args_p[1])) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "label_set_fixed: expected (label, value, decimals[, suffix])");
+    }
+    double value = jerry_value_as_number(args_p[1]);
+    int32_t decimals = LV_CLAMP(0, appsys_js_get_int(args_p, args_count, 2, 0), 6);
+
+    char text[APPSYS_STR_FORMAT_SIZE];
+    int len;
+    if (!isfinite(value)) {
+        len = snprintf(text, sizeof(text), "%s", isnan(value) ? "NaN" : value > 0 ? "Infinity" : "-Infinity");
+    }
+    else if (fabs(value) * (double)scales[decimals] > 9.0e15) {
+        // 超出 int64 可精确表示的范围，交给 printf
+        len = snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    }
+    else {
+        int64_t scaled = (int64_t)llround(value * (double)scales[decimals]);
+        bool negative = scaled < 0;
+        uint64_t mag = (uint64_t)(negative ? -scaled : scaled);
+        uint64_t int_part = mag / (uint64_t)scales[decimals];
+        uint64_t frac_part = mag % (uint64_t)scales[decimals];
+        if (decimals > 0) {
+            len = snprintf(text, sizeof(text), "%s%llu.%0*llu", negative ? "-" : "",
+                (unsigned long long)int_part, (int)decimals, (unsigned long long)frac_part);
+        }
+        else {
+            len = snprintf(text, sizeof(text), "%s%llu", negative ? "-" : "", (unsigned long long)int_part);
+        }
+    }
+
+    if (args_count > 3 && jerry_value_is_string(args_p[3]) && len > 0 && (size_t)len < sizeof(text)) {
+        jerry_size_t suffix_len = 0;
+        const char* suffix = appsys_str_get(args_p[3], &suffix_len);
+        if (suffix != NULL && (size_t)len + suffix_len < sizeof(text)) {
+            memcpy(text + len, suffix, (size_t)suffix_len + 1);
+        }
+    }
+    appsys_str_label_update(label, text);
+    return jerry_undefined();
+}
+
+/**
+ * @brief 文本函数列表（lv_* 覆盖绑定中的同名函数）
+ */
+static const AppSysFuncEntry appsys_str_funcs[] = {
+    {
+        .name = "lv_label_set_text",
+        .handler = js_label_set_text
+    },
+    {
+        .name = "lv_label_set_text_static",
+        .handler = js_label_set_text_static
+    },
+    {
+        .name = "lv_checkbox_set_text",
+        .handler = js_checkbox_set_text
+    },
+    {
+        .name = "lv_checkbox_set_text_static",
+        .handler = js_checkbox_set_text_static
+    },
+    {
+        .name = "lv_textarea_set_text",
+        .handler = js_textarea_set_text
+    },
+    {
+        .name = "lv_textarea_add_text",
+        .handler = js_textarea_add_text
+    },
+    {
+        .name = "label_set_int",
+        .handler = js_label_set_int
+    },
+    {
+        .name = "label_set_fixed",
+        .handler = js_label_set_fixed
+    },
+};
+
+/**
+ * @brief 将文本函数注册到当前 realm（需在 lv_binding_init 之后调用，以覆盖绑定中的文本函数）
+ */
+void appsys_str_register_natives(void) {
+    appsys_register_functions(appsys_str_funcs, sizeof(appsys_str_funcs) / sizeof(AppSysFuncEntry));
+}
@@ -0,0 +1,593 @@
+﻿/**
+ * @file appsys_subject.c
+ * @brief 响应式数据绑定实现
+ * @author Sab1e
+ * @date 2025-08-20
+ *
+ * 每个 subject 是一个原生 lv_subject_t，控件通过 LVGL observer 绑定到 subject，
+ * JS 只负责写入新值。写入前先与当前值比较，相同时直接返回，不通知观察者，也就不会
+ * 重设控件文本、不会产生无效区域；时钟类应用每秒写入全部数字，只有真正变化的那一位会重绘：
+ *
+ *   let h = subject_int(0), m = subject_int(0), s = subject_int(0);
+ *   bind_text(hour_label, h, "%02d");
+ *   bind_text(min_label, m, "%02d");
+ *   bind_text(sec_label, s, "%02d");
+ *   setInterval(function () {
+ *       let t = time_now();
+ *       subject_set(h, t.hour);            // 大多数时候值未变，不做任何原生更新
+ *       subject_set(m, t.minute);
+ *       subject_set(s, t.second);
+ *   }, 1000);
+ *
+ * JS 接口：
+ *   subject_int(value) / subject_string(value[, size])   创建，返回 ID
+ *   subject_set(id, value)                               写入，返回是否发生变化
+ *   subject_get(id) / subject_free(id)
+ *   subject_watch(id, func)                              值变化时回调 func(value)，添加时立即回调一次
+ *   bind_text(label, id[, fmt])                          标签文本，int subject 默认 "%d"
+ *   bind_value(widget, id)                               slider / arc / roller / dropdown 双向绑定
+ *   bind_checked(obj, id)                                LV_STATE_CHECKED 双向绑定
+ *   bind_flag(obj, id, flag, ref[, not_eq])              值等于（不等于）ref 时添加 flag，否则移除
+ *   bind_state(obj, id, state, ref[, not_eq])            同上，作用于状态
+ *
+ * 控件删除时 LVGL 自动移除对应的观察者；subject 随应用 realm 一起释放。
+ */
+
+#include "appsys_subject.h"
+#include "appsys_core.h"
+#include "appsys_event.h"
+#include "appsys_js_utils.h"
+#include "appsys_str.h"
+#include "appsys_conf.h"
+#include "lvgl/lvgl.h"
+#include "utlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct AppSysSubject;
+
+/**
+ * @brief JS 观察者
+ */
+typedef struct AppSysSubjectWatch {
+    struct AppSysSubject* subject;
+    jerry_value_t func;
+    struct AppSysSubjectWatch* next;
+} AppSysSubjectWatch_t;
+
+/**
+ * @brief 绑定使用的格式字符串，LVGL 只保存指针，需与 subject 同生命周期
+ */
+typedef struct AppSysSubjectFmt {
+    struct AppSysSubjectFmt* next;
+    char fmt[];
+} AppSysSubjectFmt_t;
+
+/**
+ * @brief 一个 subject
+ */
+typedef struct AppSysSubject {
+    uint32_t id;
+    jerry_value_t realm;             // 所属 realm，仅用作标识，不持有引用
+    lv_subject_t subject;
+    char* buf;                       // 字符串 subject 的当前值与上一个值，各 size 字节
+    char* prev_buf;
+    AppSysSubjectWatch_t* watches;
+    AppSysSubjectFmt_t* fmts;
+    uint32_t notify_depth;           // 正在回调 JS 观察者的层数
+    bool dead;                       // 回调期间被释放，等调用栈退出后再删除
+    struct AppSysSubject* next;
+} AppSysSubject_t;
+
+static AppSysSubject_t* subject_list = NULL;
+static uint32_t subject_next_id = 1;
+
+/**
+ * @brief 按 ID 查找 subject（已释放的不返回）
+ */
+static AppSysSubject_t* appsys_subject_find(uint32_t id) {
+    AppSysSubject_t* sub;
+    LL_FOREACH(subject_list, sub) {
+        if (sub->id == id && !sub->dead) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 按参数中的 ID 查找 subject
+ */
+static AppSysSubject_t* appsys_subject_get_arg(const jerry_value_t args_p[], jerry_length_t args_count,
+    jerry_length_t index) {
+    return appsys_subject_find((uint32_t)appsys_js_get_int(args_p, args_count, index, 0));
+}
+
+/**
+ * @brief 删除 subject：移除全部观察者（包括控件绑定）并释放
+ */
+static void appsys_subject_destroy(AppSysSubject_t* sub) {
+    lv_subject_deinit(&sub->subject);
+    AppSysSubjectWatch_t* w;
+    AppSysSubjectWatch_t* wtmp;
+    LL_FOREACH_SAFE(sub->watches, w, wtmp) {
+        jerry_value_free(w->func);
+        free(w);
+    }
+    AppSysSubjectFmt_t* f;
+    AppSysSubjectFmt_t* ftmp;
+    LL_FOREACH_SAFE(sub->fmts, f, ftmp) {
+        free(f);
+    }
+    free(sub->buf);
+    free(sub->prev_buf);
+    free(sub);
+}
+
+/**
+ * @brief 延迟删除回调期间被释放的 subject
+ */
+static void appsys_subject_async_free_cb(void* user_data) {
+    AppSysSubject_t* sub = (AppSysSubject_t*)user_data;
+    LL_DELETE(subject_list, sub);
+    appsys_subject_destroy(sub);
+}
+
+/**
+ * @brief 释放 subject。JS 观察者回调期间 lv_subject_notify 仍在遍历观察者，推迟到下一次 lv_timer_handler
+ */
+static void appsys_subject_free(AppSysSubject_t* sub) {
+    if (sub->notify_depth > 0) {
+        if (!sub->dead) {
+            sub->dead = true;
+            lv_async_call(appsys_subject_async_free_cb, sub);
+        }
+        return;
+    }
+    if (sub->dead) {
+        lv_async_call_cancel(appsys_subject_async_free_cb, sub);
+    }
+    LL_DELETE(subject_list, sub);
+    appsys_subject_destroy(sub);
+}
+
+/**
+ * @brief 释放 realm 的全部 subject（应用关闭时调用）
+ */
+void appsys_subject_free_realm(jerry_value_t realm) {
+    AppSysSubject_t* sub;
+    AppSysSubject_t* tmp;
+    LL_FOREACH_SAFE(subject_list, sub, tmp) {
+        if (sub->realm == realm) {
+            sub->notify_depth = 0;
+            appsys_subject_free(sub);
+        }
+    }
+}
+
+/**
+ * @brief 释放全部 subject（需在 jerry_cleanup 之前调用）
+ */
+void appsys_subject_deinit(void) {
+    AppSysSubject_t* sub;
+    AppSysSubject_t* tmp;
+    LL_FOREACH_SAFE(subject_list, sub, tmp) {
+        sub->notify_depth = 0;
+        appsys_subject_free(sub);
+    }
+}
+
+/**
+ * @brief 把 subject 的当前值转换为 JS 值
+ */
+static jerry_value_t appsys_subject_value(lv_subject_t* subject) {
+    if (subject->type == LV_SUBJECT_TYPE_STRING) {
+        return jerry_string_sz(lv_subject_get_string(subject));
+    }
+    return jerry_number((double)lv_subject_get_int(subject));
+}
+
+/**
+ * @brief 把 JS 值转换为字符串，按 size（含 '\0'）截断
+ * @param local 调用者提供的缓冲区，size 不超过 local_size 时使用
+ * @return char* 结果，不是 local 时调用者负责 free；分配失败返回 NULL
+ */
+static char* appsys_subject_to_cstr(jerry_value_t value, size_t size, char* local, size_t local_size) {
+    char* buf = size > local_size ? (char*)malloc(size) : local;
+    if (buf == NULL) {
+        return NULL;
+    }
+    jerry_size_t len = 0;
+    if (!jerry_value_is_undefined(value)) {
+        jerry_value_t str = jerry_value_to_string(value);
+        if (jerry_value_is_string(str)) {
+            len = jerry_string_to_buffer(str, JERRY_ENCODING_UTF8, (jerry_char_t*)buf, (jerry_size_t)size - 1);
+        }
+        jerry_value_free(str);
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+/**
+ * @brief 创建 subject 记录并加入列表
+ */
+static AppSysSubject_t* appsys_subject_alloc(void) {
+    AppSysSubject_t* sub = (AppSysSubject_t*)calloc(1, sizeof(AppSysSubject_t));
+    if (sub == NULL) {
+        return NULL;
+    }
+    sub->id = subject_next_id++;
+    sub->realm = jerry_current_realm();
+    jerry_value_free(sub->realm);
+    LL_APPEND(subject_list, sub);
+    return sub;
+}
+
+/********************************** JS 接口 **********************************/
+
+/**
+ * @brief subject_int(value) 创建整数 subject
+ */
+static jerry_value_t js_subject_int(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysSubject_t* sub = appsys_subject_alloc();
+    if (sub == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "subject_int: out of memory");
+    }
+    lv_subject_init_int(&sub->subject, appsys_js_get_int(args_p, args_count, 0, 0));
+    return jerry_number((double)sub->id);
+}
+
+/**
+ * @brief subject_string(value[, size]) 创建字符串 subject，size 为包含 '\0' 的最大长度
+ */
+static jerry_value_t js_subject_string(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    int32_t size = appsys_js_get_int(args_p, args_count, 1, APPSYS_SUBJECT_STRING_SIZE);
+    if (size < 2) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "subject_string: size too small");
+    }
+    char local[APPSYS_SUBJECT_STRING_SIZE];
+    char* value = appsys_subject_to_cstr(args_count > 0 ? args_p[0] : jerry_undefined(), (size_t)size,
+        local, sizeof(local));
+    AppSysSubject_t* sub = value != NULL ? appsys_subject_alloc() : NULL;
+    if (sub != NULL) {
+        sub->buf = (char*)malloc((size_t)size);
+        sub->prev_buf = (char*)malloc((size_t)size);
+    }
+    if (sub == NULL || sub->buf == NULL || sub->prev_buf == NULL) {
+        if (sub != NULL) {
+            LL_DELETE(subject_list, sub);
+            free(sub->buf);
+            free(sub->prev_buf);
+            free(sub);
+        }
+        if (value != local) {
+            free(value);
+        }
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "subject_string: out of memory");
+    }
+    lv_subject_init_string(&sub->subject, sub->buf, sub->prev_buf, (size_t)size, value);
+    if (value != local) {
+        free(value);
+    }
+    return jerry_number((double)sub->id);
+}
+
+/**
+ * @brief subject_set(id, value) 写入新值，与当前值相同时不通知观察者
+ * @return boolean 值是否发生变化
+ */
+static jerry_value_t js_subject_set(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysSubject_t* sub = appsys_subject_get_arg(args_p, args_count, 0);
+    if (sub == NULL || args_count < 2) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "subject_set: expected (subject, value)");
+    }
+    lv_subject_t* subject = &sub->subject;
+    if (subject->type == LV_SUBJECT_TYPE_STRING) {
+        // 按 subject 的容量截断后再比较，避免超长字符串每次都被当作变化
+        char local[APPSYS_SUBJECT_STRING_SIZE];
+        char* tmp = appsys_subject_to_cstr(args_p[1], subject->size, local, sizeof(local));
+        if (tmp == NULL) {
+            return jerry_throw_sz(JERRY_ERROR_RANGE, "subject_set: out of memory");
+        }
+        bool changed = strcmp(lv_subject_get_string(subject), tmp) != 0;
+        if (changed) {
+            lv_subject_copy_string(subject, tmp);
+        }
+        if (tmp != local) {
+            free(tmp);
+        }
+        return jerry_boolean(changed);
+    }
+
+    int32_t value = appsys_js_get_int(args_p, args_count, 1, 0);
+    bool changed = lv_subject_get_int(subject) != value;
+    if (changed) {
+        lv_subject_set_int(subject, value);
+    }
+    return jerry_boolean(changed);
+}
+
+/**
+ * @brief subject_get(id) 读取当前值
+ */
+static jerry_value_t js_subject_get(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysSubject_t* sub = appsys_subject_get_arg(args_p, args_count, 0);
+    if (sub == NULL) {
+        return jerry_undefined();
+    }
+    return appsys_subject_value(&sub->subject);
+}
+
+/**
+ * @brief subject_free(id) 释放 subject，绑定的控件保持最后的值
+ */
+static jerry_value_t js_subject_free(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysSubject_t* sub = appsys_subject_get_arg(args_p, args_count, 0);
+    if (sub == NULL) {
+        return jerry_boolean(false);
+    }
+    appsys_subject_free(sub);
+    return jerry_boolean(true);
+}
+
+/**
+ * @brief JS 观察者回调
+ */
+static void appsys_subject_watch_cb(lv_observer_t* observer, lv_subject_t* subject) {
+    AppSysSubjectWatch_t* w = (AppSysSubjectWatch_t*)lv_observer_get_user_data(observer);
+    AppSysSubject_t* sub = w->subject;
+    if (sub->dead) {
+        return;
+    }
+    jerry_value_t value = appsys_subject_value(subject);
+    jerry_value_t func = jerry_value_copy(w->func);
+    sub->notify_depth++;
+    jerry_value_t ret = appsys_event_call(func, jerry_undefined(), &value, 1);
+    sub->notify_depth--;
+    jerry_value_free(ret);
+    jerry_value_free(func);
+    jerry_value_free(value);
+}
+
+/**
+ * @brief subject_watch(id, func) 值变化时回调 func(value)
+ */
+static jerry_value_t js_subject_watch(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysSubject_t* sub = appsys_subject_get_arg(args_p, args_count, 0);
+    if (sub == NULL || args_count < 2 || !jerry_value_is_function(args_p[1])) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "subject_watch: expected (subject, function)");
+    }
+    AppSysSubjectWatch_t* w = (AppSysSubjectWatch_t*)calloc(1, sizeof(AppSysSubjectWatch_t));
+    if (w == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "subject_watch: out of memory");
+    }
+    w->subject = sub;
+    w->func = jerry_value_copy(args_p[1]);
+    LL_APPEND(sub->watches, w);
+    lv_subject_add_observer(&sub->subject, appsys_subject_watch_cb, w);
+    return jerry_boolean(true);
+}
+
+/**
+ * @brief 读取绑定函数的控件与 subject 参数
+ */
+static bool appsys_subject_get_binding(const jerry_value_t args_p[], jerry_length_t args_count,
+    lv_obj_t** obj, AppSysSubject_t** sub) {
+    *obj = args_count > 0 ? (lv_obj_t*)appsys_js_get_ptr(args_p[0]) : NULL;
+    *sub = appsys_subject_get_arg(args_p, args_count, 1);
+    return *obj != NULL && *sub != NULL;
+}
+
+/**
+ * @brief bind_text(label, id[, fmt]) 标签文本跟随 subject。fmt 对 int subject 须含且只含一个整数转换，
+ *        对 string subject 须含且只含一个 %s，否则抛出 TypeError
+ */
+static jerry_value_t js_bind_text(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* obj;
+    AppSysSubject_t* sub;
+    if (!appsys_subject_get_binding(args_p, args_count, &obj, &sub)
+        || !lv_obj_check_type(obj, &lv_label_class)) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_text: expected (label, subject[, fmt])");
+    }
+    const char* fmt = sub->subject.type == LV_SUBJECT_TYPE_INT ? "%d" : NULL;
+    if (args_count > 2 && jerry_value_is_string(args_p[2])) {
+        jerry_size_t size = jerry_string_size(args_p[2], JERRY_ENCODING_UTF8);
+        AppSysSubjectFmt_t* f = (AppSysSubjectFmt_t*)malloc(sizeof(AppSysSubjectFmt_t) + size + 1);
+        if (f == NULL) {
+            return jerry_throw_sz(JERRY_ERROR_RANGE, "bind_text: out of memory");
+        }
+        jerry_string_to_buffer(args_p[2], JERRY_ENCODING_UTF8, (jerry_char_t*)f->fmt, size);
+        f->fmt[size] = '\0';
+        // 格式字符串直接交给 printf：int subject 只允许一个整数转换，string subject 只允许一个 %s
+        bool is_int = sub->subject.type == LV_SUBJECT_TYPE_INT;
+        if (!appsys_str_check_fmt(f->fmt, is_int ? "diuxXo" : "s")) {
+            free(f);
+            return jerry_throw_sz(JERRY_ERROR_TYPE, is_int
+                ? "bind_text: fmt must contain exactly one integer conversion for an int subject"
+                : "bind_text: fmt must contain exactly one %s for a string subject");
+        }
+        LL_PREPEND(sub->fmts, f);
+        fmt = f->fmt;
+    }
+    return jerry_boolean(lv_label_bind_text(obj, &sub->subject, fmt) != NULL);
+}
+
+/**
+ * @brief bind_value(widget, id) 数值控件与 int subject 双向绑定
+ */
+static jerry_value_t js_bind_value(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* obj;
+    AppSysSubject_t* sub;
+    if (!appsys_subject_get_binding(args_p, args_count, &obj, &sub)
+        || sub->subject.type != LV_SUBJECT_TYPE_INT) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_value: expected (widget, int subject)");
+    }
+    lv_observer_t* observer = NULL;
+    if (lv_obj_check_type(obj, &lv_slider_class)) {
+        observer = lv_slider_bind_value(obj, &sub->subject);
+    }
+    else if (lv_obj_check_type(obj, &lv_arc_class)) {
+        observer = lv_arc_bind_value(obj, &sub->subject);
+    }
+    else if (lv_obj_check_type(obj, &lv_roller_class)) {
+        observer = lv_roller_bind_value(obj, &sub->subject);
+    }
+    else if (lv_obj_check_type(obj, &lv_dropdown_class)) {
+        observer = lv_dropdown_bind_value(obj, &sub->subject);
+    }
+    else {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_value: unsupported widget");
+    }
+    return jerry_boolean(observer != NULL);
+}
+
+/**
+ * @brief bind_checked(obj, id) LV_STATE_CHECKED 与 int subject 双向绑定
+ */
+static jerry_value_t js_bind_checked(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* obj;
+    AppSysSubject_t* sub;
+    if (!appsys_subject_get_binding(args_p, args_count, &obj, &sub)
+        || sub->subject.type != LV_SUBJECT_TYPE_INT) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_checked: expected (obj, int subject)");
+    }
+    return jerry_boolean(lv_obj_bind_checked(obj, &sub->subject) != NULL);
+}
+
+/**
+ * @brief bind_flag(obj, id, flag, ref[, not_eq])
+ */
+static jerry_value_t js_bind_flag(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* obj;
+    AppSysSubject_t* sub;
+    if (!appsys_subject_get_binding(args_p, args_count, &obj, &sub) || args_count < 4
+        || sub->subject.type != LV_SUBJECT_TYPE_INT) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_flag: expected (obj, int subject, flag, ref[, not_eq])");
+    }
+    lv_obj_flag_t flag = (lv_obj_flag_t)appsys_js_get_int(args_p, args_count, 2, 0);
+    int32_t ref = appsys_js_get_int(args_p, args_count, 3, 0);
+    bool not_eq = args_count > 4 && jerry_value_to_boolean(args_p[4]);
+    lv_observer_t* observer = not_eq ? lv_obj_bind_flag_if_not_eq(obj, &sub->subject, flag, ref)
+        : lv_obj_bind_flag_if_eq(obj, &sub->subject, flag, ref);
+    return jerry_boolean(observer != NULL);
+}
+
+/**
+ * @brief bind_state(obj, id, state, ref[, not_eq])
+ */
+static jerry_value_t js_bind_state(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    lv_obj_t* obj;
+    AppSysSubject_t* sub;
+    if (!appsys_subject_get_binding(args_p, args_count, &obj, &sub) || args_count < 4
+        || sub->subject.type != LV_SUBJECT_TYPE_INT) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "bind_state: expected (obj, int subject, state, ref[, not_eq])");
+    }
+    lv_state_t state = (lv_state_t)appsys_js_get_int(args_p, args_count, 2, 0);
+    int32_t ref = appsys_js_get_int(args_p, args_count, 3, 0);
+    bool not_eq = args_count > 4 && jerry_value_to_boolean(args_p[4]);
+    lv_observer_t* observer = not_eq ? lv_obj_bind_state_if_not_eq(obj, &sub->subject, state, ref)
+        : lv_obj_bind_state_if_eq(obj, &sub->subject, state, ref);
+    return jerry_boolean(observer != NULL);
+}
+
+/**
+ * @brief 数据绑定原生函数列表
+ */
+static const AppSysFuncEntry appsys_subject_funcs[] = {
+    {
+        .name = "subject_int",
+        .handler = js_subject_int
+    },
+    {
+        .name = "subject_string",
+        .handler = js_subject_string
+    },
+    {
+        .name = "subject_set",
+        .handler = js_subject_set
+    },
+    {
+        .name = "subject_get",
+        .handler = js_subject_get
+    },
+    {
+        .name = "subject_free",
+        .handler = js_subject_free
+    },
+    {
+        .name = "subject_watch",
+        .handler = js_subject_watch
+    },
+    {
+        .name = "bind_text",
+        .handler = js_bind_text
+    },
+    {
+        .name = "bind_value",
+        .handler = js_bind_value
+    },
+    {
+        .name = "bind_checked",
+        .handler = js_bind_checked
+    },
+    {
+        .name = "bind_flag",
+        .handler = js_bind_flag
+    },
+    {
+        .name = "bind_state",
+        .handler = js_bind_state
+    },
+};
+
+/**
+ * @brief 将数据绑定函数注册到当前 realm
+ */
+void appsys_subject_register_natives(void) {
+    appsys_register_functions(appsys_subject_funcs, sizeof(appsys_subject_funcs) / sizeof(AppSysFuncEntry));
+}
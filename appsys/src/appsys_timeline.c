@@ -0,0 +1,467 @@
+﻿/**
+ * @file appsys_timeline.c
+ * @brief 声明式动画时间线实现
+ * @author Sab1e
+ * @date 2025-08-18
+ *
+ * JS 只在开始时调用一次 anim_timeline 描述全部轨道，之后每帧的计算和属性设置都在 lv_anim 中完成，
+ * 动画帧耗时与脚本执行速度无关；全部轨道结束后才回调一次 JS。
+ *
+ *   let id = anim_timeline([
+ *       { target: box, prop: ANIM_PROP_X, values: [0, 120, 100], duration: 400, ease: ANIM_EASE_OUT },
+ *       { target: box, prop: ANIM_PROP_OPA, values: [0, 255], duration: 200, delay: 100,
+ *         repeat: 0, playback: false, times: [0, 200] },
+ *   ], function () { print("done"); });
+ *   anim_timeline_stop(id[, finish]);
+ *
+ * 轨道字段：target 控件，prop 为 ANIM_PROP_*，values 为关键帧（ANIM_PROP_POS 时每帧两个值），
+ * times 为各关键帧的时间 [ms]（缺省时均匀分布），ease 作用于每段关键帧之间，
+ * delay 为相对时间线开始的偏移，repeat 为重复次数（-1 表示无限），playback 为往返播放。
+ *
+ * 每条轨道是一个 lv_anim，var 指向轨道记录，控件被删除时通过 LV_EVENT_DELETE 删除对应动画。
+ * 应用挂起时保存 lv_anim 的运行状态并删除，恢复时按原进度重新启动。
+ */
+
+#include "appsys_timeline.h"
+#include "appsys_anim.h"
+#include "appsys_core.h"
+#include "appsys_event.h"
+#include "appsys_js_utils.h"
+#include "lvgl/lvgl.h"
+#include "utlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct AppSysTimeline;
+
+/**
+ * @brief 单条轨道
+ */
+typedef struct AppSysTrack {
+    struct AppSysTimeline* timeline;
+    lv_obj_t* target;
+    lv_anim_t* anim;             // 运行中的动画，挂起时为 NULL
+    lv_anim_t saved;             // 挂起时保存的动画状态
+    bool paused;
+    AppSysAnimProp_t prop;
+    AppSysAnimEase_t ease;
+    uint32_t key_count;
+    uint32_t stride;             // 每个关键帧的值个数
+    int32_t* values;             // key_count * stride 个值
+    int32_t* times;              // key_count 个时间点，Q10 进度
+    struct AppSysTrack* next;
+} AppSysTrack_t;
+
+/**
+ * @brief 一条时间线（一次 anim_timeline 调用）
+ */
+typedef struct AppSysTimeline {
+    uint32_t id;
+    jerry_value_t realm;         // 所属 realm，仅用作标识，不持有引用
+    jerry_value_t on_done;
+    AppSysTrack_t* tracks;
+    uint32_t pending;            // 尚未结束的轨道数量
+    struct AppSysTimeline* next;
+} AppSysTimeline_t;
+
+static AppSysTimeline_t* timeline_list = NULL;
+static uint32_t timeline_next_id = 1;
+
+static void appsys_timeline_delete_cb(lv_event_t* e);
+
+/**
+ * @brief 按 ID 查找时间线
+ */
+static AppSysTimeline_t* appsys_timeline_find(uint32_t id) {
+    AppSysTimeline_t* tl;
+    LL_FOREACH(timeline_list, tl) {
+        if (tl->id == id) {
+            return tl;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 按进度计算轨道当前的值并写入控件
+ * @param t 线性进度，0 ~ APPSYS_ANIM_T_MAX
+ */
+static void appsys_track_apply(AppSysTrack_t* track, int32_t t) {
+    uint32_t k = 0;
+    while (k + 2 < track->key_count && t > track->times[k + 1]) {
+        k++;
+    }
+    int32_t t0 = track->times[k];
+    int32_t t1 = track->times[k + 1];
+    int32_t local = t1 > t0 ? (int32_t)(((int64_t)LV_CLAMP(t0, t, t1) - t0) * APPSYS_ANIM_T_MAX / (t1 - t0))
+        : APPSYS_ANIM_T_MAX;
+    int32_t progress = appsys_anim_ease(track->ease, local);
+
+    const int32_t* from = track->values + k * track->stride;
+    const int32_t* to = from + track->stride;
+    int32_t value[2];
+    for (uint32_t i = 0; i < track->stride; i++) {
+        value[i] = appsys_anim_interp(from[i], to[i], progress);
+    }
+    appsys_anim_set_prop(track->target, track->prop, value);
+}
+
+/**
+ * @brief 删除轨道的动画与删除事件回调并释放轨道（不改变时间线的计数）
+ * @param target_deleted 目标控件正在被删除，事件回调随控件一起释放
+ */
+static void appsys_track_free(AppSysTrack_t* track, bool target_deleted) {
+    if (track->anim != NULL) {
+        track->anim = NULL;
+        lv_anim_delete(track, NULL);
+    }
+    if (!target_deleted) {
+        lv_obj_remove_event_cb_with_user_data(track->target, appsys_timeline_delete_cb, track);
+    }
+    LL_DELETE(track->timeline->tracks, track);
+    free(track);
+}
+
+/**
+ * @brief 释放时间线及其全部轨道
+ */
+static void appsys_timeline_free(AppSysTimeline_t* tl) {
+    AppSysTrack_t* track;
+    AppSysTrack_t* tmp;
+    LL_FOREACH_SAFE(tl->tracks, track, tmp) {
+        appsys_track_free(track, false);
+    }
+    LL_DELETE(timeline_list, tl);
+    jerry_value_free(tl->on_done);
+    free(tl);
+}
+
+/**
+ * @brief 一条轨道结束；全部结束时释放时间线，正常完成时回调 JS
+ * @param completed 动画正常播放完毕（而不是目标控件被删除）
+ */
+static void appsys_track_finish(AppSysTrack_t* track, bool completed) {
+    AppSysTimeline_t* tl = track->timeline;
+    appsys_track_free(track, !completed);
+    if (--tl->pending > 0) {
+        return;
+    }
+    // 先释放再回调，回调中可以安全地启动新的时间线
+    jerry_value_t on_done = jerry_value_copy(tl->on_done);
+    appsys_timeline_free(tl);
+    if (completed && jerry_value_is_function(on_done)) {
+        jerry_value_free(appsys_event_call(on_done, jerry_undefined(), NULL, 0));
+    }
+    jerry_value_free(on_done);
+}
+
+/**
+ * @brief lv_anim 执行回调
+ */
+static void appsys_timeline_exec_cb(lv_anim_t* a, int32_t v) {
+    appsys_track_apply((AppSysTrack_t*)a->var, v);
+}
+
+/**
+ * @brief lv_anim 完成回调（之后 LVGL 自行释放该动画）
+ */
+static void appsys_timeline_completed_cb(lv_anim_t* a) {
+    AppSysTrack_t* track = (AppSysTrack_t*)a->var;
+    track->anim = NULL;
+    appsys_track_finish(track, true);
+}
+
+/**
+ * @brief 目标控件被删除时结束轨道
+ */
+static void appsys_timeline_delete_cb(lv_event_t* e) {
+    AppSysTrack_t* track = (AppSysTrack_t*)lv_event_get_user_data(e);
+    appsys_track_finish(track, false);
+}
+
+/**
+ * @brief 时间线批量操作类型
+ */
+typedef enum {
+    TIMELINE_OP_PAUSE,
+    TIMELINE_OP_RESUME,
+    TIMELINE_OP_FREE,
+} AppSysTimelineOp_t;
+
+/**
+ * @brief 对属于某个 realm 的时间线执行操作
+ */
+static void appsys_timeline_for_realm(jerry_value_t realm, AppSysTimelineOp_t op) {
+    AppSysTimeline_t* tl;
+    AppSysTimeline_t* tmp;
+    LL_FOREACH_SAFE(timeline_list, tl, tmp) {
+        if (tl->realm != realm) {
+            continue;
+        }
+        if (op == TIMELINE_OP_FREE) {
+            appsys_timeline_free(tl);
+            continue;
+        }
+        AppSysTrack_t* track;
+        LL_FOREACH(tl->tracks, track) {
+            if (op == TIMELINE_OP_PAUSE && track->anim != NULL) {
+                // 保存进度、重复次数与往返方向，删除后不再占用动画定时器
+                track->saved = *track->anim;
+                track->anim = NULL;
+                track->paused = true;
+                lv_anim_delete(track, NULL);
+            }
+            else if (op == TIMELINE_OP_RESUME && track->paused) {
+                track->paused = false;
+                lv_anim_set_early_apply(&track->saved, false);
+                track->anim = lv_anim_start(&track->saved);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 暂停某个应用的全部时间线
+ * @param realm 应用的 realm
+ */
+void appsys_timeline_pause_realm(jerry_value_t realm) {
+    appsys_timeline_for_realm(realm, TIMELINE_OP_PAUSE);
+}
+
+/**
+ * @brief 恢复某个应用的全部时间线
+ * @param realm 应用的 realm
+ */
+void appsys_timeline_resume_realm(jerry_value_t realm) {
+    appsys_timeline_for_realm(realm, TIMELINE_OP_RESUME);
+}
+
+/**
+ * @brief 释放某个应用的全部时间线
+ * @param realm 应用的 realm
+ */
+void appsys_timeline_free_realm(jerry_value_t realm) {
+    appsys_timeline_for_realm(realm, TIMELINE_OP_FREE);
+}
+
+/**
+ * @brief 释放全部时间线（需在 jerry_cleanup 之前调用）
+ */
+void appsys_timeline_deinit(void) {
+    AppSysTimeline_t* tl;
+    AppSysTimeline_t* tmp;
+    LL_FOREACH_SAFE(timeline_list, tl, tmp) {
+        appsys_timeline_free(tl);
+    }
+}
+
+/********************************** 轨道描述解析 **********************************/
+
+/**
+ * @brief 读取对象属性
+ * @return jerry_value_t 属性值，调用者负责释放
+ */
+static jerry_value_t appsys_timeline_get(jerry_value_t obj, const char* name) {
+    jerry_value_t key = jerry_string_sz(name);
+    jerry_value_t value = jerry_object_get(obj, key);
+    jerry_value_free(key);
+    return value;
+}
+
+/**
+ * @brief 读取整数属性，缺失或不是数字时返回 def
+ */
+static int32_t appsys_timeline_get_int(jerry_value_t obj, const char* name, int32_t def) {
+    jerry_value_t value = appsys_timeline_get(obj, name);
+    int32_t result = jerry_value_is_number(value) ? jerry_value_as_int32(value) : def;
+    jerry_value_free(value);
+    return result;
+}
+
+/**
+ * @brief 读取数字数组（Array 或 Int32Array）的长度与元素
+ * @param out 输出缓冲区，NULL 时只返回长度
+ * @return uint32_t 元素个数，不是数组时返回 0
+ */
+static uint32_t appsys_timeline_get_ints(jerry_value_t array, int32_t* out) {
+    if (!jerry_value_is_array(array) && !jerry_value_is_typedarray(array)) {
+        return 0;
+    }
+    uint32_t count = jerry_value_is_array(array) ? jerry_array_length(array) : jerry_typedarray_length(array);
+    for (uint32_t i = 0; out != NULL && i < count; i++) {
+        jerry_value_t item = jerry_object_get_index(array, i);
+        out[i] = jerry_value_is_number(item) ? jerry_value_as_int32(item) : 0;
+        jerry_value_free(item);
+    }
+    return count;
+}
+
+/**
+ * @brief 按描述创建一条轨道并启动动画
+ * @return const char* 失败原因，成功时返回 NULL
+ */
+static const char* appsys_track_create(AppSysTimeline_t* tl, jerry_value_t spec) {
+    if (!jerry_value_is_object(spec)) {
+        return "anim_timeline: track must be an object";
+    }
+    jerry_value_t target_val = appsys_timeline_get(spec, "target");
+    lv_obj_t* target = (lv_obj_t*)appsys_js_get_ptr(target_val);
+    jerry_value_free(target_val);
+    int32_t prop = appsys_timeline_get_int(spec, "prop", -1);
+    if (target == NULL || prop < 0 || prop >= APPSYS_ANIM_PROP_COUNT) {
+        return "anim_timeline: track needs a target object and an ANIM_PROP_* prop";
+    }
+
+    uint32_t stride = prop == APPSYS_ANIM_PROP_POS ? 2 : 1;
+    jerry_value_t values = appsys_timeline_get(spec, "values");
+    uint32_t value_count = appsys_timeline_get_ints(values, NULL);
+    uint32_t key_count = value_count / stride;
+    if (key_count < 2) {
+        jerry_value_free(values);
+        return "anim_timeline: track needs at least two keyframes in values";
+    }
+
+    AppSysTrack_t* track = (AppSysTrack_t*)calloc(1, sizeof(AppSysTrack_t)
+        + sizeof(int32_t) * (value_count + key_count));
+    if (track == NULL) {
+        jerry_value_free(values);
+        return "anim_timeline: out of memory";
+    }
+    track->timeline = tl;
+    track->target = target;
+    track->prop = (AppSysAnimProp_t)prop;
+    int32_t ease = appsys_timeline_get_int(spec, "ease", APPSYS_ANIM_EASE_LINEAR);
+    track->ease = (ease >= 0 && ease < APPSYS_ANIM_EASE_COUNT) ? (AppSysAnimEase_t)ease : APPSYS_ANIM_EASE_LINEAR;
+    track->key_count = key_count;
+    track->stride = stride;
+    track->values = (int32_t*)(track + 1);
+    track->times = track->values + value_count;
+    appsys_timeline_get_ints(values, track->values);
+    jerry_value_free(values);
+
+    // 时间点换算为 Q10 进度；未给出或个数不符时均匀分布
+    int32_t duration = LV_MAX(1, appsys_timeline_get_int(spec, "duration", 300));
+    jerry_value_t times = appsys_timeline_get(spec, "times");
+    if (appsys_timeline_get_ints(times, NULL) == key_count) {
+        appsys_timeline_get_ints(times, track->times);
+        for (uint32_t i = 0; i < key_count; i++) {
+            int32_t ms = LV_CLAMP(0, track->times[i], duration);
+            track->times[i] = (int32_t)(((int64_t)ms * APPSYS_ANIM_T_MAX) / duration);
+        }
+    }
+    else {
+        for (uint32_t i = 0; i < key_count; i++) {
+            track->times[i] = (int32_t)(((int64_t)i * APPSYS_ANIM_T_MAX) / (key_count - 1));
+        }
+    }
+    jerry_value_free(times);
+
+    int32_t repeat = appsys_timeline_get_int(spec, "repeat", 0);
+    jerry_value_t playback = appsys_timeline_get(spec, "playback");
+    bool use_playback = jerry_value_to_boolean(playback);
+    jerry_value_free(playback);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, track);
+    lv_anim_set_custom_exec_cb(&a, appsys_timeline_exec_cb);
+    lv_anim_set_completed_cb(&a, appsys_timeline_completed_cb);
+    lv_anim_set_values(&a, 0, APPSYS_ANIM_T_MAX);
+    lv_anim_set_duration(&a, (uint32_t)duration);
+    lv_anim_set_delay(&a, (uint32_t)LV_MAX(0, appsys_timeline_get_int(spec, "delay", 0)));
+    lv_anim_set_repeat_count(&a, repeat < 0 ? LV_ANIM_REPEAT_INFINITE : (uint32_t)repeat + 1);
+    if (use_playback) {
+        lv_anim_set_playback_duration(&a, (uint32_t)duration);
+    }
+
+    LL_APPEND(tl->tracks, track);
+    tl->pending++;
+    lv_obj_add_event_cb(target, appsys_timeline_delete_cb, LV_EVENT_DELETE, track);
+    track->anim = lv_anim_start(&a);
+    return NULL;
+}
+
+/********************************** 原生函数定义 **********************************/
+
+/**
+ * @brief anim_timeline(tracks[, on_done])，tracks 为轨道描述对象或其数组，返回时间线 ID
+ */
+static jerry_value_t js_anim_timeline(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (args_count < 1 || !jerry_value_is_object(args_p[0])) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "anim_timeline: expected (track | track[], on_done)");
+    }
+    AppSysTimeline_t* tl = (AppSysTimeline_t*)calloc(1, sizeof(AppSysTimeline_t));
+    if (tl == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "anim_timeline: out of memory");
+    }
+    tl->id = timeline_next_id++;
+    tl->realm = jerry_current_realm();
+    jerry_value_free(tl->realm);
+    tl->on_done = args_count > 1 ? jerry_value_copy(args_p[1]) : jerry_undefined();
+    LL_APPEND(timeline_list, tl);
+
+    const char* error = NULL;
+    if (jerry_value_is_array(args_p[0])) {
+        uint32_t count = jerry_array_length(args_p[0]);
+        for (uint32_t i = 0; i < count && error == NULL; i++) {
+            jerry_value_t spec = jerry_object_get_index(args_p[0], i);
+            error = appsys_track_create(tl, spec);
+            jerry_value_free(spec);
+        }
+    }
+    else {
+        error = appsys_track_create(tl, args_p[0]);
+    }
+    if (error != NULL || tl->tracks == NULL) {
+        appsys_timeline_free(tl);
+        return jerry_throw_sz(JERRY_ERROR_TYPE, error != NULL ? error : "anim_timeline: no tracks");
+    }
+    return jerry_number((double)tl->id);
+}
+
+/**
+ * @brief anim_timeline_stop(id[, finish])，finish 为 true 时各轨道先跳到最后一帧，不回调 on_done
+ */
+static jerry_value_t js_anim_timeline_stop(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysTimeline_t* tl = appsys_timeline_find((uint32_t)appsys_js_get_int(args_p, args_count, 0, 0));
+    if (tl == NULL) {
+        return jerry_boolean(false);
+    }
+    if (args_count > 1 && jerry_value_to_boolean(args_p[1])) {
+        AppSysTrack_t* track;
+        LL_FOREACH(tl->tracks, track) {
+            appsys_track_apply(track, APPSYS_ANIM_T_MAX);
+        }
+    }
+    appsys_timeline_free(tl);
+    return jerry_boolean(true);
+}
+
+/**
+ * @brief 时间线原生函数列表
+ */
+static const AppSysFuncEntry appsys_timeline_funcs[] = {
+    {
+        .name = "anim_timeline",
+        .handler = js_anim_timeline
+    },
+    {
+        .name = "anim_timeline_stop",
+        .handler = js_anim_timeline_stop
+    },
+};
+
+/**
+ * @brief 将时间线函数注册到当前 realm
+ */
+void appsys_timeline_register_natives(void) {
+    appsys_register_functions(appsys_timeline_funcs, sizeof(appsys_timeline_funcs) / sizeof(AppSysFuncEntry));
+}
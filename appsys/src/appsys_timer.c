@@ -0,0 +1,237 @@
+﻿/**
+ * @file appsys_timer.c
+ * @brief 应用定时器实现
+ * @author Sab1e
+ * @date 2025-08-08
+ *
+ * 定时器基于 lv_timer，由系统主循环驱动，JS 无需自己循环调用 lv_timer_handler。
+ * 每个定时器记录创建它的 realm，应用被挂起时其定时器随之暂停，被关闭时全部释放。
+ */
+
+#include "appsys_timer.h"
+#include "appsys_core.h"
+#include "appsys_event.h"
+#include "appsys_js_utils.h"
+#include "lvgl/lvgl.h"
+#include "utlist.h"
+#include <stdlib.h>
+
+/**
+ * @brief 单个 JS 定时器
+ */
+typedef struct AppSysTimer {
+    uint32_t id;
+    lv_timer_t* timer;
+    jerry_value_t func;
+    jerry_value_t realm;         // 所属 realm，仅用作标识，不持有引用
+    bool repeat;
+    struct AppSysTimer* next;
+} AppSysTimer_t;
+
+static AppSysTimer_t* timer_list = NULL;
+static uint32_t timer_next_id = 1;
+
+/**
+ * @brief 按 ID 查找定时器
+ */
+static AppSysTimer_t* appsys_timer_find(uint32_t id) {
+    AppSysTimer_t* t;
+    LL_FOREACH(timer_list, t) {
+        if (t->id == id) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 删除定时器并释放其持有的 JS 函数
+ */
+static void appsys_timer_free(AppSysTimer_t* t) {
+    LL_DELETE(timer_list, t);
+    lv_timer_delete(t->timer);
+    jerry_value_free(t->func);
+    free(t);
+}
+
+/**
+ * @brief lv_timer 回调：调用 JS 函数，单次定时器在调用后释放
+ */
+static void appsys_timer_cb(lv_timer_t* timer) {
+    uint32_t id = (uint32_t)(uintptr_t)lv_timer_get_user_data(timer);
+    AppSysTimer_t* t = appsys_timer_find(id);
+    if (t == NULL) {
+        return;
+    }
+    jerry_value_t ret = appsys_event_call(t->func, jerry_undefined(), NULL, 0);
+    jerry_value_free(ret);
+
+    // 回调中可能已经 clearTimeout 了自己，需要重新查找
+    t = appsys_timer_find(id);
+    if (t != NULL && !t->repeat) {
+        appsys_timer_free(t);
+    }
+}
+
+/**
+ * @brief 创建定时器的公共实现
+ */
+static jerry_value_t appsys_timer_create(const jerry_value_t args_p[], const jerry_length_t args_count, bool repeat) {
+    if (args_count < 1 || !jerry_value_is_function(args_p[0])) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "timer: first argument must be a function");
+    }
+    int32_t period = appsys_js_get_int(args_p, args_count, 1, 0);
+    if (period < 1) {
+        period = 1;
+    }
+
+    AppSysTimer_t* t = (AppSysTimer_t*)malloc(sizeof(AppSysTimer_t));
+    if (t == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_RANGE, "timer: out of memory");
+    }
+    jerry_value_t realm = jerry_current_realm();
+    t->id = timer_next_id++;
+    t->func = jerry_value_copy(args_p[0]);
+    t->realm = realm;
+    t->repeat = repeat;
+    t->timer = lv_timer_create(appsys_timer_cb, (uint32_t)period, (void*)(uintptr_t)t->id);
+    jerry_value_free(realm);
+    LL_APPEND(timer_list, t);
+    return jerry_number((double)t->id);
+}
+
+/**
+ * @brief 定时器批量操作类型
+ */
+typedef enum {
+    TIMER_OP_PAUSE,
+    TIMER_OP_RESUME,
+    TIMER_OP_FREE,
+} AppSysTimerOp_t;
+
+/**
+ * @brief 对属于某个 realm 的定时器执行操作
+ */
+static void appsys_timer_for_realm(jerry_value_t realm, AppSysTimerOp_t op) {
+    AppSysTimer_t* t;
+    AppSysTimer_t* tmp;
+    LL_FOREACH_SAFE(timer_list, t, tmp) {
+        if (t->realm != realm) {
+            continue;
+        }
+        switch (op) {
+        case TIMER_OP_PAUSE:
+            lv_timer_pause(t->timer);
+            break;
+        case TIMER_OP_RESUME:
+            lv_timer_resume(t->timer);
+            break;
+        case TIMER_OP_FREE:
+            appsys_timer_free(t);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 暂停某个应用的全部定时器
+ * @param realm 应用的 realm
+ */
+void appsys_timer_pause_realm(jerry_value_t realm) {
+    appsys_timer_for_realm(realm, TIMER_OP_PAUSE);
+}
+
+/**
+ * @brief 恢复某个应用的全部定时器
+ * @param realm 应用的 realm
+ */
+void appsys_timer_resume_realm(jerry_value_t realm) {
+    appsys_timer_for_realm(realm, TIMER_OP_RESUME);
+}
+
+/**
+ * @brief 释放某个应用的全部定时器
+ * @param realm 应用的 realm
+ */
+void appsys_timer_free_realm(jerry_value_t realm) {
+    appsys_timer_for_realm(realm, TIMER_OP_FREE);
+}
+
+/**
+ * @brief 释放全部定时器（需在 jerry_cleanup 之前调用）
+ */
+void appsys_timer_deinit(void) {
+    AppSysTimer_t* t;
+    AppSysTimer_t* tmp;
+    LL_FOREACH_SAFE(timer_list, t, tmp) {
+        appsys_timer_free(t);
+    }
+}
+
+/********************************** 原生函数定义 **********************************/
+
+/**
+ * @brief setTimeout(func, ms)
+ */
+static jerry_value_t js_set_timeout_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_timer_create(args_p, args_count, false);
+}
+
+/**
+ * @brief setInterval(func, ms)
+ */
+static jerry_value_t js_set_interval_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    return appsys_timer_create(args_p, args_count, true);
+}
+
+/**
+ * @brief clearTimeout(id) / clearInterval(id)
+ */
+static jerry_value_t js_clear_timer_handler(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    AppSysTimer_t* t = appsys_timer_find((uint32_t)appsys_js_get_int(args_p, args_count, 0, 0));
+    if (t != NULL) {
+        appsys_timer_free(t);
+    }
+    return jerry_undefined();
+}
+
+/**
+ * @brief 定时器原生函数列表
+ */
+static const AppSysFuncEntry appsys_timer_funcs[] = {
+    {
+        .name = "setTimeout",
+        .handler = js_set_timeout_handler
+    },
+    {
+        .name = "setInterval",
+        .handler = js_set_interval_handler
+    },
+    {
+        .name = "clearTimeout",
+        .handler = js_clear_timer_handler
+    },
+    {
+        .name = "clearInterval",
+        .handler = js_clear_timer_handler
+    },
+};
+
+/**
+ * @brief 将定时器函数注册到当前 realm
+ */
+void appsys_timer_register_natives(void) {
+    appsys_register_functions(appsys_timer_funcs, sizeof(appsys_timer_funcs) / sizeof(AppSysFuncEntry));
+}
@@ -0,0 +1,601 @@
+﻿/**
+ * @file appsys_ui.c
+ * @brief 二进制界面描述加载器实现
+ * @author Sab1e
+ * @date 2025-08-19
+ *
+ * 界面在打包时由 appsys/tools/ui_compile.py 从 JSON 编译为二进制，符号名已解析为数字，
+ * 加载时顺序读取一遍即可创建整棵控件树，不经过 JS 逐个调用绑定函数：
+ *
+ *   let ui = ui_load("main", lv_screen_active(), { on_ok: function (e) { ... } });
+ *   lv_label_set_text(ui.title, "Hello");      // 带 id 的控件
+ *   lv_obj_delete(ui.root);                    // 根控件
+ *
+ * src 可以是应用包中的界面名（ApplicationPackage_t.ui），也可以是包含二进制界面的 ArrayBuffer / TypedArray；
+ * 包中没有同名界面时读取 APPSYS_UI_DIR/<name>.ui，文件内容缓存在内存中，再次加载同一界面不再读盘。
+ * 事件回调在 handlers 对象中按名字查找，通过 appsys_event_register 注册。
+ * 样式只接受数值与颜色属性白名单（ui_num_props / ui_color_props），值为指针的属性一律拒绝。
+ */
+
+#include "appsys_ui.h"
+#include "appsys_core.h"
+#include "appsys_buf.h"
+#include "appsys_event.h"
+#include "appsys_js_utils.h"
+#include "appsys_port.h"
+#include "appsys_conf.h"
+#include "utlist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 控件类型，下标为 AppSysUiClassId_t
+ */
+typedef struct {
+    const lv_obj_class_t* cls;
+    lv_obj_t* (*create)(lv_obj_t* parent);
+} AppSysUiClass_t;
+
+static const AppSysUiClass_t ui_classes[] = {
+    [UI_CLASS_OBJ]      = { &lv_obj_class,      lv_obj_create      },
+    [UI_CLASS_LABEL]    = { &lv_label_class,    lv_label_create    },
+    [UI_CLASS_BUTTON]   = { &lv_button_class,   lv_button_create   },
+    [UI_CLASS_CHECKBOX] = { &lv_checkbox_class, lv_checkbox_create },
+    [UI_CLASS_TEXTAREA] = { &lv_textarea_class, lv_textarea_create },
+    [UI_CLASS_SLIDER]   = { &lv_slider_class,   lv_slider_create   },
+    [UI_CLASS_BAR]      = { &lv_bar_class,      lv_bar_create      },
+    [UI_CLASS_ARC]      = { &lv_arc_class,      lv_arc_create      },
+    [UI_CLASS_SWITCH]   = { &lv_switch_class,   lv_switch_create   },
+    [UI_CLASS_DROPDOWN] = { &lv_dropdown_class, lv_dropdown_create },
+    [UI_CLASS_ROLLER]   = { &lv_roller_class,   lv_roller_create   },
+    [UI_CLASS_IMAGE]    = { &lv_image_class,    lv_image_create    },
+};
+#define UI_CLASS_COUNT (sizeof(ui_classes) / sizeof(ui_classes[0]))
+
+/**
+ * @brief ui_compile.py 能生成的样式属性，与其中的 STYLE_NUM_PROPS / STYLE_COLOR_PROPS 一致。
+ *        其余属性的值是指针（字体、图片源、过渡、颜色滤镜等），从界面数据中读出的数字不能当作指针使用
+ */
+static const lv_style_prop_t ui_num_props[] = {
+    LV_STYLE_WIDTH, LV_STYLE_MIN_WIDTH, LV_STYLE_MAX_WIDTH, LV_STYLE_HEIGHT, LV_STYLE_MIN_HEIGHT,
+    LV_STYLE_MAX_HEIGHT, LV_STYLE_X, LV_STYLE_Y, LV_STYLE_ALIGN, LV_STYLE_LENGTH, LV_STYLE_TRANSLATE_X,
+    LV_STYLE_TRANSLATE_Y, LV_STYLE_TRANSFORM_WIDTH, LV_STYLE_TRANSFORM_HEIGHT,
+    LV_STYLE_TRANSFORM_SCALE_X, LV_STYLE_TRANSFORM_SCALE_Y, LV_STYLE_TRANSFORM_ROTATION,
+    LV_STYLE_TRANSFORM_PIVOT_X, LV_STYLE_TRANSFORM_PIVOT_Y, LV_STYLE_PAD_TOP, LV_STYLE_PAD_BOTTOM,
+    LV_STYLE_PAD_LEFT, LV_STYLE_PAD_RIGHT, LV_STYLE_PAD_ROW, LV_STYLE_PAD_COLUMN, LV_STYLE_RADIUS,
+    LV_STYLE_CLIP_CORNER, LV_STYLE_OPA, LV_STYLE_OPA_LAYERED, LV_STYLE_COLOR_FILTER_OPA,
+    LV_STYLE_BLEND_MODE, LV_STYLE_BASE_DIR, LV_STYLE_BG_OPA, LV_STYLE_BG_GRAD_DIR,
+    LV_STYLE_BG_MAIN_STOP, LV_STYLE_BG_GRAD_STOP, LV_STYLE_BG_MAIN_OPA, LV_STYLE_BG_GRAD_OPA,
+    LV_STYLE_BG_IMAGE_OPA, LV_STYLE_BG_IMAGE_RECOLOR_OPA, LV_STYLE_BG_IMAGE_TILED, LV_STYLE_BORDER_OPA,
+    LV_STYLE_BORDER_WIDTH, LV_STYLE_BORDER_SIDE, LV_STYLE_BORDER_POST, LV_STYLE_OUTLINE_WIDTH,
+    LV_STYLE_OUTLINE_OPA, LV_STYLE_OUTLINE_PAD, LV_STYLE_SHADOW_WIDTH, LV_STYLE_SHADOW_OFFSET_X,
+    LV_STYLE_SHADOW_OFFSET_Y, LV_STYLE_SHADOW_SPREAD, LV_STYLE_SHADOW_OPA, LV_STYLE_IMAGE_OPA,
+    LV_STYLE_IMAGE_RECOLOR_OPA, LV_STYLE_LINE_WIDTH, LV_STYLE_LINE_DASH_WIDTH, LV_STYLE_LINE_DASH_GAP,
+    LV_STYLE_LINE_ROUNDED, LV_STYLE_LINE_OPA, LV_STYLE_ARC_WIDTH, LV_STYLE_ARC_ROUNDED,
+    LV_STYLE_ARC_OPA, LV_STYLE_TEXT_OPA, LV_STYLE_TEXT_LETTER_SPACE, LV_STYLE_TEXT_LINE_SPACE,
+    LV_STYLE_TEXT_DECOR, LV_STYLE_TEXT_ALIGN, LV_STYLE_ANIM_DURATION,
+};
+
+static const lv_style_prop_t ui_color_props[] = {
+    LV_STYLE_BG_COLOR, LV_STYLE_BG_GRAD_COLOR, LV_STYLE_BG_IMAGE_RECOLOR, LV_STYLE_BORDER_COLOR,
+    LV_STYLE_OUTLINE_COLOR, LV_STYLE_SHADOW_COLOR, LV_STYLE_IMAGE_RECOLOR, LV_STYLE_LINE_COLOR,
+    LV_STYLE_ARC_COLOR, LV_STYLE_TEXT_COLOR,
+};
+
+/**
+ * @brief 一次加载的上下文
+ */
+typedef struct {
+    AppSysReader_t rd;
+    jerry_value_t ids;           // 输出：id -> 控件
+    jerry_value_t handlers;      // 输入：回调名 -> 函数
+    uint32_t widgets;
+    const char* error;
+} AppSysUiLoader_t;
+
+/**
+ * @brief 从 APPSYS_UI_DIR 读入的界面文件，VM 销毁前一直缓存
+ */
+typedef struct AppSysUiFile {
+    char* name;
+    uint8_t* data;
+    size_t size;
+    struct AppSysUiFile* next;
+} AppSysUiFile_t;
+
+static AppSysUiFile_t* ui_files = NULL;
+
+/********************************** 加载 **********************************/
+
+/**
+ * @brief 读取坐标
+ */
+static int32_t appsys_ui_get_coord(AppSysReader_t* rd) {
+    uint8_t kind = appsys_reader_u8(rd);
+    int32_t value = appsys_reader_svarint(rd);
+    switch (kind) {
+    case UI_COORD_PCT:
+        return lv_pct(value);
+    case UI_COORD_CONTENT:
+        return LV_SIZE_CONTENT;
+    default:
+        return value;
+    }
+}
+
+/**
+ * @brief 设置控件文本
+ */
+static void appsys_ui_set_text(lv_obj_t* obj, const lv_obj_class_t* cls, const char* text) {
+    if (cls == &lv_label_class) {
+        lv_label_set_text(obj, text);
+    }
+    else if (cls == &lv_checkbox_class) {
+        lv_checkbox_set_text(obj, text);
+    }
+    else if (cls == &lv_textarea_class) {
+        lv_textarea_set_text(obj, text);
+    }
+}
+
+/**
+ * @brief 设置范围类控件的范围与数值
+ */
+static void appsys_ui_set_range(lv_obj_t* obj, const lv_obj_class_t* cls, int32_t min, int32_t max) {
+    if (cls == &lv_arc_class) {
+        lv_arc_set_range(obj, min, max);
+    }
+    else if (cls == &lv_slider_class || cls == &lv_bar_class) {
+        lv_bar_set_range(obj, min, max);
+    }
+}
+
+static void appsys_ui_set_value(lv_obj_t* obj, const lv_obj_class_t* cls, int32_t value) {
+    if (cls == &lv_arc_class) {
+        lv_arc_set_value(obj, value);
+    }
+    else if (cls == &lv_slider_class || cls == &lv_bar_class) {
+        lv_bar_set_value(obj, value, LV_ANIM_OFF);
+    }
+}
+
+/**
+ * @brief 取得控件的 JS 包装，首次使用时创建
+ */
+static jerry_value_t appsys_ui_wrap(lv_obj_t* obj, jerry_value_t* wrapper) {
+    if (*wrapper == 0) {
+        *wrapper = appsys_js_new_ptr(obj);
+    }
+    return *wrapper;
+}
+
+/**
+ * @brief 检查样式属性是否在白名单中
+ */
+static bool appsys_ui_style_allowed(lv_style_prop_t prop, bool is_color) {
+    const lv_style_prop_t* props = is_color ? ui_color_props : ui_num_props;
+    size_t count = is_color ? sizeof(ui_color_props) / sizeof(ui_color_props[0])
+        : sizeof(ui_num_props) / sizeof(ui_num_props[0]);
+    for (size_t i = 0; i < count; i++) {
+        if (props[i] == prop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 注册事件回调
+ * @return false 回调不存在
+ */
+static bool appsys_ui_bind_event(AppSysUiLoader_t* ld, lv_obj_t* obj, jerry_value_t* wrapper,
+    lv_event_code_t code, const char* name) {
+    jerry_value_t func = jerry_undefined();
+    if (jerry_value_is_object(ld->handlers)) {
+        jerry_value_t key = jerry_string_sz(name);
+        func = jerry_object_get(ld->handlers, key);
+        jerry_value_free(key);
+    }
+    bool ok = jerry_value_is_function(func);
+    if (ok) {
+        jerry_value_t user_data = jerry_undefined();
+        appsys_event_register(obj, appsys_ui_wrap(obj, wrapper), code, func, user_data);
+        jerry_value_free(user_data);
+    }
+    else {
+        printf("[ui] handler '%s' not found\n", name);
+    }
+    jerry_value_free(func);
+    return ok;
+}
+
+/**
+ * @brief 读取一个节点及其子树，在 parent 下创建控件
+ * @return lv_obj_t* 创建的控件，数据损坏时返回 NULL（已创建的部分由调用者随根控件删除）
+ */
+static lv_obj_t* appsys_ui_load_node(AppSysUiLoader_t* ld, lv_obj_t* parent, int depth) {
+    AppSysReader_t* rd = &ld->rd;
+    uint8_t index = appsys_reader_u8(rd);
+    if (rd->error || index >= UI_CLASS_COUNT || depth > APPSYS_UI_MAX_DEPTH) {
+        ld->error = "ui_load: corrupt ui data";
+        return NULL;
+    }
+    const AppSysUiClass_t* uc = &ui_classes[index];
+    lv_obj_t* obj = uc->create(parent);
+    jerry_value_t wrapper = 0;
+    ld->widgets++;
+
+    uint32_t prop_count = appsys_reader_varint(rd);
+    for (uint32_t i = 0; i < prop_count && !rd->error && ld->error == NULL; i++) {
+        uint8_t prop_id = appsys_reader_u8(rd);
+        switch ((AppSysUiProp_t)prop_id) {
+        case UI_PROP_ID: {
+            const char* id = appsys_reader_str(rd, NULL);
+            jerry_value_t key = jerry_string_sz(id);
+            jerry_value_free(jerry_object_set(ld->ids, key, appsys_ui_wrap(obj, &wrapper)));
+            jerry_value_free(key);
+            break;
+        }
+        case UI_PROP_X:
+            lv_obj_set_x(obj, appsys_ui_get_coord(rd));
+            break;
+        case UI_PROP_Y:
+            lv_obj_set_y(obj, appsys_ui_get_coord(rd));
+            break;
+        case UI_PROP_WIDTH:
+            lv_obj_set_width(obj, appsys_ui_get_coord(rd));
+            break;
+        case UI_PROP_HEIGHT:
+            lv_obj_set_height(obj, appsys_ui_get_coord(rd));
+            break;
+        case UI_PROP_ALIGN:
+            lv_obj_set_align(obj, (lv_align_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_TEXT:
+            appsys_ui_set_text(obj, uc->cls, appsys_reader_str(rd, NULL));
+            break;
+        case UI_PROP_OPTIONS: {
+            const char* options = appsys_reader_str(rd, NULL);
+            if (uc->cls == &lv_dropdown_class) {
+                lv_dropdown_set_options(obj, options);
+            }
+            else if (uc->cls == &lv_roller_class) {
+                lv_roller_set_options(obj, options, LV_ROLLER_MODE_NORMAL);
+            }
+            break;
+        }
+        case UI_PROP_SELECTED: {
+            uint32_t selected = appsys_reader_varint(rd);
+            if (uc->cls == &lv_dropdown_class) {
+                lv_dropdown_set_selected(obj, selected);
+            }
+            else if (uc->cls == &lv_roller_class) {
+                lv_roller_set_selected(obj, selected, LV_ANIM_OFF);
+            }
+            break;
+        }
+        case UI_PROP_RANGE: {
+            int32_t min = appsys_reader_svarint(rd);
+            int32_t max = appsys_reader_svarint(rd);
+            appsys_ui_set_range(obj, uc->cls, min, max);
+            break;
+        }
+        case UI_PROP_VALUE:
+            appsys_ui_set_value(obj, uc->cls, appsys_reader_svarint(rd));
+            break;
+        case UI_PROP_FLAG_ADD:
+            lv_obj_add_flag(obj, (lv_obj_flag_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_FLAG_REMOVE:
+            lv_obj_remove_flag(obj, (lv_obj_flag_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_STATE:
+            lv_obj_add_state(obj, (lv_state_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_FLEX_FLOW:
+            lv_obj_set_flex_flow(obj, (lv_flex_flow_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_FLEX_ALIGN: {
+            lv_flex_align_t main_place = (lv_flex_align_t)appsys_reader_varint(rd);
+            lv_flex_align_t cross_place = (lv_flex_align_t)appsys_reader_varint(rd);
+            lv_flex_align_t track_place = (lv_flex_align_t)appsys_reader_varint(rd);
+            lv_obj_set_flex_align(obj, main_place, cross_place, track_place);
+            break;
+        }
+        case UI_PROP_FLEX_GROW:
+            lv_obj_set_flex_grow(obj, (uint8_t)appsys_reader_varint(rd));
+            break;
+        case UI_PROP_STYLE_NUM:
+        case UI_PROP_STYLE_COLOR: {
+            bool is_color = prop_id == UI_PROP_STYLE_COLOR;
+            lv_style_prop_t prop = (lv_style_prop_t)appsys_reader_varint(rd);
+            lv_style_selector_t selector = (lv_style_selector_t)appsys_reader_varint(rd);
+            lv_style_value_t value = { 0 };
+            if (is_color) {
+                value.color = lv_color_hex(appsys_reader_varint(rd));
+            }
+            else {
+                value.num = appsys_reader_svarint(rd);
+            }
+            if (!rd->error && !appsys_ui_style_allowed(prop, is_color)) {
+                ld->error = "ui_load: style property not allowed";
+            }
+            else if (!rd->error) {
+                lv_obj_set_local_style_prop(obj, prop, value, selector);
+            }
+            break;
+        }
+        case UI_PROP_EVENT: {
+            lv_event_code_t code = (lv_event_code_t)appsys_reader_varint(rd);
+            const char* name = appsys_reader_str(rd, NULL);
+            if (!rd->error && !appsys_ui_bind_event(ld, obj, &wrapper, code, name)) {
+                ld->error = "ui_load: event handler not found";
+            }
+            break;
+        }
+        case UI_PROP_SRC: {
+            const char* src = appsys_reader_str(rd, NULL);
+            if (uc->cls == &lv_image_class) {
+                lv_image_set_src(obj, src);
+            }
+            break;
+        }
+        default:
+            // 未知属性无法跳过，只能视为数据损坏
+            rd->error = true;
+            break;
+        }
+    }
+    if (wrapper != 0) {
+        jerry_value_free(wrapper);
+    }
+    if (rd->error && ld->error == NULL) {
+        ld->error = "ui_load: corrupt ui data";
+    }
+    if (ld->error != NULL) {
+        return NULL;
+    }
+
+    uint32_t child_count = appsys_reader_varint(rd);
+    for (uint32_t i = 0; i < child_count; i++) {
+        if (appsys_ui_load_node(ld, obj, depth + 1) == NULL) {
+            return NULL;
+        }
+    }
+    return obj;
+}
+
+/**
+ * @brief 按二进制界面描述创建控件树
+ * @param data 二进制界面数据（加载完成后不再引用，可随即释放）
+ * @param size 数据大小 [byte]
+ * @param parent 父控件
+ * @param ids JS 对象，带 id 的控件以 id 为属性名写入其中
+ * @param handlers JS 对象，按回调名查找事件回调，可为 undefined
+ * @param widget_count 输出创建的控件数量，可为 NULL
+ * @param error 失败时输出错误信息，可为 NULL
+ * @return lv_obj_t* 根控件，失败时已删除创建到一半的控件树并返回 NULL
+ */
+lv_obj_t* appsys_ui_load(const uint8_t* data, size_t size, lv_obj_t* parent,
+    jerry_value_t ids, jerry_value_t handlers, uint32_t* widget_count, const char** error) {
+    AppSysUiLoader_t ld;
+    memset(&ld, 0, sizeof(ld));
+    ld.ids = ids;
+    ld.handlers = handlers;
+    appsys_reader_init(&ld.rd, data, size);
+
+    const uint8_t* magic = appsys_reader_get(&ld.rd, 4);
+    uint8_t version = appsys_reader_u8(&ld.rd);
+    lv_obj_t* root = NULL;
+    if (ld.rd.error || memcmp(magic, UI_MAGIC, 4) != 0) {
+        ld.error = "ui_load: not a ui file";
+    }
+    else if (version != UI_VERSION) {
+        ld.error = "ui_load: unsupported ui version";
+    }
+    else {
+        // 根节点先创建出来，失败时整棵树随根控件删除
+        uint32_t child_count = lv_obj_get_child_count(parent);
+        root = appsys_ui_load_node(&ld, parent, 0);
+        if (root == NULL && lv_obj_get_child_count(parent) > child_count) {
+            lv_obj_delete(lv_obj_get_child(parent, (int32_t)child_count));
+        }
+    }
+
+    if (widget_count != NULL) {
+        *widget_count = ld.widgets;
+    }
+    if (error != NULL) {
+        *error = ld.error;
+    }
+    return root;
+}
+
+/********************************** 界面文件缓存 **********************************/
+
+/**
+ * @brief 界面名只能是 APPSYS_UI_DIR 下的文件名，不能含路径分隔符或 ".."
+ */
+static bool appsys_ui_name_valid(const char* name) {
+    return name[0] != '\0' && strpbrk(name, "/\\") == NULL && strstr(name, "..") == NULL;
+}
+
+/**
+ * @brief 读取 APPSYS_UI_DIR 下的界面文件，已读过的直接返回缓存
+ * @return AppSysUiFile_t* 界面名无效、文件不存在或读取失败时返回 NULL
+ */
+static AppSysUiFile_t* appsys_ui_get_file(const char* name) {
+    if (!appsys_ui_name_valid(name)) {
+        return NULL;
+    }
+    AppSysUiFile_t* file;
+    LL_FOREACH(ui_files, file) {
+        if (strcmp(file->name, name) == 0) {
+            return file;
+        }
+    }
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s.ui", APPSYS_UI_DIR, name);
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t* data = len > 0 ? (uint8_t*)malloc((size_t)len) : NULL;
+    file = (AppSysUiFile_t*)calloc(1, sizeof(AppSysUiFile_t));
+    char* name_copy = (char*)malloc(strlen(name) + 1);
+    if (data == NULL || file == NULL || name_copy == NULL
+        || fread(data, 1, (size_t)len, fp) != (size_t)len) {
+        fclose(fp);
+        free(data);
+        free(file);
+        free(name_copy);
+        return NULL;
+    }
+    fclose(fp);
+    strcpy(name_copy, name);
+    file->name = name_copy;
+    file->data = data;
+    file->size = (size_t)len;
+    LL_PREPEND(ui_files, file);
+    return file;
+}
+
+/**
+ * @brief 按名字查找界面：先查当前应用包，再查 APPSYS_UI_DIR
+ * @return true 找到
+ */
+static bool appsys_ui_find(const char* name, const uint8_t** data, size_t* size) {
+    jerry_value_t realm = jerry_current_realm();
+    const ApplicationPackage_t* app = appsys_get_package(realm);
+    jerry_value_free(realm);
+    if (app != NULL && app->ui != NULL) {
+        for (uint32_t i = 0; i < app->ui_count; i++) {
+            if (strcmp(app->ui[i].name, name) == 0) {
+                *data = app->ui[i].data;
+                *size = app->ui[i].size;
+                return true;
+            }
+        }
+    }
+    AppSysUiFile_t* file = appsys_ui_get_file(name);
+    if (file == NULL) {
+        return false;
+    }
+    *data = file->data;
+    *size = file->size;
+    return true;
+}
+
+/**
+ * @brief 释放界面文件缓存（VM 销毁时调用）
+ */
+void appsys_ui_deinit(void) {
+    AppSysUiFile_t* file;
+    AppSysUiFile_t* tmp;
+    LL_FOREACH_SAFE(ui_files, file, tmp) {
+        LL_DELETE(ui_files, file);
+        free(file->name);
+        free(file->data);
+        free(file);
+    }
+}
+
+/********************************** JS 接口 **********************************/
+
+/**
+ * @brief ui_load(src, parent[, handlers]) 创建界面，返回 { root, <id>: 控件, ... }
+ */
+static jerry_value_t js_ui_load(const jerry_call_info_t* call_info_p,
+    const jerry_value_t args_p[],
+    const jerry_length_t args_count)
+{
+    (void)call_info_p;
+    if (args_count < 2) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "ui_load: expected (src, parent[, handlers])");
+    }
+    lv_obj_t* parent = (lv_obj_t*)appsys_js_get_ptr(args_p[1]);
+    if (parent == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "ui_load: parent is not an lv_obj");
+    }
+
+    const uint8_t* data = NULL;
+    size_t size = 0;
+    char name[64] = "<buffer>";
+    if (jerry_value_is_string(args_p[0])) {
+        if (jerry_string_size(args_p[0], JERRY_ENCODING_UTF8) >= sizeof(name)) {
+            return jerry_throw_sz(JERRY_ERROR_RANGE, "ui_load: ui name too long");
+        }
+        jerry_size_t len = jerry_string_to_buffer(args_p[0], JERRY_ENCODING_UTF8,
+            (jerry_char_t*)name, sizeof(name) - 1);
+        name[len] = '\0';
+        if (!appsys_ui_name_valid(name)) {
+            return jerry_throw_sz(JERRY_ERROR_TYPE, "ui_load: invalid ui name");
+        }
+        if (!appsys_ui_find(name, &data, &size)) {
+            return jerry_throw_sz(JERRY_ERROR_REFERENCE, "ui_load: ui not found");
+        }
+    }
+    else if (jerry_value_is_typedarray(args_p[0])) {
+        jerry_length_t offset = 0;
+        jerry_length_t byte_length = 0;
+        jerry_value_t buffer = jerry_typedarray_buffer(args_p[0], &offset, &byte_length);
+        uint8_t* bytes = jerry_arraybuffer_data(buffer);
+        jerry_value_free(buffer);
+        data = bytes != NULL ? bytes + offset : NULL;
+        size = byte_length;
+    }
+    else if (jerry_value_is_arraybuffer(args_p[0])) {
+        data = jerry_arraybuffer_data(args_p[0]);
+        size = jerry_arraybuffer_size(args_p[0]);
+    }
+    if (data == NULL) {
+        return jerry_throw_sz(JERRY_ERROR_TYPE, "ui_load: src must be a ui name or ArrayBuffer");
+    }
+
+    jerry_value_t handlers = args_count > 2 ? args_p[2] : jerry_undefined();
+    jerry_value_t ids = jerry_object();
+    uint32_t widgets = 0;
+    const char* error = NULL;
+    uint64_t start_us = appsys_port_get_time_us();
+    lv_obj_t* root = appsys_ui_load(data, size, parent, ids, handlers, &widgets, &error);
+    if (root == NULL) {
+        jerry_value_free(ids);
+        // 界面数据损坏或不被支持不是脚本的语法错误
+        return jerry_throw_sz(JERRY_ERROR_TYPE, error != NULL ? error : "ui_load: failed");
+    }
+#if APPSYS_UI_TRACE
+    printf("[ui] %s: %u widgets (%u B) in %u us\n", name, widgets, (unsigned)size,
+        (uint32_t)(appsys_port_get_time_us() - start_us));
+#else
+    (void)start_us;
+#endif
+
+    jerry_value_t key = jerry_string_sz("root");
+    jerry_value_t root_obj = appsys_js_new_ptr(root);
+    jerry_value_free(jerry_object_set(ids, key, root_obj));
+    jerry_value_free(root_obj);
+    jerry_value_free(key);
+    return ids;
+}
+
+/**
+ * @brief 界面加载原生函数列表
+ */
+static const AppSysFuncEntry appsys_ui_funcs[] = {
+    {
+        .name = "ui_load",
+        .handler = js_ui_load
+    },
+};
+
+/**
+ * @brief 将界面加载函数注册到当前 realm
+ */
+void appsys_ui_register_natives(void) {
+    appsys_register_functions(appsys_ui_funcs, sizeof(appsys_ui_funcs) / sizeof(AppSysFuncEntry));
+}
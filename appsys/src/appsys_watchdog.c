@@ -0,0 +1,147 @@
+﻿/**
+ * @file appsys_watchdog.c
+ * @brief 脚本看门狗实现
+ * @author Sab1e
+ * @date 2025-08-11
+ *
+ * 原生代码每次进入 JS（主脚本、事件回调、定时器、生命周期函数）都由 begin / end 包围，
+ * 最外层 begin 记录开始时间。VM 每执行 APPSYS_WATCHDOG_CHECK_INTERVAL 个检查点回调一次
+ * halt handler，超出所属应用的预算后打印调用栈并返回不可捕获的 abort，
+ * 之后的每次检查都继续返回 abort，直到调用栈完全退出，应用随后由系统终止。
+ *
+ * 计时只在最外层 begin 时重置：从系统主循环进入的每个回调各自拥有完整的预算，
+ * JS 自己循环调用 lv_timer_handler 时嵌套执行的回调不会刷新计时，这类脚本同样受预算限制。
+ *
+ * 需要以 --vm-halt=ON 编译 JerryScript，调用栈中的行号需要 --line-info=ON。
+ */
+
+#include "appsys_watchdog.h"
+#include "appsys_core.h"
+#include "appsys_port.h"
+#include "appsys_conf.h"
+#include <stdio.h>
+
+static uint32_t run_depth = 0;          // JS 调用嵌套深度，0 表示没有脚本在运行
+static uint64_t run_start_us = 0;       // 最外层调用的开始时间
+static bool run_expired = false;        // 本次运行已超时，正在退出调用栈
+
+/**
+ * @brief 打印当前 JS 调用栈
+ */
+static void appsys_watchdog_print_backtrace(void) {
+    jerry_value_t frames = jerry_backtrace(APPSYS_WATCHDOG_BACKTRACE_DEPTH);
+    uint32_t count = jerry_array_length(frames);
+    if (count == 0) {
+        printf("    <no backtrace, build JerryScript with --line-info=ON>\n");
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        jerry_value_t frame = jerry_object_get_index(frames, i);
+        jerry_char_t buf[128];
+        jerry_size_t size = jerry_string_size(frame, JERRY_ENCODING_UTF8);
+        if (jerry_value_is_string(frame) && size < sizeof(buf)) {
+            jerry_string_to_buffer(frame, JERRY_ENCODING_UTF8, buf, size);
+            buf[size] = '\0';
+            printf("    at %s\n", (const char*)buf);
+        }
+        else {
+            printf("    at <unknown>\n");
+        }
+        jerry_value_free(frame);
+    }
+    jerry_value_free(frames);
+}
+
+/**
+ * @brief 创建用于中断脚本的 abort 值，try / catch 无法捕获
+ */
+static jerry_value_t appsys_watchdog_abort(void) {
+    return jerry_throw_abort(jerry_string_sz("watchdog: script exceeded its execution budget"), true);
+}
+
+/**
+ * @brief 检查是否超时，首次超时时打印报告并请求终止应用
+ * @return bool 本次运行已超时
+ */
+static bool appsys_watchdog_check(void) {
+    if (run_depth == 0) {
+        return false;
+    }
+    if (run_expired) {
+        return true;
+    }
+    jerry_value_t realm = jerry_current_realm();
+    uint32_t budget_ms = appsys_get_exec_budget(realm);
+    uint32_t elapsed_ms = (uint32_t)((appsys_port_get_time_us() - run_start_us) / 1000);
+    if (elapsed_ms >= budget_ms) {
+        run_expired = true;
+        printf("[watchdog] script ran %u ms without returning (budget %u ms), terminating app\n",
+            elapsed_ms, budget_ms);
+        appsys_watchdog_print_backtrace();
+        appsys_request_terminate(realm, APP_ERR_WATCHDOG_TIMEOUT);
+    }
+    jerry_value_free(realm);
+    return run_expired;
+}
+
+/**
+ * @brief VM 检查点回调
+ * @return jerry_value_t undefined 继续执行，否则作为异常抛出
+ */
+static jerry_value_t appsys_watchdog_halt_cb(void* user_p) {
+    (void)user_p;
+    return appsys_watchdog_check() ? appsys_watchdog_abort() : jerry_undefined();
+}
+
+/**
+ * @brief 随 VM 初始化安装检查点回调
+ */
+void appsys_watchdog_init(void) {
+    run_depth = 0;
+    run_expired = false;
+    jerry_halt_handler(APPSYS_WATCHDOG_CHECK_INTERVAL, appsys_watchdog_halt_cb, NULL);
+}
+
+/**
+ * @brief 随 VM 销毁移除回调
+ */
+void appsys_watchdog_deinit(void) {
+    jerry_halt_handler(0, NULL, NULL);
+    run_depth = 0;
+    run_expired = false;
+}
+
+/**
+ * @brief 原生代码进入 JS 前调用
+ * @return bool 本次运行已超时、不应再进入 JS 时返回 false（此时不要调用 end）
+ */
+bool appsys_watchdog_begin(void) {
+    if (run_depth > 0 && run_expired) {
+        return false;
+    }
+    if (run_depth++ == 0) {
+        run_start_us = appsys_port_get_time_us();
+        run_expired = false;
+    }
+    return true;
+}
+
+/**
+ * @brief 从 JS 返回后调用
+ * @return bool 最外层调用结束且本次运行因超时被中断
+ */
+bool appsys_watchdog_end(void) {
+    if (run_depth == 0 || --run_depth > 0) {
+        return false;
+    }
+    bool expired = run_expired;
+    run_expired = false;
+    return expired;
+}
+
+/**
+ * @brief 供阻塞型原生函数（如 delay）返回前调用，检查点回调无法打断原生代码
+ * @return jerry_value_t 已超时返回 abort，否则返回 undefined
+ */
+jerry_value_t appsys_watchdog_poll(void) {
+    return appsys_watchdog_check() ? appsys_watchdog_abort() : jerry_undefined();
+}
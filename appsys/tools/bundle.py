@@ -0,0 +1,700 @@
+"""
+@file bundle.py
+@brief 应用脚本打包：摇树、去注释、缩短局部变量名，输出紧凑的 bundle（可选再生成快照）
+@author Sab1e
+@date 2025-08-16
+
+处理步骤（均在词法层面完成，见 jstoken.py）：
+  1. 摇树：顶层 function 声明只有从顶层代码（或 --keep 指定的入口）可达时才保留。
+     系统按名字调用的生命周期函数（on_suspend / on_resume）总是保留。
+  2. 缩短局部名：顶层函数内部声明的参数与变量改为短名。每处引用按所在的函数（含方法、箭头函数）
+     逐层向外查找声明，没有找到声明的引用视为全局名。函数内出现 eval / with、
+     或模板字符串中有 ${...} 时该函数不做改名。全局名、绑定（lv_* / LV_*）、内置对象与原生函数
+     （从 appsys/src 的 AppSysFuncEntry 表与 stdlib.js 生成，见 load_runtime_globals）从不改名。
+  3. 去掉注释并压缩空白。含换行的空白保留一个换行，不依赖自动分号插入的写法也能安全压缩。
+  4. 可选：--lazy 把顶层函数改为首次调用时才编译（见下文）。
+  5. 可选：--lvgl-json 内联 LVGL 枚举常量，--jerry-snapshot 再把 bundle 编译为快照。
+
+延迟编译：顶层函数的源码存入字符串表 __lazy_fns，原位置换成转发桩，首次调用时由 bundle 内的
+__lazy 用直接 eval 编译。直接 eval 位于脚本顶层作用域，编译出的函数与原函数声明看到的名字相同
+（包括 jerry_eval 下只在脚本内可见的顶层 let / const）。加载时只需扫描字符串，启动耗时只与启动
+路径上的代码有关。
+转发桩与编译出的函数不是同一个对象，以下函数保持原样：async / 生成器函数、小于 --lazy-min-size
+的函数，以及函数体内引用自身名字、被 new 或 instanceof 使用、或以 name.x / name[...] 访问属性
+（如 helper.calls++、name.prototype、name.length）的函数。只作为值传递后再读取属性的情况
+无法在词法层面发现，这类函数用 --keep-eager 排除。
+以 APPSYS_LAZY_PROFILE 编译时，运行时把启动阶段编译过的函数写入 profile/<app_id>.txt
+（见 appsys_lazy.c），下次打包时用 --profile 传入：这些函数立即编译，并排在 bundle 最前面。
+
+用法:
+    python bundle.py main.js -o main.bundle.js [--keep NAME ...] [--lvgl-json FILE]
+                     [--lazy [--profile FILE] [--keep-eager NAME ...] [--lazy-min-size N]]
+                     [--jerry-snapshot PATH --snapshot-out FILE] [--no-rename] [--no-shake]
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+import jstoken
+import inline_consts
+
+KEYWORDS = {
+    "break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete", "do",
+    "else", "export", "extends", "finally", "for", "function", "if", "import", "in", "instanceof",
+    "new", "return", "super", "switch", "this", "throw", "try", "typeof", "var", "void", "while",
+    "with", "yield", "let", "static", "enum", "await", "implements", "package", "protected",
+    "interface", "private", "public", "null", "true", "false", "async", "of", "get", "set",
+    "arguments", "eval", "undefined", "NaN", "Infinity",
+}
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+NATIVE_SRC_DIR = os.path.join(ROOT, "appsys", "src")
+STDLIB_PATH = os.path.join(ROOT, "appsys", "js", "stdlib.js")
+
+# JS 内置对象与 appsys 在每个 realm 中定义的全局名
+JS_GLOBALS = {
+    "Object", "Function", "Array", "String", "Number", "Boolean", "Symbol", "Math", "JSON", "Date",
+    "RegExp", "Error", "TypeError", "RangeError", "SyntaxError", "ReferenceError", "Promise", "Map",
+    "Set", "WeakMap", "WeakSet", "Proxy", "Reflect", "ArrayBuffer", "DataView", "Int8Array",
+    "Uint8Array", "Uint8ClampedArray", "Int16Array", "Uint16Array", "Int32Array", "Uint32Array",
+    "Float32Array", "Float64Array", "BigInt", "parseInt", "parseFloat", "isNaN", "isFinite",
+    "globalThis", "app_info",
+}
+
+_NATIVE_ENTRY = re.compile(r'\{\s*\.name\s*=\s*"([A-Za-z_$][\w$]*)"')
+
+
+def load_runtime_globals(src_dir=NATIVE_SRC_DIR, stdlib_path=STDLIB_PATH):
+    """运行时提供的全局名：JS 内置对象、appsys/src 中各 AppSysFuncEntry 表注册的原生函数，
+    以及系统 JS 库顶层声明的名字。从源码生成，新增原生函数时不需要同步修改这里"""
+    names = set(JS_GLOBALS)
+    if os.path.isdir(src_dir):
+        for entry in sorted(os.listdir(src_dir)):
+            if entry.endswith(".c"):
+                with open(os.path.join(src_dir, entry), "r", encoding="utf-8-sig", errors="replace") as f:
+                    names.update(_NATIVE_ENTRY.findall(f.read()))
+    if os.path.isfile(stdlib_path):
+        with open(stdlib_path, "r", encoding="utf-8-sig") as f:
+            names |= global_declarations(Script(f.read()))
+    return names
+
+# 系统按名字调用的应用函数
+SYSTEM_HOOKS = {"on_suspend", "on_resume"}
+
+DECL_KEYWORDS = {"var", "let", "const"}
+
+# 延迟函数表与编译函数。编译函数的参数也会出现在被编译函数的作用域链上，只能用 __ 开头的保留名
+LAZY_TABLE = "__lazy_fns"
+LAZY_COMPILE = "__lazy"
+LAZY_MIN_SIZE = 160
+LAZY_COMPILER = ('function %s(__i,__n){var __f=%s[__i];if(typeof __f==="string"){'
+                 '__f=%s[__i]=eval("("+__f+")");appsys_lazy_mark(__n);}return __f;}\n'
+                 % (LAZY_COMPILE, LAZY_TABLE, LAZY_TABLE))
+
+_IDENT = re.compile(r"[A-Za-z_$][\w$]*")
+
+
+def is_external(name):
+    return name in RUNTIME_GLOBALS or name.startswith(("lv_", "LV_", "__"))
+
+
+class Script:
+    """记号列表与常用的邻接信息"""
+
+    def __init__(self, src):
+        self.tokens = jstoken.tokenize(src)
+        self.refresh()
+
+    def refresh(self):
+        self.prev_idx, self.next_idx = jstoken.significant_neighbors(self.tokens)
+        self.match = {}
+        self.opener = {}
+        stack = []
+        for i, tok in enumerate(self.tokens):
+            if tok.kind != "punct":
+                continue
+            if tok.text in ("{", "(", "["):
+                stack.append(i)
+            elif tok.text in ("}", ")", "]"):
+                if not stack:
+                    raise jstoken.TokenizeError("unbalanced %r" % tok.text)
+                j = stack.pop()
+                self.match[j] = i
+                self.opener[i] = j
+
+    def text(self, i):
+        return self.tokens[i].text if i >= 0 else ""
+
+    def is_property(self, i):
+        return self.text(self.prev_idx[i]) in (".", "?.")
+
+
+def find_top_level_functions(script):
+    """找出顶层 function 声明，返回 [(名字, 起始下标, 结束下标)]，结束下标指向函数体的 }"""
+    funcs = []
+    depth = 0
+    i = 0
+    toks = script.tokens
+    while i < len(toks):
+        tok = toks[i]
+        if tok.kind == "punct" and tok.text in ("{", "(", "["):
+            depth += 1
+        elif tok.kind == "punct" and tok.text in ("}", ")", "]"):
+            depth -= 1
+        elif depth == 0 and tok.kind == "name" and tok.text == "function":
+            prev = script.text(script.prev_idx[i])
+            # 只处理声明语句，不处理顶层的函数表达式
+            if prev in ("", ";", "}", ")") or prev == "async":
+                start = script.prev_idx[i] if prev == "async" else i
+                j = script.next_idx[i]
+                if script.text(j) == "*":
+                    j = script.next_idx[j]
+                if j >= 0 and toks[j].kind == "name":
+                    name = toks[j].text
+                    paren = script.next_idx[j]
+                    body = script.next_idx[script.match[paren]]
+                    end = script.match[body]
+                    funcs.append((name, start, end))
+                    i = end + 1
+                    continue
+        i += 1
+    return funcs
+
+
+def referenced_names(script, start, end):
+    names = set()
+    for i in range(start, end + 1):
+        tok = script.tokens[i]
+        if tok.kind == "name" and not script.is_property(i):
+            names.add(tok.text)
+        elif tok.kind == "template" and "${" in tok.text:
+            # 模板中的代码没有单独切分，保守地把其中所有像标识符的词都算作引用
+            names.update(_IDENT.findall(tok.text))
+    return names
+
+
+def tree_shake(script, keep):
+    """删除不可达的顶层函数，返回被删除的函数名"""
+    funcs = find_top_level_functions(script)
+    if not funcs:
+        return []
+    in_func = set()
+    for _, start, end in funcs:
+        in_func.update(range(start, end + 1))
+    roots = set(keep) | SYSTEM_HOOKS
+    outside = [i for i in range(len(script.tokens)) if i not in in_func]
+    for i in outside:
+        tok = script.tokens[i]
+        if tok.kind in ("name", "template"):
+            roots |= referenced_names(script, i, i)
+
+    by_name = {name: (start, end) for name, start, end in funcs}
+    live = set()
+    work = [n for n in roots if n in by_name]
+    while work:
+        name = work.pop()
+        if name in live:
+            continue
+        live.add(name)
+        start, end = by_name[name]
+        work.extend(n for n in referenced_names(script, start, end) if n in by_name and n not in live)
+
+    removed = []
+    for name, start, end in reversed(funcs):
+        if name in live:
+            continue
+        removed.append(name)
+        del script.tokens[start:end + 1]
+    script.refresh()
+    return list(reversed(removed))
+
+
+def short_names(avoid):
+    """按 a, b, ..., z, A, ..., Z, aa, ab ... 生成不冲突的短名"""
+    first = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_$"
+    rest = first + "0123456789"
+    n = 0
+    while True:
+        k = n
+        name = first[k % len(first)]
+        k //= len(first)
+        while k > 0:
+            k -= 1
+            name += rest[k % len(rest)]
+            k //= len(rest)
+        n += 1
+        if name not in avoid and name not in KEYWORDS:
+            yield name
+
+
+class _Scope:
+    """函数作用域：记号区间 [start, end]、外层作用域与其中声明的名字"""
+
+    __slots__ = ("start", "end", "parent", "names")
+
+    def __init__(self, start, end):
+        self.start = start
+        self.end = end
+        self.parent = None
+        self.names = set()
+
+    def declares(self, name):
+        scope = self
+        while scope is not None:
+            if name in scope.names:
+                return True
+            scope = scope.parent
+        return False
+
+
+def _collect_pattern(script, a, b, names):
+    """参数列表或解构模式：取出不在 : 之前、不在默认值表达式中的名字"""
+    toks = script.tokens
+    expect_name = True
+    for i in range(a, b):
+        tok = toks[i]
+        if tok.kind in ("ws", "comment"):
+            continue
+        if tok.kind == "punct":
+            if tok.text in ("{", "[", "(", ",", "...", ":"):
+                expect_name = True
+            elif tok.text == "=":
+                expect_name = False
+            continue
+        if tok.kind == "name" and expect_name:
+            if script.text(script.next_idx[i]) != ":":
+                names.add(tok.text)
+            expect_name = False
+
+
+def _arrow_body_end(script, i, end):
+    """箭头函数 => 之后函数体的最后一个记号：{...} 或到 , ; 或外层右括号为止的表达式"""
+    j = script.next_idx[i]
+    if script.text(j) == "{":
+        return script.match[j]
+    last = j
+    while 0 <= j <= end:
+        text = script.text(j)
+        if script.tokens[j].kind == "punct":
+            if text in ("(", "[", "{"):
+                last = j = script.match[j]
+                j = script.next_idx[j]
+                continue
+            if text in (")", "]", "}", ",", ";"):
+                break
+        last = j
+        j = script.next_idx[j]
+    return last
+
+
+def function_scopes(script, start, end):
+    """把顶层函数 [start, end] 切分为函数作用域（function、方法、箭头函数），并把每个声明归到所在的作用域。
+    返回 (每个记号所在的最内层作用域 {下标: _Scope}, 方法名记号的下标)。
+    let / const / catch 参数按所在函数而不是所在块处理，对改名来说只会更保守"""
+    toks = script.tokens
+    outer = _Scope(start, end)
+    scopes = []
+    decls = []          # (决定作用域的记号下标或 _Scope, 名字)
+    methods = set()
+    braces = []         # 当前所在的 { 是否为语句块
+
+    for i in range(start, end + 1):
+        tok = toks[i]
+        if tok.kind == "punct":
+            if tok.text == "{":
+                braces.append(jstoken.brace_opens_block(script.text(script.prev_idx[i])))
+            elif tok.text == "}" and braces:
+                braces.pop()
+            elif tok.text == "=>":
+                p = script.prev_idx[i]
+                scope = _Scope(p if toks[p].kind == "name" else script.opener.get(p, p),
+                               _arrow_body_end(script, i, end))
+                if toks[p].kind == "name":
+                    scope.names.add(toks[p].text)
+                elif script.text(p) == ")":
+                    _collect_pattern(script, script.opener[p] + 1, p, scope.names)
+                scopes.append(scope)
+            continue
+        if tok.kind != "name" or script.is_property(i):
+            continue
+        nxt = script.next_idx[i]
+        if tok.text == "function":
+            j = nxt
+            if script.text(j) == "*":
+                j = script.next_idx[j]
+            name_idx = j if toks[j].kind == "name" else -1
+            if name_idx >= 0:
+                j = script.next_idx[j]
+            if script.text(j) != "(":
+                continue
+            body = script.next_idx[script.match[j]]
+            if script.text(body) != "{":
+                continue
+            prev = script.prev_idx[i]
+            if script.text(prev) == "async":
+                prev = script.prev_idx[prev]
+            is_decl = i <= script.next_idx[start] or script.text(prev) in ("", ";", "{", "}", ")")
+            # 函数声明的名字属于外层作用域，函数表达式的名字只在自身内部可见
+            scope = _Scope(j if is_decl or name_idx < 0 else name_idx, script.match[body])
+            _collect_pattern(script, j + 1, script.match[j], scope.names)
+            if name_idx >= 0:
+                if is_decl:
+                    decls.append((i, toks[name_idx].text))
+                else:
+                    scope.names.add(toks[name_idx].text)
+            scopes.append(scope)
+        elif tok.text in DECL_KEYWORDS:
+            j = nxt
+            if script.text(j) in ("{", "["):
+                names = set()
+                _collect_pattern(script, j, script.match[j] + 1, names)
+                decls.extend((i, n) for n in names)
+                continue
+            # let a = 1, b = f(x, y), c;
+            depth = 0
+            expect = True
+            while 0 <= j <= end:
+                t = toks[j]
+                if t.kind == "punct":
+                    if t.text in ("(", "[", "{"):
+                        depth += 1
+                    elif t.text in (")", "]", "}"):
+                        if depth == 0:
+                            break
+                        depth -= 1
+                    elif t.text == "," and depth == 0:
+                        expect = True
+                    elif t.text == ";" and depth == 0:
+                        break
+                elif t.kind == "name" and expect and depth == 0:
+                    if t.text in ("in", "of"):
+                        break
+                    decls.append((i, t.text))
+                    expect = False
+                j = script.next_idx[j]
+        elif tok.text == "catch":
+            if script.text(nxt) == "(":
+                names = set()
+                _collect_pattern(script, nxt + 1, script.match[nxt], names)
+                decls.extend((nxt, n) for n in names)
+        elif script.text(nxt) == "(" and braces and not braces[-1] and tok.text not in KEYWORDS:
+            # 对象字面量或 class 中的方法：name(...) { ... }
+            prev = script.text(script.prev_idx[i])
+            body = script.next_idx[script.match[nxt]]
+            if prev in ("{", "}", ",", ";", "*", "get", "set", "static", "async") and script.text(body) == "{":
+                methods.add(i)
+                scope = _Scope(nxt, script.match[body])
+                _collect_pattern(script, nxt + 1, script.match[nxt], scope.names)
+                scopes.append(scope)
+
+    # 按区间嵌套确定外层作用域，并记录每个记号所在的最内层作用域
+    owner = {}
+    stack = [outer]
+    pending = sorted(scopes, key=lambda s: (s.start, -s.end))
+    k = 0
+    for i in range(start, end + 1):
+        while stack[-1] is not outer and i > stack[-1].end:
+            stack.pop()
+        while k < len(pending) and pending[k].start == i:
+            while stack[-1] is not outer and pending[k].start > stack[-1].end:
+                stack.pop()
+            pending[k].parent = stack[-1]
+            stack.append(pending[k])
+            k += 1
+        owner[i] = stack[-1]
+    for where, name in decls:
+        owner[where].names.add(name)
+    return owner, methods
+
+
+def rename_locals(script, global_names):
+    """缩短每个顶层函数内部的局部名，返回改名数量。
+    每处引用按所在函数逐层向外查找声明，只有解析到函数内部声明的引用才改名；
+    未在任何外层函数中声明的同名引用（隐式全局）保持原样"""
+    all_names = {t.text for t in script.tokens if t.kind == "name"}
+    renamed = 0
+    for name, start, end in find_top_level_functions(script):
+        body = script.tokens[start:end + 1]
+        if any(t.kind == "name" and t.text in ("eval", "with") for t in body):
+            continue
+        if any(t.kind == "template" and "${" in t.text for t in body):
+            continue
+        owner, methods = function_scopes(script, start, end)
+        excluded = global_names | KEYWORDS | {name}
+
+        # 解析到函数内部声明的引用
+        refs = []
+        for i in range(start, end + 1):
+            t = script.tokens[i]
+            if t.kind != "name" or script.is_property(i) or i in methods:
+                continue
+            if t.text in excluded or is_external(t.text) or not owner[i].declares(t.text):
+                continue
+            refs.append(i)
+        if not refs:
+            continue
+
+        # 出现次数多的名字优先分配最短的新名
+        counts = {}
+        for i in refs:
+            counts[script.tokens[i].text] = counts.get(script.tokens[i].text, 0) + 1
+        gen = short_names(all_names | global_names)
+        mapping = {}
+        for old in sorted(counts, key=lambda n: (-counts[n], n)):
+            new = next(gen)
+            if len(new) < len(old):
+                mapping[old] = new
+
+        local_refs = set(refs)
+        brackets = []
+        for i in range(start, end + 1):
+            t = script.tokens[i]
+            if t.kind == "punct":
+                if t.text == "{":
+                    block = jstoken.brace_opens_block(script.text(script.prev_idx[i]))
+                    brackets.append("block" if block else "object")
+                elif t.text in ("(", "["):
+                    brackets.append(t.text)
+                elif t.text in ("}", ")", "]") and brackets:
+                    brackets.pop()
+                continue
+            if i not in local_refs or t.text not in mapping:
+                continue
+            prev = script.text(script.prev_idx[i])
+            nxt = script.text(script.next_idx[i])
+            if brackets and brackets[-1] == "object" and prev in ("{", ","):
+                if nxt == ":":
+                    continue  # 对象字面量的键
+                if nxt in (",", "}", "="):
+                    # 简写属性（含解构默认值）展开为 键:新名
+                    t.text = "%s:%s" % (t.text, mapping[t.text])
+                    renamed += 1
+                    continue
+            t.text = mapping[t.text]
+            renamed += 1
+    return renamed
+
+
+def global_declarations(script):
+    """顶层声明的名字（函数与变量）"""
+    names = {name for name, _, _ in find_top_level_functions(script)}
+    depth = 0
+    toks = script.tokens
+    for i, tok in enumerate(toks):
+        if tok.kind == "punct" and tok.text in ("{", "(", "["):
+            depth += 1
+        elif tok.kind == "punct" and tok.text in ("}", ")", "]"):
+            depth -= 1
+        elif depth == 0 and tok.kind == "name" and tok.text in DECL_KEYWORDS:
+            j = script.next_idx[i]
+            if j >= 0 and toks[j].kind == "name":
+                names.add(toks[j].text)
+    return names
+
+
+RUNTIME_GLOBALS = load_runtime_globals()
+
+
+def _needs_space(a, b):
+    """两个记号直接相连是否会改变切分结果"""
+    if not a or not b:
+        return False
+    wordy = lambda c: c.isalnum() or c in "_$" or ord(c) > 0x7F
+    if wordy(a[-1]) and (wordy(b[0]) or b[0] == "\\"):
+        return True
+    if a[-1] in "+-" and b[0] in "+-":
+        return True
+    if a[-1] == "/" and b[0] in "/*":
+        return True
+    if a[-1].isdigit() and b[0] == ".":
+        return True
+    return False
+
+
+def minify(script):
+    """去注释并压缩空白"""
+    out = []
+    pending_newline = False
+    last = ""
+    for tok in script.tokens:
+        if tok.kind == "comment":
+            if "\n" in tok.text:
+                pending_newline = True
+            continue
+        if tok.kind == "ws":
+            if "\n" in tok.text:
+                pending_newline = True
+            continue
+        if pending_newline and last:
+            out.append("\n")
+        elif _needs_space(last, tok.text):
+            out.append(" ")
+        pending_newline = False
+        out.append(tok.text)
+        last = tok.text
+    return "".join(out) + "\n"
+
+
+def read_profile(path):
+    """读取启动剖析：每行一个函数名，按首次编译的先后排列"""
+    with open(path, "r", encoding="utf-8-sig") as f:
+        names = [line.strip() for line in f]
+    return [n for n in names if n]
+
+
+def _directive_end(script):
+    """开头的 "use strict" 等指令序言之后的位置（新代码不能插在指令之前）"""
+    toks = script.tokens
+    i = script.next_idx[0] if toks and toks[0].kind in ("ws", "comment") else (0 if toks else -1)
+    end = 0
+    while i >= 0 and toks[i].kind == "string":
+        j = script.next_idx[i]
+        if script.text(j) == ";":
+            end = j + 1
+            i = script.next_idx[j]
+        else:
+            end = i + 1
+            i = j
+    return end
+
+
+def _refers_to_self(script, name, start, end):
+    """函数体内是否引用了自身的名字（递归调用之外还可能读写自身属性或比较身份，一律保守处理）"""
+    body = script.next_idx[script.match[script.next_idx[_name_index(script, start)]]]
+    return name in referenced_names(script, body, end)
+
+
+def _name_index(script, start):
+    """函数声明中函数名记号的下标"""
+    i = start
+    if script.text(i) == "async":
+        i = script.next_idx[i]
+    i = script.next_idx[i]
+    if script.text(i) == "*":
+        i = script.next_idx[i]
+    return i
+
+
+def lazify(src, profile=(), eager=(), min_size=LAZY_MIN_SIZE):
+    """把顶层函数改为延迟编译，返回 (新源码, 延迟函数名, 移到最前的函数名)。剖析中的函数立即编译并移到最前面"""
+    script = Script(src)
+    toks = script.tokens
+    # 必须保持函数对象身份的名字：new name、x instanceof name、name.x、name[...]
+    identity = set()
+    for i, t in enumerate(toks):
+        if t.kind != "name":
+            continue
+        j = script.next_idx[i]
+        if t.text in ("new", "instanceof") and j >= 0 and toks[j].kind == "name":
+            identity.add(toks[j].text)
+        elif script.text(j) in (".", "?.", "[") and not script.is_property(i):
+            identity.add(t.text)
+    order = {name: i for i, name in enumerate(profile)}
+
+    table = []
+    lazy = []
+    first = []
+    out = []
+    pos = _directive_end(script)
+    prologue = jstoken.join(toks[:pos])
+    for name, start, end in find_top_level_functions(script):
+        text = jstoken.join(toks[start:end + 1])
+        out.append(jstoken.join(toks[pos:start]))
+        pos = end + 1
+        if name in order:
+            # 函数声明会提升，移动位置不改变语义
+            first.append((order[name], name, text))
+            continue
+        special = toks[start].text == "async" or script.text(script.next_idx[start]) == "*"
+        if special or name in identity or name in eager or len(text) < min_size \
+                or _refers_to_self(script, name, start, end):
+            out.append(text)
+            continue
+        out.append('function %s(){return %s(%d,"%s").apply(this,arguments)}'
+                   % (name, LAZY_COMPILE, len(table), name))
+        table.append(text)
+        lazy.append(name)
+    out.append(jstoken.join(toks[pos:]))
+
+    head = [prologue]
+    if prologue and not prologue.endswith("\n"):
+        head.append("\n")
+    if table:
+        head.append("var %s=[%s];\n" % (LAZY_TABLE, ",".join(json.dumps(t, ensure_ascii=False) for t in table)))
+        head.append(LAZY_COMPILER)
+    first.sort()
+    head.extend(text + "\n" for _, _, text in first)
+    return "".join(head) + "".join(out), lazy, [name for _, name, _ in first]
+
+
+def bundle(src, keep=(), rename=True, shake=True, constants=None, lazy=False, profile=(), eager=(),
+           lazy_min_size=LAZY_MIN_SIZE):
+    """返回 (bundle 源码, 统计信息)"""
+    stats = {"removed": [], "renamed": 0, "inlined": 0, "lazy": [], "first": []}
+    if constants:
+        src, stats["inlined"] = inline_consts.inline_constants(src, constants)
+    script = Script(src)
+    if shake:
+        stats["removed"] = tree_shake(script, keep)
+    if rename:
+        stats["renamed"] = rename_locals(script, global_declarations(script))
+        script.refresh()
+    out = minify(script)
+    if lazy:
+        out, stats["lazy"], stats["first"] = lazify(out, profile, eager, lazy_min_size)
+    return out, stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--keep", action="append", default=[], help="额外保留的顶层函数（按名字从外部调用）")
+    parser.add_argument("--no-shake", action="store_true", help="不删除不可达函数")
+    parser.add_argument("--no-rename", action="store_true", help="不缩短局部名")
+    parser.add_argument("--lvgl-json", help="LVGL gen_json 生成的 lvgl.json，指定时内联 LVGL 枚举常量")
+    parser.add_argument("--lazy", action="store_true", help="顶层函数首次调用时才编译")
+    parser.add_argument("--profile", help="运行时生成的启动剖析（profile/<app_id>.txt），其中的函数立即编译并排在最前")
+    parser.add_argument("--keep-eager", action="append", default=[], help="不做延迟编译的顶层函数")
+    parser.add_argument("--lazy-min-size", type=int, default=LAZY_MIN_SIZE, help="小于该大小 [byte] 的函数不做延迟编译")
+    parser.add_argument("--jerry-snapshot", help="jerry-snapshot 可执行文件路径")
+    parser.add_argument("--snapshot-out", help="快照输出路径，需同时指定 --jerry-snapshot")
+    args = parser.parse_args()
+
+    with open(args.input, "r", encoding="utf-8-sig") as f:
+        src = f.read()
+    constants = inline_consts.load_lvgl_constants(args.lvgl_json) if args.lvgl_json else None
+    if args.profile and not args.lazy:
+        parser.error("--profile requires --lazy")
+    profile = read_profile(args.profile) if args.profile else ()
+    out, stats = bundle(src, args.keep, not args.no_rename, not args.no_shake, constants,
+                        args.lazy, profile, args.keep_eager, args.lazy_min_size)
+
+    with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(out)
+
+    in_size = len(src.encode("utf-8"))
+    out_size = len(out.encode("utf-8"))
+    print("bundle: %s -> %s: %d B -> %d B (%.0f%%)" % (
+        args.input, args.output, in_size, out_size, 100.0 * out_size / max(in_size, 1)))
+    if stats["removed"]:
+        print("bundle: removed unreachable functions: %s" % ", ".join(stats["removed"]))
+    print("bundle: %d local references renamed, %d constants inlined" % (stats["renamed"], stats["inlined"]))
+    if args.lazy:
+        print("bundle: %d functions compiled lazily, %d startup functions placed first"
+              % (len(stats["lazy"]), len(stats["first"])))
+
+    if args.snapshot_out:
+        if not args.jerry_snapshot:
+            parser.error("--snapshot-out requires --jerry-snapshot")
+        subprocess.run([args.jerry_snapshot, "generate", "-o", args.snapshot_out, args.output], check=True)
+        print("bundle: snapshot %s (%d B)" % (args.snapshot_out, os.path.getsize(args.snapshot_out)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
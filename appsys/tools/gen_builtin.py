@@ -0,0 +1,233 @@
+"""
+@file gen_builtin.py
+@brief 把 appsys/builtin 下的系统应用编译为 JerryScript 静态快照，生成 appsys/src/appsys_builtin_data.c
+@author Sab1e
+@date 2025-08-14
+
+每个内置应用是 appsys/builtin/<目录>/ 下的 app.json（应用信息）与 main.js，以及可选的 <名字>.ui.json
+界面描述：后者由 ui_compile.py 编译后放进应用包的 ui 表，脚本中以 ui_load("<名字>", parent) 加载。
+静态快照要求脚本中的全部字符串字面量都是 magic string，因此先用 jerry-snapshot litdump
+收集所有内置应用与系统 JS 库（appsys/js/stdlib.js）的字面量，生成统一的 magic string 表（引擎只能注册一张），
+再逐个以 --static 编译。运行时注册该表后，快照直接在只读数据段中执行，字节码与字面量都不占用 RAM。
+--literals-out 把该表保存下来，供 gen_stdlib.py --literals 以同一张表编译系统 JS 库的静态快照。
+
+快照格式与 JerryScript 的版本和编译选项绑定，必须使用与模拟器链接的同一份 JerryScript 构建出的
+jerry-snapshot（build.py --jerry-cmdline-snapshot=ON）。不指定 --jerry-snapshot 时生成空的内置应用表。
+指定 --lvgl-json 时先对脚本做常量内联（见 inline_consts.py）。
+
+用法:
+    python gen_builtin.py [--jerry-snapshot PATH] [--lvgl-json FILE] [--builtin-dir DIR] [--output FILE]
+                          [--stdlib FILE] [--literals-out FILE]
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import inline_consts
+import ui_compile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+DEFAULT_BUILTIN_DIR = os.path.join(ROOT, "appsys", "builtin")
+DEFAULT_OUTPUT = os.path.join(ROOT, "appsys", "src", "appsys_builtin_data.c")
+DEFAULT_STDLIB = os.path.join(ROOT, "appsys", "js", "stdlib.js")
+
+INFO_FIELDS = ("app_id", "name", "version", "author", "description")
+
+HEADER = """\
+/**
+ * @file appsys_builtin_data.c
+ * @brief 内置应用静态快照，由 appsys/tools/gen_builtin.py 从 appsys/builtin 生成，请勿手动修改
+ */
+
+#include "appsys_builtin.h"
+
+"""
+
+
+def c_bytes(data):
+    """把字节串转换为 C 字符串字面量，非 ASCII 字节按八进制转义"""
+    out = []
+    for b in data:
+        c = chr(b)
+        if c == "\\" or c == "\"":
+            out.append("\\" + c)
+        elif b < 0x20 or b >= 0x7F or c == "?":
+            out.append("\\%03o" % b)
+        else:
+            out.append(c)
+    return "\"%s\"" % "".join(out)
+
+
+def c_words(data):
+    """把快照转换为 uint32_t 数组内容（快照要求 4 字节对齐）"""
+    data += b"\0" * (-len(data) % 4)
+    words = [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data), 4)]
+    rows = []
+    for i in range(0, len(words), 8):
+        rows.append("    " + ", ".join("0x%08X" % w for w in words[i:i + 8]) + ",")
+    return "\n".join(rows)
+
+
+def c_u8(data):
+    """把界面数据转换为 uint8_t 数组内容"""
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def load_apps(builtin_dir):
+    """读取全部内置应用，按目录名排序"""
+    apps = []
+    if not os.path.isdir(builtin_dir):
+        return apps
+    for name in sorted(os.listdir(builtin_dir)):
+        app_dir = os.path.join(builtin_dir, name)
+        info_path = os.path.join(app_dir, "app.json")
+        main_path = os.path.join(app_dir, "main.js")
+        if not (os.path.isfile(info_path) and os.path.isfile(main_path)):
+            continue
+        with open(info_path, "r", encoding="utf-8-sig") as f:
+            info = json.load(f)
+        missing = [k for k in INFO_FIELDS if k not in info]
+        if missing:
+            raise SystemExit("gen_builtin: %s is missing %s" % (info_path, ", ".join(missing)))
+        uis = sorted(f[:-len(".ui.json")] for f in os.listdir(app_dir) if f.endswith(".ui.json"))
+        apps.append({"dir": name, "info": info, "main": main_path,
+                     "ui": [(ui, os.path.join(app_dir, ui + ".ui.json")) for ui in uis]})
+    return apps
+
+
+def parse_literal_list(data):
+    """解析 litdump 的 list 格式：每项为 “长度 空格 内容 换行”"""
+    literals = []
+    pos = 0
+    while pos < len(data):
+        space = data.index(b" ", pos)
+        size = int(data[pos:space])
+        literals.append(data[space + 1:space + 1 + size])
+        pos = space + 1 + size + 1
+    return literals
+
+
+def run(cmd):
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--jerry-snapshot", help="jerry-snapshot 可执行文件路径，不指定时生成空表")
+    parser.add_argument("--lvgl-json", help="LVGL gen_json 生成的 lvgl.json，指定时内联 LVGL 枚举常量")
+    parser.add_argument("--builtin-dir", default=DEFAULT_BUILTIN_DIR)
+    parser.add_argument("--output", default=DEFAULT_OUTPUT)
+    parser.add_argument("--stdlib", default=DEFAULT_STDLIB, help="系统 JS 库，其字面量同样放进 magic string 表")
+    parser.add_argument("--literals-out", help="保存 magic string 表（litdump list 格式），供 gen_stdlib.py --literals 使用")
+    args = parser.parse_args()
+
+    apps = load_apps(args.builtin_dir) if args.jerry_snapshot else []
+    literals = []
+    constants = inline_consts.load_lvgl_constants(args.lvgl_json) if apps and args.lvgl_json else None
+    for app in apps:
+        compiled = []
+        for name, path in app["ui"]:
+            with open(path, "r", encoding="utf-8-sig") as f:
+                doc = json.load(f)
+            try:
+                data, nodes = ui_compile.compile_ui(doc, constants)
+            except ui_compile.UiError as e:
+                raise SystemExit("gen_builtin: %s: %s" % (path, e))
+            compiled.append((name, data))
+            print("gen_builtin: %s: ui %s (%d widgets, %d B)" % (app["info"]["app_id"], name, nodes, len(data)))
+        app["ui"] = compiled
+    with tempfile.TemporaryDirectory() as tmp:
+        if constants is not None:
+            for app in apps:
+                with open(app["main"], "r", encoding="utf-8-sig") as f:
+                    src, count = inline_consts.inline_constants(f.read(), constants)
+                app["main"] = os.path.join(tmp, app["dir"] + ".js")
+                with open(app["main"], "w", encoding="utf-8", newline="") as f:
+                    f.write(src)
+                print("gen_builtin: %s: %d constants inlined" % (app["info"]["app_id"], count))
+        if args.jerry_snapshot:
+            # 所有内置应用与系统 JS 库共用一张 magic string 表（运行时只能注册一张）
+            list_path = os.path.join(tmp, "literals.list")
+            run([args.jerry_snapshot, "litdump", "--format", "list", "-o", list_path]
+                + [app["main"] for app in apps] + [args.stdlib])
+            with open(list_path, "rb") as f:
+                literals = parse_literal_list(f.read())
+            if args.literals_out:
+                shutil.copyfile(list_path, args.literals_out)
+            for app in apps:
+                out_path = os.path.join(tmp, app["dir"] + ".snapshot")
+                run([args.jerry_snapshot, "generate", "--static",
+                     "--load-literals-list-format", list_path, "-o", out_path, app["main"]])
+                with open(out_path, "rb") as f:
+                    app["snapshot"] = f.read()
+
+    # 静态快照按下标引用 magic string，运行时必须按 generate 加载时的顺序注册同一张表，不能重新排序；
+    # litdump 已按引擎的要求（先按 CESU-8 字节长度、再按字节内容）排好序，这里只做检查
+    for prev, cur in zip(literals, literals[1:]):
+        if (len(prev), prev) >= (len(cur), cur):
+            raise SystemExit("gen_builtin: litdump output is not in magic string order near %r" % cur)
+
+    out = [HEADER]
+    out.append("/********************************** magic string **********************************/\n\n")
+    if literals:
+        out.append("const jerry_char_t* const appsys_builtin_magic_strings[] = {\n")
+        out.extend("    (const jerry_char_t*)%s,\n" % c_bytes(s) for s in literals)
+        out.append("};\n\nconst jerry_length_t appsys_builtin_magic_string_lengths[] = {\n")
+        out.extend("    %d,\n" % len(s) for s in literals)
+        out.append("};\n\n")
+    else:
+        out.append("const jerry_char_t* const appsys_builtin_magic_strings[] = { NULL };\n")
+        out.append("const jerry_length_t appsys_builtin_magic_string_lengths[] = { 0 };\n")
+    out.append("const uint32_t appsys_builtin_magic_string_count = %d;\n\n" % len(literals))
+
+    out.append("/********************************** 静态快照 **********************************/\n\n")
+    for i, app in enumerate(apps):
+        out.append("// %s\n" % app["info"]["app_id"])
+        out.append("static const uint32_t builtin_snapshot_%d[] = {\n%s\n};\n\n" % (i, c_words(app["snapshot"])))
+
+    out.append("/********************************** 界面描述 **********************************/\n\n")
+    for i, app in enumerate(apps):
+        if not app["ui"]:
+            continue
+        for j, (name, data) in enumerate(app["ui"]):
+            out.append("static const uint8_t builtin_ui_%d_%d[] = {\n%s\n};\n\n" % (i, j, c_u8(data)))
+        out.append("static const AppSysUiBlob_t builtin_ui_%d[] = {\n" % i)
+        for j, (name, data) in enumerate(app["ui"]):
+            out.append("    { %s, builtin_ui_%d_%d, %d },\n" % (c_bytes(name.encode("utf-8")), i, j, len(data)))
+        out.append("};\n\n")
+
+    out.append("/********************************** 内置应用表 **********************************/\n\n")
+    out.append("const ApplicationPackage_t appsys_builtin_apps[] = {\n")
+    for i, app in enumerate(apps):
+        out.append("    {\n")
+        for key in INFO_FIELDS:
+            out.append("        .%s = %s,\n" % (key, c_bytes(str(app["info"][key]).encode("utf-8"))))
+        out.append("        .snapshot = builtin_snapshot_%d,\n" % i)
+        out.append("        .snapshot_size = %d,\n" % len(app["snapshot"]))
+        if app["ui"]:
+            out.append("        .ui = builtin_ui_%d,\n" % i)
+            out.append("        .ui_count = %d,\n" % len(app["ui"]))
+        out.append("    },\n")
+    if not apps:
+        out.append("    { 0 },\n")
+    out.append("};\n")
+    out.append("const uint32_t appsys_builtin_app_count = %d;\n" % len(apps))
+
+    with open(args.output, "w", encoding="utf-8-sig", newline="\n") as f:
+        f.write("".join(out))
+    total = sum(len(app["snapshot"]) for app in apps)
+    print("gen_builtin: %s (%d apps, %d B snapshots, %d magic strings)"
+          % (args.output, len(apps), total, len(literals)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
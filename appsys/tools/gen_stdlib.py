@@ -0,0 +1,114 @@
+"""
+@file gen_stdlib.py
+@brief 把 appsys/js/stdlib.js 转换为 appsys/src/appsys_stdlib_data.c
+@author Sab1e
+@date 2025-08-13
+
+生成的 C 文件总是包含脚本源码；指定 --jerry-snapshot 时还会嵌入构建期编译好的快照，
+运行时直接就地执行，省去首次启动时的编译。快照格式与 JerryScript 的版本和编译选项绑定，
+必须使用与模拟器链接的同一份 JerryScript 构建出的 jerry-snapshot（build.py --jerry-cmdline-snapshot=ON）。
+
+同时指定 --literals（gen_builtin.py --literals-out 保存的 magic string 表）时编译为静态快照：
+字面量全部引用运行时注册的同一张 magic string 表，执行时不在堆上创建任何字符串。
+
+用法:
+    python gen_stdlib.py [--jerry-snapshot PATH] [--literals FILE] [--input FILE] [--output FILE]
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+DEFAULT_INPUT = os.path.join(ROOT, "appsys", "js", "stdlib.js")
+DEFAULT_OUTPUT = os.path.join(ROOT, "appsys", "src", "appsys_stdlib_data.c")
+
+HEADER = """\
+/**
+ * @file appsys_stdlib_data.c
+ * @brief 系统 JS 库数据，由 appsys/tools/gen_stdlib.py 从 appsys/js/stdlib.js 生成，请勿手动修改
+ */
+
+#include "appsys_stdlib.h"
+
+"""
+
+
+def compile_snapshot(jerry_snapshot, source_path, literals=None):
+    """调用 jerry-snapshot 编译脚本，返回快照字节；指定 literals 时编译为静态快照"""
+    fd, out_path = tempfile.mkstemp(suffix=".snapshot")
+    os.close(fd)
+    static = ["--static", "--load-literals-list-format", literals] if literals else []
+    try:
+        subprocess.run([jerry_snapshot, "generate"] + static + ["-o", out_path, source_path], check=True)
+        with open(out_path, "rb") as f:
+            return f.read()
+    finally:
+        os.remove(out_path)
+
+
+def c_string(text):
+    """把脚本转换为按行拆分的 C 字符串字面量，非 ASCII 字节按八进制转义，不受编译器执行字符集影响"""
+    lines = []
+    for line in text.replace("\r\n", "\n").splitlines(keepends=True):
+        escaped = []
+        for b in line.encode("utf-8"):
+            c = chr(b)
+            if c == "\\" or c == "\"":
+                escaped.append("\\" + c)
+            elif c == "\n":
+                escaped.append("\\n")
+            elif c == "\t":
+                escaped.append("\\t")
+            elif b < 0x20 or b >= 0x7F or c == "?":
+                escaped.append("\\%03o" % b)
+            else:
+                escaped.append(c)
+        lines.append("    \"%s\"" % "".join(escaped))
+    return "\n".join(lines) if lines else "    \"\""
+
+
+def c_words(data):
+    """把快照转换为 uint32_t 数组内容（快照要求 4 字节对齐）"""
+    data += b"\0" * (-len(data) % 4)
+    words = [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data), 4)]
+    rows = []
+    for i in range(0, len(words), 8):
+        rows.append("    " + ", ".join("0x%08X" % w for w in words[i:i + 8]) + ",")
+    return "\n".join(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--jerry-snapshot", help="jerry-snapshot 可执行文件路径，不指定时只嵌入源码")
+    parser.add_argument("--literals", help="gen_builtin.py 保存的 magic string 表，指定时编译为静态快照")
+    parser.add_argument("--input", default=DEFAULT_INPUT)
+    parser.add_argument("--output", default=DEFAULT_OUTPUT)
+    args = parser.parse_args()
+
+    with open(args.input, "r", encoding="utf-8-sig") as f:
+        source = f.read()
+
+    snapshot = b""
+    if args.jerry_snapshot:
+        snapshot = compile_snapshot(args.jerry_snapshot, args.input, args.literals)
+
+    out = [HEADER]
+    out.append("const char appsys_stdlib_source[] =\n%s;\n\n" % c_string(source))
+    if snapshot:
+        out.append("const uint32_t appsys_stdlib_snapshot[] = {\n%s\n};\n" % c_words(snapshot))
+    else:
+        out.append("// 未指定 --jerry-snapshot，运行时从源码编译快照\n")
+        out.append("const uint32_t appsys_stdlib_snapshot[] = { 0 };\n")
+    out.append("const size_t appsys_stdlib_snapshot_size = %d;\n" % len(snapshot))
+
+    with open(args.output, "w", encoding="utf-8-sig", newline="\n") as f:
+        f.write("".join(out))
+    print("gen_stdlib: %s (%d B source, %d B snapshot)" % (args.output, len(source), len(snapshot)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,277 @@
+"""
+@file inline_consts.py
+@brief 常量内联：把脚本中引用的 LVGL 枚举常量替换为数字字面量
+@author Sab1e
+@date 2025-08-15
+
+LVGL 绑定把 LV_PART_MAIN、LV_ALIGN_TOP_MID 等枚举值作为全局属性导出，脚本每次引用都要在
+全局对象上查找一次。打包时用 lvgl.json（LVGL scripts/gen_json 生成）中的枚举定义把这些引用
+直接替换为数字，运行时变成一次字面量加载。
+
+以下情况保持原样：属性访问（obj.LV_X）、对象字面量的键与简写属性、脚本自己声明或赋值过的名字
+（包括函数、箭头函数、方法与 catch 的参数）。
+运行时这些常量被设为只读（见 APPSYS_FREEZE_LV_CONSTANTS），内联不会改变脚本语义。
+
+用法:
+    python inline_consts.py --lvgl-json lvgl.json input.js [-o output.js] [--annotate]
+"""
+
+import argparse
+import ast
+import json
+import re
+import sys
+
+import jstoken
+
+_CAST = re.compile(r"\(\s*(?:const\s+)?[A-Za-z_]\w*(?:\s*\*)?\s*\)(?=\s*[\w(-])")
+_INT_SUFFIX = re.compile(r"\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b")
+_DECL_KEYWORDS = {"var", "let", "const", "function", "class"}
+# 后面紧跟 (...) { 时不是方法定义的关键字
+_NOT_METHOD = {"if", "for", "while", "switch", "catch", "with", "function", "return", "typeof", "await", "yield"}
+
+
+def _eval_expr(text, known):
+    """计算 C 枚举值表达式，只支持整数、已知名字和常见整数运算，无法计算时返回 None"""
+    text = _INT_SUFFIX.sub(r"\1", _CAST.sub("", text.strip()))
+    try:
+        node = ast.parse(text, mode="eval").body
+    except SyntaxError:
+        return None
+
+    def ev(n):
+        if isinstance(n, ast.Constant) and isinstance(n.value, int):
+            return n.value
+        if isinstance(n, ast.Name):
+            if n.id not in known:
+                raise KeyError(n.id)
+            return known[n.id]
+        if isinstance(n, ast.UnaryOp):
+            v = ev(n.operand)
+            if isinstance(n.op, ast.USub):
+                return -v
+            if isinstance(n.op, ast.UAdd):
+                return v
+            if isinstance(n.op, ast.Invert):
+                return ~v
+        if isinstance(n, ast.BinOp):
+            a, b = ev(n.left), ev(n.right)
+            ops = {
+                ast.Add: lambda: a + b, ast.Sub: lambda: a - b, ast.Mult: lambda: a * b,
+                ast.LShift: lambda: a << b, ast.RShift: lambda: a >> b,
+                ast.BitOr: lambda: a | b, ast.BitAnd: lambda: a & b, ast.BitXor: lambda: a ^ b,
+            }
+            if type(n.op) in ops:
+                return ops[type(n.op)]()
+        raise ValueError(ast.dump(n))
+
+    try:
+        return ev(node)
+    except (KeyError, ValueError):
+        return None
+
+
+def load_lvgl_constants(path):
+    """从 lvgl.json 读取全部枚举成员，返回 {名字: 整数值}"""
+    with open(path, "r", encoding="utf-8") as f:
+        doc = json.load(f)
+
+    known = {}
+    pending = []
+    for enum in doc.get("enums", []):
+        implicit = 0
+        for member in enum.get("members", []):
+            name = member.get("name")
+            if not name:
+                continue
+            value = member.get("value")
+            if value is None or value == "":
+                known[name] = implicit
+                implicit += 1
+                continue
+            if isinstance(value, int):
+                known[name] = value
+                implicit = value + 1
+                continue
+            v = _eval_expr(str(value), known)
+            if v is None:
+                pending.append((name, str(value)))
+            else:
+                known[name] = v
+                implicit = v + 1
+
+    # 引用了后面才定义的成员，反复求值直到没有进展
+    while pending:
+        rest = []
+        for name, value in pending:
+            v = _eval_expr(value, known)
+            if v is None:
+                rest.append((name, value))
+            else:
+                known[name] = v
+        if len(rest) == len(pending):
+            break
+        pending = rest
+    return known
+
+
+def _matching_parens(tokens):
+    """返回 {( 的下标: 对应 ) 的下标}"""
+    pairs = {}
+    stack = []
+    for i, tok in enumerate(tokens):
+        if tok.kind != "punct":
+            continue
+        if tok.text == "(":
+            stack.append(i)
+        elif tok.text == ")" and stack:
+            pairs[stack.pop()] = i
+    return pairs
+
+
+def _is_param_list(tokens, prev_idx, next_idx, open_i, close_i):
+    """判断 (...) 是否为形参列表：function / catch / 箭头函数 / 方法定义"""
+    p = prev_idx[open_i]
+    n = next_idx[close_i]
+    prev = tokens[p] if p >= 0 else None
+    nxt = tokens[n].text if n >= 0 else ""
+    if nxt == "=>":
+        return True
+    if prev is None:
+        return False
+    if prev.kind == "name" and prev.text in ("function", "catch"):
+        return True
+    # function name(...)、function* name(...)、function*(...)
+    pp = prev_idx[p]
+    if pp >= 0 and tokens[pp].text == "function" and (prev.kind == "name" or prev.text == "*"):
+        return True
+    if pp >= 0 and tokens[pp].text == "*" and prev.kind == "name":
+        ppp = prev_idx[pp]
+        if ppp >= 0 and tokens[ppp].text == "function":
+            return True
+    # 对象 / 类中的方法：name(...) {
+    return nxt == "{" and prev.kind == "name" and prev.text not in _NOT_METHOD
+
+
+def _param_names(tokens, prev_idx, next_idx, open_i, close_i):
+    """收集形参列表中绑定的名字（含解构与剩余参数），跳过默认值表达式与解构的键"""
+    names = []
+    depth = 0
+    default_depth = None
+    for i in range(open_i + 1, close_i):
+        tok = tokens[i]
+        if tok.kind == "punct":
+            if tok.text in ("(", "[", "{"):
+                depth += 1
+            elif tok.text in (")", "]", "}"):
+                depth -= 1
+                if default_depth is not None and depth < default_depth:
+                    default_depth = None
+            elif tok.text == "=" and default_depth is None:
+                default_depth = depth
+            elif tok.text == "," and default_depth is not None and depth == default_depth:
+                default_depth = None
+            continue
+        if tok.kind != "name" or default_depth is not None:
+            continue
+        p = prev_idx[i]
+        n = next_idx[i]
+        if p >= 0 and tokens[p].text in (".", "?."):
+            continue
+        if n >= 0 and tokens[n].text == ":":
+            # 解构的键，绑定的是冒号后面的名字
+            continue
+        names.append(tok.text)
+    return names
+
+
+def _script_bindings(tokens, prev_idx, next_idx):
+    """收集脚本自己声明、赋值或用作参数的名字，这些名字不能内联"""
+    names = set()
+    for open_i, close_i in _matching_parens(tokens).items():
+        if _is_param_list(tokens, prev_idx, next_idx, open_i, close_i):
+            names.update(_param_names(tokens, prev_idx, next_idx, open_i, close_i))
+    for i, tok in enumerate(tokens):
+        if tok.kind != "name":
+            continue
+        p = prev_idx[i]
+        if p >= 0 and tokens[p].kind == "name" and tokens[p].text in _DECL_KEYWORDS:
+            names.add(tok.text)
+        n = next_idx[i]
+        if n >= 0 and tokens[n].text == "=>":
+            # 单参数箭头函数 x => ...
+            names.add(tok.text)
+    for i, tok in enumerate(tokens):
+        if tok.kind == "punct" and tok.text.endswith("=") and tok.text not in ("==", "===", "!=", "!==", "<=", ">=", "=>"):
+            p = prev_idx[i]
+            if p >= 0 and tokens[p].kind == "name":
+                names.add(tokens[p].text)
+        if tok.kind == "punct" and tok.text in ("++", "--"):
+            for j in (prev_idx[i], next_idx[i]):
+                if j >= 0 and tokens[j].kind == "name":
+                    names.add(tokens[j].text)
+    return names
+
+
+def inline_constants(src, constants, annotate=False):
+    """替换源码中的常量引用，返回 (新源码, 替换次数)"""
+    tokens = jstoken.tokenize(src)
+    prev_idx, next_idx = jstoken.significant_neighbors(tokens)
+    shadowed = _script_bindings(tokens, prev_idx, next_idx)
+
+    brackets = []
+    count = 0
+    for i, tok in enumerate(tokens):
+        if tok.kind == "punct":
+            if tok.text == "{":
+                prev = tokens[prev_idx[i]].text if prev_idx[i] >= 0 else ""
+                brackets.append("block" if jstoken.brace_opens_block(prev) else "object")
+            elif tok.text in ("(", "["):
+                brackets.append(tok.text)
+            elif tok.text in ("}", ")", "]") and brackets:
+                brackets.pop()
+            continue
+        if tok.kind != "name" or tok.text not in constants or tok.text in shadowed:
+            continue
+        prev = tokens[prev_idx[i]].text if prev_idx[i] >= 0 else ""
+        nxt = tokens[next_idx[i]].text if next_idx[i] >= 0 else ""
+        if prev in (".", "?."):
+            continue
+        if brackets and brackets[-1] == "object" and prev in ("{", ",") and nxt in (":", ",", "}", "(", "="):
+            # 对象字面量的键、简写属性或方法名
+            continue
+        value = constants[tok.text]
+        text = str(value) if value >= 0 else "(%d)" % value
+        if annotate:
+            text += " /*%s*/" % tok.text
+        tok.text = text
+        tok.kind = "number"
+        count += 1
+    return jstoken.join(tokens), count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input")
+    parser.add_argument("-o", "--output", help="输出文件，默认写到标准输出")
+    parser.add_argument("--lvgl-json", required=True, help="LVGL gen_json 生成的 lvgl.json")
+    parser.add_argument("--annotate", action="store_true", help="在数字后保留原常量名注释")
+    args = parser.parse_args()
+
+    constants = load_lvgl_constants(args.lvgl_json)
+    with open(args.input, "r", encoding="utf-8-sig") as f:
+        src = f.read()
+    out, count = inline_constants(src, constants, args.annotate)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8", newline="") as f:
+            f.write(out)
+    else:
+        sys.stdout.write(out)
+    print("inline_consts: %s: %d references inlined (%d constants known)"
+          % (args.input, count, len(constants)), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
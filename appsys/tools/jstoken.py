@@ -0,0 +1,216 @@
+"""
+@file jstoken.py
+@brief 轻量 JavaScript 词法分析器，供打包工具使用
+@author Sab1e
+@date 2025-08-15
+
+只做词法层面的切分，不构建语法树。所有记号的 text 依次拼接后与原文完全一致，
+工具可以只改写其中一部分记号再拼回去。
+
+记号类型:
+    ws       空白（含换行）
+    comment  // 或 /* */ 注释
+    string   '...' 或 "..."
+    template 完整的模板字符串（包括其中的 ${...}）
+    regex    正则表达式字面量
+    number   数字
+    name     标识符或关键字
+    punct    运算符与标点
+"""
+
+import re
+
+KEYWORDS_BEFORE_EXPR = {
+    "return", "typeof", "instanceof", "in", "of", "new", "delete", "void", "throw",
+    "case", "do", "else", "yield", "await",
+}
+
+_WS = re.compile(r"[ \t\r\n\v\f ﻿  ]+")
+_NAME = re.compile(r"[A-Za-z_$\u0080-￿][\w$\u0080-￿]*")
+_NUMBER = re.compile(r"0[xX][0-9a-fA-F_]+n?|0[oO][0-7_]+n?|0[bB][01_]+n?|(?:\d[\d_]*\.?[\d_]*|\.\d[\d_]*)(?:[eE][+-]?\d+)?n?")
+_PUNCT = re.compile(r">>>=|\.\.\.|===|!==|\*\*=|<<=|>>=|>>>|\?\?=|&&=|\|\|=|=>|==|!=|<=|>=|&&|\|\||\?\?|\?\.|\+\+|--|\+=|-=|\*=|/=|%=|&=|\|=|\^=|<<|>>|\*\*|[{}()\[\];,<>+\-*/%&|^!~?:=.@#]")
+
+
+class Token:
+    __slots__ = ("kind", "text")
+
+    def __init__(self, kind, text):
+        self.kind = kind
+        self.text = text
+
+    def __repr__(self):
+        return "Token(%s, %r)" % (self.kind, self.text)
+
+
+class TokenizeError(Exception):
+    pass
+
+
+def _regex_allowed(prev):
+    """根据上一个有效记号判断 / 是正则的开始还是除号"""
+    if prev is None:
+        return True
+    if prev.kind in ("number", "string", "template", "regex"):
+        return False
+    if prev.kind == "name":
+        return prev.text in KEYWORDS_BEFORE_EXPR
+    return prev.text not in (")", "]", "}", "++", "--")
+
+
+def _scan_string(src, pos):
+    quote = src[pos]
+    i = pos + 1
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == quote:
+            return i + 1
+        if c == "\n":
+            break
+        i += 1
+    raise TokenizeError("unterminated string at offset %d" % pos)
+
+
+def _scan_regex(src, pos):
+    i = pos + 1
+    in_class = False
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == "\n":
+            break
+        if in_class:
+            if c == "]":
+                in_class = False
+        elif c == "[":
+            in_class = True
+        elif c == "/":
+            i += 1
+            m = _NAME.match(src, i)
+            return m.end() if m else i
+        i += 1
+    raise TokenizeError("unterminated regex at offset %d" % pos)
+
+
+def _scan_template(src, pos):
+    """扫描模板字符串，${...} 中的代码递归切分以正确跳过其中的字符串和花括号"""
+    i = pos + 1
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == "`":
+            return i + 1
+        if c == "$" and src.startswith("${", i):
+            i = _scan_code(src, i + 2, stop_at_brace=True)
+            continue
+        i += 1
+    raise TokenizeError("unterminated template at offset %d" % pos)
+
+
+def _scan_code(src, pos, stop_at_brace):
+    """跳过一段代码，直到与之匹配的 }（用于模板中的 ${...}），返回 } 之后的位置"""
+    depth = 0
+    tokens = []
+    i = pos
+    while i < len(src):
+        tok, i = _next_token(src, i, _last_significant(tokens))
+        tokens.append(tok)
+        if tok.kind == "punct":
+            if tok.text == "{":
+                depth += 1
+            elif tok.text == "}":
+                if depth == 0 and stop_at_brace:
+                    return i
+                depth -= 1
+    raise TokenizeError("unterminated template substitution at offset %d" % pos)
+
+
+def _last_significant(tokens):
+    for tok in reversed(tokens):
+        if tok.kind not in ("ws", "comment"):
+            return tok
+    return None
+
+
+def _next_token(src, i, prev):
+    c = src[i]
+    m = _WS.match(src, i)
+    if m:
+        return Token("ws", m.group()), m.end()
+    if src.startswith("//", i):
+        end = src.find("\n", i)
+        end = len(src) if end < 0 else end
+        return Token("comment", src[i:end]), end
+    if src.startswith("/*", i):
+        end = src.find("*/", i + 2)
+        if end < 0:
+            raise TokenizeError("unterminated comment at offset %d" % i)
+        return Token("comment", src[i:end + 2]), end + 2
+    if c in "'\"":
+        end = _scan_string(src, i)
+        return Token("string", src[i:end]), end
+    if c == "`":
+        end = _scan_template(src, i)
+        return Token("template", src[i:end]), end
+    if c == "/" and _regex_allowed(prev):
+        end = _scan_regex(src, i)
+        return Token("regex", src[i:end]), end
+    if c.isdigit() or (c == "." and i + 1 < len(src) and src[i + 1].isdigit()):
+        m = _NUMBER.match(src, i)
+        return Token("number", m.group()), m.end()
+    m = _NAME.match(src, i)
+    if m:
+        return Token("name", m.group()), m.end()
+    m = _PUNCT.match(src, i)
+    if m:
+        return Token("punct", m.group()), m.end()
+    raise TokenizeError("unexpected character %r at offset %d" % (c, i))
+
+
+def tokenize(src):
+    """把源码切分为记号列表"""
+    tokens = []
+    i = 0
+    prev = None
+    while i < len(src):
+        tok, i = _next_token(src, i, prev)
+        tokens.append(tok)
+        if tok.kind not in ("ws", "comment"):
+            prev = tok
+    return tokens
+
+
+def join(tokens):
+    return "".join(tok.text for tok in tokens)
+
+
+def significant_neighbors(tokens):
+    """为每个记号给出前后最近的有效记号下标（跳过空白与注释），不存在时为 -1"""
+    n = len(tokens)
+    prev_idx = [-1] * n
+    next_idx = [-1] * n
+    last = -1
+    for i in range(n):
+        prev_idx[i] = last
+        if tokens[i].kind not in ("ws", "comment"):
+            last = i
+    last = -1
+    for i in range(n - 1, -1, -1):
+        next_idx[i] = last
+        if tokens[i].kind not in ("ws", "comment"):
+            last = i
+    return prev_idx, next_idx
+
+
+_BLOCK_BEFORE = {")", "{", "}", ";", "=>", "else", "try", "finally", "do", ""}
+
+
+def brace_opens_block(prev):
+    """根据 { 之前的有效记号判断它是语句块（True）还是对象字面量 / 解构模式（False）"""
+    return prev in _BLOCK_BEFORE
@@ -0,0 +1,84 @@
+"""
+@file test_bundle.py
+@brief bundle.py 局部名缩短与延迟编译部分的单元测试
+@author Sab1e
+@date 2025-08-23
+
+用法:
+    python -m unittest discover -s appsys/tools -p "test_*.py"
+"""
+
+import unittest
+
+from bundle import RUNTIME_GLOBALS, bundle, lazify
+
+# 足够长的函数体，避免被 --lazy-min-size 排除
+PAD = "var s = 0; for (var i = 0; i < 10; i++) { s += i * 2; } print(s);"
+
+
+def lazy_names(src):
+    return lazify(src, min_size=0)[1]
+
+
+def renamed(src):
+    return bundle(src, keep=["outer"], shake=False)[0]
+
+
+class RenameTest(unittest.TestCase):
+    def test_sibling_local_does_not_rename_implicit_global(self):
+        out = renamed("function outer() {\n"
+                      "    function a() { var counter = 1; return counter; }\n"
+                      "    function b() { counter++; }\n"
+                      "    a(); b();\n}\n")
+        self.assertIn("counter++", out)
+        self.assertNotIn("var counter", out)
+
+    def test_nested_reference_to_outer_local_is_renamed(self):
+        out = renamed("function outer(total) { [1].forEach(function (item) { total += item; }); return total; }\n")
+        self.assertNotIn("total", out)
+        self.assertNotIn("item", out)
+
+    def test_method_names_are_kept(self):
+        out = renamed("function outer(render) {\n"
+                      "    var o = { render(value) { return value; } };\n"
+                      "    return o.render(render);\n}\n")
+        self.assertIn("render(", out.split("{", 2)[2])
+        self.assertIn("o.render(", out)
+
+    def test_native_functions_are_runtime_globals(self):
+        for name in ("anim_ease", "anim_timeline", "subject_int", "bind_text", "ui_load", "chart_append",
+                     "label_set_int", "golden_checkpoint", "mem_report", "setTimeout", "setInterval", "run_lvgl"):
+            self.assertIn(name, RUNTIME_GLOBALS)
+
+
+class LazifyTest(unittest.TestCase):
+    def test_plain_function_is_lazy(self):
+        src = "function draw(a) { %s return a; }\ndraw(1);\n" % PAD
+        self.assertEqual(lazy_names(src), ["draw"])
+
+    def test_self_property_keeps_function_eager(self):
+        src = ("function helper() { helper.calls++; %s }\n"
+               "helper.calls = 0;\nhelper();\n" % PAD)
+        self.assertEqual(lazy_names(src), [])
+
+    def test_self_reference_keeps_function_eager(self):
+        src = "function fact(n) { %s return n <= 1 ? 1 : n * fact(n - 1); }\nfact(5);\n" % PAD
+        self.assertEqual(lazy_names(src), [])
+
+    def test_constructor_keeps_function_eager(self):
+        src = ("function Point(x, y) { this.x = x; this.y = y; %s }\n"
+               "var p = new Point(1, 2);\nprint(p instanceof Point);\n" % PAD)
+        self.assertEqual(lazy_names(src), [])
+
+    def test_prototype_and_length_keep_function_eager(self):
+        src = ("function Shape() { %s }\nShape.prototype.area = function () { return 0; };\n"
+               "function cb(a, b) { %s }\nprint(cb.length);\n" % (PAD, PAD))
+        self.assertEqual(lazy_names(src), [])
+
+    def test_other_property_access_does_not_exclude(self):
+        src = "function draw() { %s }\nvar o = { draw: 1 };\nprint(o.draw);\ndraw();\n" % PAD
+        self.assertEqual(lazy_names(src), ["draw"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,61 @@
+"""
+@file test_inline_consts.py
+@brief inline_consts.py 的单元测试
+@author Sab1e
+@date 2025-08-23
+
+用法:
+    python -m unittest discover -s appsys/tools -p "test_*.py"
+"""
+
+import unittest
+
+from inline_consts import inline_constants
+
+CONSTANTS = {"LV_PART_MAIN": 0, "LV_ALIGN_CENTER": 9, "LV_STATE_PRESSED": 32, "LV_OPA_NEG": -1}
+
+
+def inline(src):
+    return inline_constants(src, CONSTANTS)[0]
+
+
+class InlineConstantsTest(unittest.TestCase):
+    def test_global_reference(self):
+        self.assertEqual(inline("lv_obj_align(o, LV_ALIGN_CENTER, 0, 0);"), "lv_obj_align(o, 9, 0, 0);")
+        self.assertEqual(inline("x = LV_OPA_NEG;"), "x = (-1);")
+
+    def test_property_and_object_key(self):
+        src = "a.LV_PART_MAIN; b = { LV_PART_MAIN: 1, LV_ALIGN_CENTER };"
+        self.assertEqual(inline(src), src)
+
+    def test_declared_and_assigned(self):
+        src = "let LV_PART_MAIN = 3; LV_ALIGN_CENTER = 4; f(LV_PART_MAIN, LV_ALIGN_CENTER);"
+        self.assertEqual(inline(src), src)
+
+    def test_function_parameter_shadows(self):
+        out = inline("function f(LV_PART_MAIN) { return LV_PART_MAIN; } g(LV_ALIGN_CENTER);")
+        self.assertEqual(out, "function f(LV_PART_MAIN) { return LV_PART_MAIN; } g(9);")
+
+    def test_arrow_parameter_shadows(self):
+        out = inline("const h = (a, LV_PART_MAIN) => LV_PART_MAIN; const k = LV_STATE_PRESSED => LV_STATE_PRESSED;")
+        self.assertEqual(out, "const h = (a, LV_PART_MAIN) => LV_PART_MAIN; const k = LV_STATE_PRESSED => LV_STATE_PRESSED;")
+
+    def test_catch_parameter_shadows(self):
+        out = inline("try { f(); } catch (LV_PART_MAIN) { print(LV_PART_MAIN); } g(LV_ALIGN_CENTER);")
+        self.assertEqual(out, "try { f(); } catch (LV_PART_MAIN) { print(LV_PART_MAIN); } g(9);")
+
+    def test_method_and_destructured_parameters(self):
+        out = inline("class A { m({ k: LV_PART_MAIN }) { return LV_PART_MAIN; } } g(LV_ALIGN_CENTER);")
+        self.assertEqual(out, "class A { m({ k: LV_PART_MAIN }) { return LV_PART_MAIN; } } g(9);")
+
+    def test_default_value_is_inlined(self):
+        out = inline("function f(a = LV_PART_MAIN) { return a; }")
+        self.assertEqual(out, "function f(a = 0) { return a; }")
+
+    def test_call_is_not_parameter_list(self):
+        out = inline("if (LV_PART_MAIN) { g(LV_ALIGN_CENTER); }")
+        self.assertEqual(out, "if (0) { g(9); }")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,193 @@
+"""
+@file test_ui_compile.py
+@brief ui_compile.py 的单元测试：按 appsys_ui.c 的格式解码编译结果，并检查错误输入
+@author Sab1e
+@date 2025-08-23
+
+用法:
+    python -m unittest discover -s appsys/tools -p "test_*.py"
+"""
+
+import json
+import os
+import unittest
+
+from ui_compile import (CLASSES, COORD_CONTENT, COORD_PCT, COORD_PX, MAGIC, PROP, VERSION, UiError,
+                        c_array, compile_ui)
+
+CONSTANTS = {
+    "LV_ALIGN_CENTER": 9, "LV_ALIGN_TOP_MID": 2, "LV_EVENT_CLICKED": 10, "LV_EVENT_VALUE_CHANGED": 35,
+    "LV_OBJ_FLAG_HIDDEN": 1, "LV_OBJ_FLAG_SCROLLABLE": 16, "LV_STATE_CHECKED": 1, "LV_PART_INDICATOR": 0x20000,
+    "LV_STYLE_RADIUS": 12, "LV_STYLE_BG_COLOR": 28, "LV_STYLE_BG_OPA": 29, "LV_STYLE_BORDER_WIDTH": 36,
+    "LV_STYLE_PAD_TOP": 16, "LV_STYLE_PAD_BOTTOM": 17, "LV_STYLE_PAD_LEFT": 18, "LV_STYLE_PAD_RIGHT": 19,
+}
+
+PROP_NAME = {v: k for k, v in PROP.items()}
+
+
+class Reader:
+    """与 appsys_buf.c 中 AppSysReader_t 的读取方式一致"""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def varint(self):
+        v, shift = 0, 0
+        while True:
+            byte = self.u8()
+            v |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return v
+
+    def svarint(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def str(self):
+        n = self.varint()
+        raw = self.data[self.pos:self.pos + n]
+        assert self.data[self.pos + n] == 0
+        self.pos += n + 1
+        return raw.decode("utf-8")
+
+    def coord(self):
+        return self.u8(), self.svarint()
+
+
+def decode_node(r):
+    kind = CLASSES[r.u8()]
+    props = []
+    for _ in range(r.varint()):
+        name = PROP_NAME[r.u8()]
+        if name in ("id", "text", "options", "src"):
+            value = r.str()
+        elif name in ("x", "y", "width", "height"):
+            value = r.coord()
+        elif name in ("align", "selected", "flag_add", "flag_remove", "state", "flex_flow", "flex_grow"):
+            value = r.varint()
+        elif name == "range":
+            value = (r.svarint(), r.svarint())
+        elif name == "value":
+            value = r.svarint()
+        elif name == "flex_align":
+            value = (r.varint(), r.varint(), r.varint())
+        elif name == "style_num":
+            value = (r.varint(), r.varint(), r.svarint())
+        elif name == "style_color":
+            value = (r.varint(), r.varint(), r.varint())
+        elif name == "event":
+            value = (r.varint(), r.str())
+        props.append((name, value))
+    children = [decode_node(r) for _ in range(r.varint())]
+    return {"type": kind, "props": props, "children": children}
+
+
+def decode(data):
+    assert data[:4] == MAGIC and data[4] == VERSION
+    r = Reader(data)
+    r.pos = 5
+    root = decode_node(r)
+    assert r.pos == len(data)
+    return root
+
+
+def roundtrip(doc):
+    data, nodes = compile_ui(doc, CONSTANTS)
+    return decode(data), nodes
+
+
+class UiCompileTest(unittest.TestCase):
+    def test_basic_node(self):
+        root, nodes = roundtrip({"type": "label", "id": "title", "text": "你好", "align": "LV_ALIGN_CENTER"})
+        self.assertEqual(nodes, 1)
+        self.assertEqual(root["type"], "label")
+        self.assertEqual(root["props"], [("id", "title"), ("align", 9), ("text", "你好")])
+        self.assertEqual(root["children"], [])
+
+    def test_coords(self):
+        root, _ = roundtrip({"x": -5, "y": 10, "width": "50%", "height": "content"})
+        self.assertEqual(root["props"], [("x", (COORD_PX, -5)), ("y", (COORD_PX, 10)),
+                                         ("width", (COORD_PCT, 50)), ("height", (COORD_CONTENT, 0))])
+
+    def test_button_text_becomes_label(self):
+        root, nodes = roundtrip({"type": "button", "text": "OK", "children": [{"type": "obj"}]})
+        self.assertEqual(nodes, 3)
+        self.assertEqual(root["props"], [])
+        label = root["children"][0]
+        self.assertEqual(label["type"], "label")
+        self.assertEqual(label["props"], [("align", 9), ("text", "OK")])
+        self.assertEqual(root["children"][1]["type"], "obj")
+
+    def test_style_shorthand_and_color(self):
+        root, _ = roundtrip({"style": {"pad_all": 4, "radius": 8, "bg_color": "#102030"}})
+        self.assertEqual(root["props"], [
+            ("style_num", (16, 0, 4)), ("style_num", (17, 0, 4)), ("style_num", (18, 0, 4)),
+            ("style_num", (19, 0, 4)), ("style_num", (12, 0, 8)), ("style_color", (28, 0, 0x102030)),
+        ])
+
+    def test_style_selector(self):
+        root, _ = roundtrip({"styles": [{"selector": ["LV_PART_INDICATOR", "LV_STATE_CHECKED"],
+                                         "props": {"bg_opa": 255}}]})
+        self.assertEqual(root["props"], [("style_num", (29, 0x20001, 255))])
+
+    def test_flags_state_and_events(self):
+        root, _ = roundtrip({"type": "slider", "range": [-10, 10], "value": -3,
+                             "flags": {"add": ["HIDDEN"], "remove": ["LV_OBJ_FLAG_SCROLLABLE"]},
+                             "state": ["CHECKED"], "on": {"clicked": "on_ok", "LV_EVENT_VALUE_CHANGED": "on_change"}})
+        self.assertEqual(root["props"], [
+            ("range", (-10, 10)), ("value", -3), ("flag_add", 1), ("flag_remove", 16), ("state", 1),
+            ("event", (10, "on_ok")), ("event", (35, "on_change")),
+        ])
+
+    def test_options_list(self):
+        root, _ = roundtrip({"type": "dropdown", "options": ["A", "B", "C"], "selected": 2})
+        self.assertEqual(root["props"], [("options", "A\nB\nC"), ("selected", 2)])
+
+    def test_sample_ui(self):
+        path = os.path.join(os.path.dirname(__file__), "..", "builtin", "about", "about.ui.json")
+        with open(path, "r", encoding="utf-8-sig") as f:
+            root, nodes = roundtrip(json.load(f))
+        self.assertEqual(nodes, 3)
+        self.assertEqual([dict(c["props"])["id"] for c in root["children"]], ["title", "info"])
+
+    def test_unsupported_style(self):
+        with self.assertRaisesRegex(UiError, "unsupported style property 'text_font'"):
+            compile_ui({"style": {"text_font": 1}}, CONSTANTS)
+
+    def test_unknown_type(self):
+        with self.assertRaisesRegex(UiError, "unknown widget type"):
+            compile_ui({"type": "canvas"}, CONSTANTS)
+
+    def test_unknown_constant(self):
+        with self.assertRaisesRegex(UiError, "unknown constant"):
+            compile_ui({"align": "LV_ALIGN_NOWHERE"}, CONSTANTS)
+        with self.assertRaisesRegex(UiError, "unknown constant"):
+            compile_ui({"align": "LV_ALIGN_CENTER"})
+
+    def test_nul_in_string(self):
+        with self.assertRaisesRegex(UiError, "NUL"):
+            compile_ui({"type": "label", "text": "a\0b"}, CONSTANTS)
+
+    def test_tree_too_deep(self):
+        doc = {}
+        for _ in range(40):
+            doc = {"children": [doc]}
+        with self.assertRaisesRegex(UiError, "too deep"):
+            compile_ui(doc, CONSTANTS)
+
+    def test_c_array(self):
+        out = c_array("screen_ui", bytes(range(18)))
+        self.assertIn("const uint8_t screen_ui[] = {\n    0x00, 0x01,", out)
+        self.assertIn("\n    0x10, 0x11,\n};\n", out)
+        self.assertIn("const size_t screen_ui_size = 18;", out)
+
+
+if __name__ == "__main__":
+    unittest.main()
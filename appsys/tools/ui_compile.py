@@ -0,0 +1,316 @@
+"""
+@file ui_compile.py
+@brief 把 JSON 界面描述编译为紧凑的二进制界面（.ui），由 appsys_ui.c 一次遍历实例化为控件树
+@author Sab1e
+@date 2025-08-19
+
+界面描述是一棵控件树，每个节点：
+    {
+      "type": "button",                     控件类型，见 CLASSES
+      "id": "ok",                           可选，ui_load 返回的对象中以该名字引用控件
+      "x": 0, "y": 10,                      坐标与尺寸：整数 [px]、"50%" 或 "content"
+      "width": "100%", "height": "content",
+      "align": "LV_ALIGN_TOP_MID",
+      "text": "OK",                         label / checkbox / textarea 的文本；button 上会生成子 label
+      "src": "A:/img/icon.bin",             image 的图片源
+      "range": [0, 100], "value": 30,       slider / bar / arc
+      "options": "A\nB", "selected": 1,     dropdown / roller
+      "flags": {"add": ["LV_OBJ_FLAG_HIDDEN"], "remove": ["LV_OBJ_FLAG_SCROLLABLE"]},
+      "state": ["LV_STATE_CHECKED"],
+      "flex": {"flow": "LV_FLEX_FLOW_COLUMN", "main": "LV_FLEX_ALIGN_CENTER",
+               "cross": "LV_FLEX_ALIGN_CENTER", "track": "LV_FLEX_ALIGN_CENTER", "grow": 1},
+      "style": {"bg_color": "#202020", "radius": 8, "pad_all": 4},    只支持 STYLE_NUM_PROPS / STYLE_COLOR_PROPS
+      "styles": [{"selector": ["LV_PART_INDICATOR", "LV_STATE_PRESSED"], "props": {...}}],
+      "on": {"clicked": "on_ok", "LV_EVENT_VALUE_CHANGED": "on_change"},
+      "children": [ ... ]
+    }
+
+符号名（LV_ALIGN_*、LV_STYLE_*、LV_EVENT_* 等）用 lvgl.json（LVGL scripts/gen_json 生成）在编译期
+解析为数字，必须与固件使用同一份 LVGL。事件回调只记录名字，运行时在 ui_load 传入的 handlers 对象中查找。
+
+二进制格式（整数为变长编码，字符串为 长度 + 内容 + '\\0'，与 appsys_buf.c 一致）：
+    "EUIB" | 版本 u8 | 节点
+    节点 = 类型 u8 | 属性数 varint | 属性... | 子节点数 varint | 子节点...
+    属性 = 属性号 u8 | 按属性号定义的内容（见 appsys_ui.c）
+
+用法:
+    python ui_compile.py screen.json -o screen.ui [--lvgl-json lvgl.json] [--c-array NAME]
+"""
+
+import argparse
+import json
+import re
+import sys
+
+import inline_consts
+
+MAGIC = b"EUIB"
+VERSION = 1
+
+# 与 appsys_ui.h 中的 AppSysUiClassId_t 顺序一致
+CLASSES = ["obj", "label", "button", "checkbox", "textarea", "slider", "bar", "arc",
+           "switch", "dropdown", "roller", "image"]
+
+# 与 appsys_ui.h 中的 AppSysUiProp_t 一致
+PROP = {
+    "id": 0, "x": 1, "y": 2, "width": 3, "height": 4, "align": 5, "text": 6, "options": 7,
+    "selected": 8, "range": 9, "value": 10, "flag_add": 11, "flag_remove": 12, "state": 13,
+    "flex_flow": 14, "flex_align": 15, "flex_grow": 16, "style_num": 17, "style_color": 18,
+    "event": 19, "src": 20,
+}
+
+COORD_PX, COORD_PCT, COORD_CONTENT = 0, 1, 2
+
+# 展开为多个样式属性的简写
+STYLE_SHORTHANDS = {
+    "pad_all": ("pad_top", "pad_bottom", "pad_left", "pad_right"),
+    "pad_hor": ("pad_left", "pad_right"),
+    "pad_ver": ("pad_top", "pad_bottom"),
+}
+
+# 允许的样式属性，与 appsys_ui.c 中的 ui_num_props / ui_color_props 一致；
+# 值为指针的属性（text_font、bg_image_src、transition、color_filter_dsc 等）无法写进界面数据
+STYLE_NUM_PROPS = frozenset((
+    "width", "min_width", "max_width", "height", "min_height", "max_height", "x", "y", "align",
+    "length", "translate_x", "translate_y", "transform_width", "transform_height", "transform_scale_x",
+    "transform_scale_y", "transform_rotation", "transform_pivot_x", "transform_pivot_y", "pad_top",
+    "pad_bottom", "pad_left", "pad_right", "pad_row", "pad_column", "radius", "clip_corner", "opa",
+    "opa_layered", "color_filter_opa", "blend_mode", "base_dir", "bg_opa", "bg_grad_dir",
+    "bg_main_stop", "bg_grad_stop", "bg_main_opa", "bg_grad_opa", "bg_image_opa",
+    "bg_image_recolor_opa", "bg_image_tiled", "border_opa", "border_width", "border_side",
+    "border_post", "outline_width", "outline_opa", "outline_pad", "shadow_width", "shadow_offset_x",
+    "shadow_offset_y", "shadow_spread", "shadow_opa", "image_opa", "image_recolor_opa", "line_width",
+    "line_dash_width", "line_dash_gap", "line_rounded", "line_opa", "arc_width", "arc_rounded",
+    "arc_opa", "text_opa", "text_letter_space", "text_line_space", "text_decor", "text_align",
+    "anim_duration",
+))
+STYLE_COLOR_PROPS = frozenset((
+    "bg_color", "bg_grad_color", "bg_image_recolor", "border_color", "outline_color", "shadow_color",
+    "image_recolor", "line_color", "arc_color", "text_color",
+))
+
+_COLOR = re.compile(r"^(?:#|0x)([0-9a-fA-F]{6})$")
+
+
+class UiError(Exception):
+    pass
+
+
+class Writer:
+    def __init__(self):
+        self.data = bytearray()
+
+    def u8(self, v):
+        self.data.append(v & 0xFF)
+
+    def varint(self, v):
+        v &= 0xFFFFFFFF
+        while True:
+            byte = v & 0x7F
+            v >>= 7
+            self.data.append(byte | 0x80 if v else byte)
+            if not v:
+                break
+
+    def svarint(self, v):
+        self.varint(((v << 1) ^ (v >> 31)) & 0xFFFFFFFF)
+
+    def str(self, s):
+        raw = s.encode("utf-8")
+        if b"\0" in raw:
+            raise UiError("string contains NUL: %r" % s)
+        self.varint(len(raw))
+        self.data += raw + b"\0"
+
+
+class Compiler:
+    def __init__(self, constants):
+        self.constants = constants or {}
+        self.nodes = 0
+
+    def const(self, value, prefix=""):
+        """整数、十六进制字符串或符号名；prefix 用于补全简写（如 "clicked" -> LV_EVENT_CLICKED）"""
+        if isinstance(value, bool):
+            return int(value)
+        if isinstance(value, int):
+            return value
+        if isinstance(value, str):
+            if re.match(r"^-?(0x[0-9a-fA-F]+|\d+)$", value):
+                return int(value, 0)
+            for name in (value, prefix + value.upper()):
+                if name in self.constants:
+                    return self.constants[name]
+            raise UiError("unknown constant %r (pass --lvgl-json)" % value)
+        if isinstance(value, list):
+            result = 0
+            for v in value:
+                result |= self.const(v, prefix)
+            return result
+        raise UiError("bad constant %r" % (value,))
+
+    def coord(self, w, value):
+        if isinstance(value, str) and value.endswith("%"):
+            w.u8(COORD_PCT)
+            w.svarint(int(value[:-1]))
+        elif value == "content":
+            w.u8(COORD_CONTENT)
+            w.svarint(0)
+        else:
+            w.u8(COORD_PX)
+            w.svarint(self.const(value))
+
+    def style_props(self, props, selector, out):
+        for name, value in props.items():
+            for prop in STYLE_SHORTHANDS.get(name, (name,)):
+                if prop not in STYLE_NUM_PROPS and prop not in STYLE_COLOR_PROPS:
+                    raise UiError("unsupported style property %r" % prop)
+                prop_id = self.const("LV_STYLE_" + prop.upper())
+                m = _COLOR.match(value) if isinstance(value, str) else None
+                if prop in STYLE_COLOR_PROPS:
+                    rgb = int(m.group(1), 16) if m else self.const(value)
+                    out.append((PROP["style_color"], (prop_id, selector, rgb)))
+                else:
+                    out.append((PROP["style_num"], (prop_id, selector, self.const(value))))
+
+    def node(self, w, node, depth=0):
+        if depth > 32:
+            raise UiError("tree too deep")
+        kind = node.get("type", "obj")
+        if kind not in CLASSES:
+            raise UiError("unknown widget type %r" % kind)
+        self.nodes += 1
+        children = list(node.get("children", []))
+
+        props = []
+        if "id" in node:
+            props.append((PROP["id"], node["id"]))
+        for key in ("x", "y", "width", "height"):
+            if key in node:
+                props.append((PROP[key], node[key]))
+        if "align" in node:
+            props.append((PROP["align"], self.const(node["align"], "LV_ALIGN_")))
+        if "text" in node:
+            if kind == "button":
+                # 按钮本身没有文本，生成居中的子 label
+                children.insert(0, {"type": "label", "text": node["text"], "align": "LV_ALIGN_CENTER"})
+            else:
+                props.append((PROP["text"], node["text"]))
+        if "src" in node:
+            props.append((PROP["src"], node["src"]))
+        if "range" in node:
+            lo, hi = node["range"]
+            props.append((PROP["range"], (self.const(lo), self.const(hi))))
+        if "value" in node:
+            props.append((PROP["value"], self.const(node["value"])))
+        if "options" in node:
+            options = node["options"]
+            props.append((PROP["options"], "\n".join(options) if isinstance(options, list) else options))
+        if "selected" in node:
+            props.append((PROP["selected"], self.const(node["selected"])))
+        flags = node.get("flags", {})
+        if flags.get("add"):
+            props.append((PROP["flag_add"], self.const(flags["add"], "LV_OBJ_FLAG_")))
+        if flags.get("remove"):
+            props.append((PROP["flag_remove"], self.const(flags["remove"], "LV_OBJ_FLAG_")))
+        if "state" in node:
+            props.append((PROP["state"], self.const(node["state"], "LV_STATE_")))
+        flex = node.get("flex")
+        if flex:
+            if "flow" in flex:
+                props.append((PROP["flex_flow"], self.const(flex["flow"], "LV_FLEX_FLOW_")))
+            if any(k in flex for k in ("main", "cross", "track")):
+                start = "LV_FLEX_ALIGN_START"
+                props.append((PROP["flex_align"], tuple(
+                    self.const(flex.get(k, start), "LV_FLEX_ALIGN_") for k in ("main", "cross", "track"))))
+            if "grow" in flex:
+                props.append((PROP["flex_grow"], self.const(flex["grow"])))
+        if "style" in node:
+            self.style_props(node["style"], 0, props)
+        for entry in node.get("styles", []):
+            self.style_props(entry.get("props", {}), self.const(entry.get("selector", 0)), props)
+        for event, handler in node.get("on", {}).items():
+            props.append((PROP["event"], (self.const(event, "LV_EVENT_"), handler)))
+
+        w.u8(CLASSES.index(kind))
+        w.varint(len(props))
+        for prop, value in props:
+            w.u8(prop)
+            if prop in (PROP["id"], PROP["text"], PROP["options"], PROP["src"]):
+                w.str(value)
+            elif prop in (PROP["x"], PROP["y"], PROP["width"], PROP["height"]):
+                self.coord(w, value)
+            elif prop in (PROP["align"], PROP["selected"], PROP["flag_add"], PROP["flag_remove"],
+                          PROP["state"], PROP["flex_flow"], PROP["flex_grow"]):
+                w.varint(value)
+            elif prop in (PROP["range"],):
+                w.svarint(value[0])
+                w.svarint(value[1])
+            elif prop == PROP["value"]:
+                w.svarint(value)
+            elif prop == PROP["flex_align"]:
+                for v in value:
+                    w.varint(v)
+            elif prop == PROP["style_num"]:
+                w.varint(value[0])
+                w.varint(value[1])
+                w.svarint(value[2])
+            elif prop == PROP["style_color"]:
+                w.varint(value[0])
+                w.varint(value[1])
+                w.varint(value[2])
+            elif prop == PROP["event"]:
+                w.varint(value[0])
+                w.str(value[1])
+        w.varint(len(children))
+        for child in children:
+            self.node(w, child, depth + 1)
+
+
+def compile_ui(doc, constants=None):
+    """返回 (二进制界面, 控件数量)"""
+    w = Writer()
+    w.data += MAGIC
+    w.u8(VERSION)
+    compiler = Compiler(constants)
+    compiler.node(w, doc)
+    return bytes(w.data), compiler.nodes
+
+
+def c_array(name, data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    return ("/* 由 appsys/tools/ui_compile.py 生成，请勿手动修改 */\n"
+            "#include <stdint.h>\n#include <stddef.h>\n\n"
+            "const uint8_t %s[] = {\n%s\n};\nconst size_t %s_size = %d;\n"
+            % (name, "\n".join(rows), name, len(data)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--lvgl-json", help="LVGL gen_json 生成的 lvgl.json，用于解析符号名")
+    parser.add_argument("--c-array", metavar="NAME", help="输出 C 源文件（uint8_t NAME[]）而不是二进制文件")
+    args = parser.parse_args()
+
+    with open(args.input, "r", encoding="utf-8-sig") as f:
+        doc = json.load(f)
+    constants = inline_consts.load_lvgl_constants(args.lvgl_json) if args.lvgl_json else None
+    try:
+        data, nodes = compile_ui(doc, constants)
+    except UiError as e:
+        raise SystemExit("ui_compile: %s: %s" % (args.input, e))
+
+    if args.c_array:
+        with open(args.output, "w", encoding="utf-8-sig", newline="\n") as f:
+            f.write(c_array(args.c_array, data))
+    else:
+        with open(args.output, "wb") as f:
+            f.write(data)
+    print("ui_compile: %s -> %s (%d widgets, %d B)" % (args.input, args.output, nodes, len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -125,11 +125,32 @@
  * RENDERING CONFIGURATION
  *========================*/
 
-/** Align stride of all layers and images to this bytes */
-#define LV_DRAW_BUF_STRIDE_ALIGN                1
+/** Aligned draw buffer mode: 0 (off), 16, 32 or 64.
+ * Sets both the stride and the start address alignment below so every row of every layer, display buffer
+ * and decoded image starts on a vector boundary (SSE / AVX2 / AVX-512 width) and the blend kernels can use
+ * aligned loads. Costs up to N - 1 padding bytes per row. Can be set from the build, e.g. `-DLV_DRAW_BUF_VECTOR_ALIGN=32`.
+ * Compare builds with `LvglWindowsSimulator.exe --bench blend`. */
+#ifndef LV_DRAW_BUF_VECTOR_ALIGN
+    #define LV_DRAW_BUF_VECTOR_ALIGN            0
+#endif
+
+#if LV_DRAW_BUF_VECTOR_ALIGN != 0 && LV_DRAW_BUF_VECTOR_ALIGN != 16 && LV_DRAW_BUF_VECTOR_ALIGN != 32 && LV_DRAW_BUF_VECTOR_ALIGN != 64
+    #error "LV_DRAW_BUF_VECTOR_ALIGN must be 0, 16, 32 or 64"
+#endif
 
-/** Align start address of draw_buf addresses to this bytes*/
-#define LV_DRAW_BUF_ALIGN                       4
+#if LV_DRAW_BUF_VECTOR_ALIGN
+    /** Align stride of all layers and images to this bytes */
+    #define LV_DRAW_BUF_STRIDE_ALIGN            LV_DRAW_BUF_VECTOR_ALIGN
+
+    /** Align start address of draw_buf addresses to this bytes*/
+    #define LV_DRAW_BUF_ALIGN                   LV_DRAW_BUF_VECTOR_ALIGN
+#else
+    /** Align stride of all layers and images to this bytes */
+    #define LV_DRAW_BUF_STRIDE_ALIGN            1
+
+    /** Align start address of draw_buf addresses to this bytes*/
+    #define LV_DRAW_BUF_ALIGN                   4
+#endif
 
 /** Using matrix for transformations.
  * Requirements: